@@ -0,0 +1,92 @@
+/* UTF-8 */
+/**
+ * @file bench.hpp
+ * @brief 基准测试共用的计时和输出函数
+ * @details 每个测试重复运行若干次，取最短的一次作为结果，
+ * 减少调度和频率变化带来的干扰
+ */
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+
+namespace user::bench {
+
+/**
+ * @brief 阻止编译器优化掉没有使用的计算结果
+ * @param value 计算结果
+ */
+template <typename Tp>
+inline void do_not_optimize(const Tp& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief 测量f的运行时间
+ * @param f 需要测量的可调用对象
+ * @param reps 重复次数
+ * @return 最短的一次运行时间(毫秒)
+ */
+template <typename F>
+double measure(F&& f, int reps = 5) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < reps; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(
+            best,
+            std::chrono::duration<double, std::milli>(stop - start).count()
+        );
+    }
+    return best;
+}
+
+/**
+ * @brief 测量f的运行时间，每次运行前先调用setup(不计时)
+ * @param setup 准备输入的可调用对象，如恢复未排序的数据
+ * @param f 需要测量的可调用对象
+ * @param reps 重复次数
+ * @return 最短的一次运行时间(毫秒)
+ */
+template <typename Setup, typename F>
+double measure(Setup&& setup, F&& f, int reps = 5) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < reps; ++i) {
+        setup();
+        best = std::min(best, measure(f, 1));
+    }
+    return best;
+}
+
+/**
+ * @brief 输出一行对比结果
+ * @param name 测试名称
+ * @param baseline 对照实现的时间(毫秒)
+ * @param candidate 本仓库实现的时间(毫秒)
+ */
+inline void report(const char* name, double baseline, double candidate) {
+    std::printf(
+        "%-36s %10.3f ms %10.3f ms %8.2fx\n", name, baseline, candidate,
+        baseline / candidate
+    );
+}
+
+/**
+ * @brief 输出表头
+ * @param baseline 对照实现的名称
+ */
+inline void header(const char* baseline) {
+    std::printf(
+        "%-36s %13s %13s %9s\n", "case", baseline, "user", "speedup"
+    );
+}
+
+}  // namespace user::bench
+
+#endif  // BENCH_HPP
@@ -0,0 +1,76 @@
+/* UTF-8 */
+/**
+ * @file parallel-sort-bench.cpp
+ * @brief parallel_sort和parallel_stable_sort与std::sort、std::stable_sort
+ * 的对比，以及随线程数的扩展情况
+ * @details 用法: parallel-sort-bench [元素个数]，默认16M个元素。
+ * 排序结果不正确时以非0值退出
+ */
+
+#include <algorithm/parallel-sort.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 24;
+    user::Vector<std::uint64_t> input(n);
+    std::mt19937_64 rng(42);
+    for (std::uint64_t& x : input) {
+        x = rng();
+    }
+    user::Vector<std::uint64_t> work;
+    auto reset = [&] { work = input; };
+    auto sorted = [&] { return std::is_sorted(work.begin(), work.end()); };
+    bool ok = true;
+
+    const double std_sort = user::bench::measure(reset, [&] {
+        std::sort(work.begin(), work.end());
+    }, 3);
+    const double std_stable = user::bench::measure(reset, [&] {
+        std::stable_sort(work.begin(), work.end());
+    }, 3);
+
+    std::printf(
+        "elements: %zu, hardware threads: %u\n", n,
+        std::thread::hardware_concurrency()
+    );
+    user::bench::header("std");
+    // 线程数取1, 2, 4, ...以及硬件线程数
+    const std::size_t max_threads =
+        std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+    for (const std::size_t threads : thread_counts) {
+        user::ThreadPool pool(threads);
+        const double user_sort = user::bench::measure(reset, [&] {
+            user::parallel_sort(work, std::less<>(), pool);
+        }, 3);
+        ok &= sorted();
+        const double user_stable = user::bench::measure(reset, [&] {
+            user::parallel_stable_sort(work, std::less<>(), pool);
+        }, 3);
+        ok &= sorted();
+        const std::string suffix = " (" + std::to_string(threads) + " threads)";
+        user::bench::report(("sort" + suffix).c_str(), std_sort, user_sort);
+        user::bench::report(
+            ("stable_sort" + suffix).c_str(), std_stable, user_stable
+        );
+    }
+    if (!ok) {
+        std::puts("result not sorted");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/* UTF-8 */
+/**
+ * @file simd-search-bench.cpp
+ * @brief simd-search.hpp中的算法与std算法的对比
+ * @details 用法: simd-search-bench [元素个数]，默认4M个元素。
+ * 结果不一致时以非0值退出
+ */
+
+#include <algorithm/simd-search.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "bench.hpp"
+
+/**
+ * @brief 对一种元素类型运行所有测试
+ * @tparam Tp 元素类型
+ * @param type 类型名称
+ * @param n 元素个数
+ * @return 结果与std算法一致时返回true
+ */
+template <typename Tp>
+bool run(const char* type, std::size_t n) {
+    user::Vector<Tp> vec(n);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> dist(0, 1 << 20);
+    for (Tp& x : vec) {
+        x = static_cast<Tp>(dist(rng));
+    }
+    // 查找不存在的值，两种实现都要扫描整个数组
+    const Tp absent = static_cast<Tp>(-1);
+    const Tp target = *(vec.begin() + n / 2);
+    bool ok = true;
+    auto name = [type](const char* algo) {
+        return std::string(algo) + "<" + type + ">";
+    };
+
+    const double std_find = user::bench::measure([&] {
+        user::bench::do_not_optimize(std::find(vec.begin(), vec.end(), absent));
+    });
+    const double user_find = user::bench::measure([&] {
+        user::bench::do_not_optimize(user::find(vec, absent));
+    });
+    ok &= user::find(vec, absent) == vec.end();
+    user::bench::report(name("find").c_str(), std_find, user_find);
+
+    const double std_count = user::bench::measure([&] {
+        user::bench::do_not_optimize(std::count(vec.begin(), vec.end(), target));
+    });
+    const double user_count = user::bench::measure([&] {
+        user::bench::do_not_optimize(user::count(vec, target));
+    });
+    ok &= user::count(vec, target) ==
+          static_cast<std::size_t>(std::count(vec.begin(), vec.end(), target));
+    user::bench::report(name("count").c_str(), std_count, user_count);
+
+    const double std_min = user::bench::measure([&] {
+        user::bench::do_not_optimize(*std::min_element(vec.begin(), vec.end()));
+    });
+    const double user_min = user::bench::measure([&] {
+        user::bench::do_not_optimize(user::min(vec));
+    });
+    ok &= user::min(vec) == *std::min_element(vec.begin(), vec.end());
+    user::bench::report(name("min").c_str(), std_min, user_min);
+
+    const double std_minmax = user::bench::measure([&] {
+        const auto [lo, hi] = std::minmax_element(vec.begin(), vec.end());
+        user::bench::do_not_optimize(*lo);
+        user::bench::do_not_optimize(*hi);
+    });
+    const double user_minmax = user::bench::measure([&] {
+        user::bench::do_not_optimize(user::minmax(vec));
+    });
+    const auto [lo, hi] = std::minmax_element(vec.begin(), vec.end());
+    ok &= user::minmax(vec) == std::pair<Tp, Tp>(*lo, *hi);
+    user::bench::report(name("minmax").c_str(), std_minmax, user_minmax);
+
+    const double std_argmin = user::bench::measure([&] {
+        user::bench::do_not_optimize(
+            std::min_element(vec.begin(), vec.end()) - vec.begin()
+        );
+    });
+    const double user_argmin = user::bench::measure([&] {
+        user::bench::do_not_optimize(user::argmin(vec));
+    });
+    ok &= user::argmin(vec) ==
+          static_cast<std::size_t>(
+              std::min_element(vec.begin(), vec.end()) - vec.begin()
+          );
+    user::bench::report(name("argmin").c_str(), std_argmin, user_argmin);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 22;
+    std::printf("elements: %zu\n", n);
+    user::bench::header("std");
+    bool ok = run<std::int32_t>("int32_t", n);
+    ok &= run<std::int64_t>("int64_t", n);
+    ok &= run<float>("float", n);
+    ok &= run<double>("double", n);
+    if (!ok) {
+        std::puts("result mismatch");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* UTF-8 */
+/**
+ * @file sorted-index-bench.cpp
+ * @brief SortedIndex两种布局与std::lower_bound的对比
+ * @details 数据大小从一级缓存(4KiB)以4倍递增到内存(默认64MiB)，每种大小
+ * 执行1M次随机查找。用法: sorted-index-bench [最大元素个数]。
+ * 查找结果与std::lower_bound不一致时以非0值退出
+ */
+
+#include <algorithm>
+#include <container/sorted-index.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "bench.hpp"
+
+int main(int argc, char* argv[]) {
+    const std::size_t max_n =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 24;
+    constexpr std::size_t query_count = std::size_t{1} << 20;
+    std::mt19937 rng(42);
+    bool ok = true;
+
+    std::printf(
+        "%-12s %12s %12s %12s %10s %10s\n", "bytes", "std (ns)",
+        "sorted (ns)", "eytz (ns)", "sorted x", "eytz x"
+    );
+    for (std::size_t n = 1024; n <= max_n; n *= 4) {
+        // 元素为0, 2, 4, ...，查找的键有一半不在数组中
+        user::Vector<std::uint32_t> data(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            *(data.begin() + i) = static_cast<std::uint32_t>(2 * i);
+        }
+        user::Vector<std::uint32_t> queries(query_count);
+        std::uniform_int_distribution<std::uint32_t> dist(
+            0, static_cast<std::uint32_t>(2 * n)
+        );
+        for (std::uint32_t& q : queries) {
+            q = dist(rng);
+        }
+        const user::SortedIndex<std::uint32_t> sorted(
+            data, user::SearchLayout::Sorted
+        );
+        const user::SortedIndex<std::uint32_t> eytzinger(
+            data, user::SearchLayout::Eytzinger
+        );
+
+        auto run = [&](auto&& search) {
+            return user::bench::measure([&] {
+                std::size_t sum = 0;
+                for (const std::uint32_t q : queries) {
+                    sum += search(q);
+                }
+                user::bench::do_not_optimize(sum);
+            }, 3) * 1e6 / query_count;
+        };
+        const double std_ns = run([&](std::uint32_t q) {
+            return static_cast<std::size_t>(
+                std::lower_bound(data.begin(), data.end(), q) - data.begin()
+            );
+        });
+        const double sorted_ns =
+            run([&](std::uint32_t q) { return sorted.lower_bound(q); });
+        const double eytzinger_ns =
+            run([&](std::uint32_t q) { return eytzinger.lower_bound(q); });
+
+        for (const std::uint32_t q : queries) {
+            const auto expected = static_cast<std::size_t>(
+                std::lower_bound(data.begin(), data.end(), q) - data.begin()
+            );
+            ok &= sorted.lower_bound(q) == expected &&
+                  eytzinger.lower_bound(q) == expected;
+        }
+        std::printf(
+            "%-12zu %12.2f %12.2f %12.2f %9.2fx %9.2fx\n",
+            n * sizeof(std::uint32_t), std_ns, sorted_ns, eytzinger_ns,
+            std_ns / sorted_ns, std_ns / eytzinger_ns
+        );
+    }
+    if (!ok) {
+        std::puts("result mismatch");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+/* UTF-8 */
+/**
+ * @file stream-store-bench.cpp
+ * @brief 大块填充和复制使用非临时写入与普通写入的对比
+ * @details 模拟与大块写入同时运行的程序: 先反复访问一个常驻缓存的
+ * 工作集(默认1MiB的随机指针链)，再对大Vector(默认512MiB)执行
+ * assign(n, value)或复制赋值，然后测量再次遍历工作集的时间以及
+ * 末级缓存未命中次数。非临时写入不会挤出工作集，遍历应当更快、
+ * 未命中更少。未命中次数通过perf_event_open读取，没有权限时显示为n/a。
+ * 用法: stream-store-bench [大Vector的MiB数] [工作集的KiB数]
+ */
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm/simd-stream.hpp>
+#include <container/vector.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "bench.hpp"
+
+/**
+ * @class CacheMissCounter
+ * @brief 末级缓存读未命中的计数器，不可用时valid()为false
+ */
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_LL |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(
+            ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0)
+        );
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    ~CacheMissCounter() {
+        if (valid()) {
+            ::close(fd);
+        }
+    }
+
+    [[nodiscard]] bool valid() const noexcept { return fd >= 0; }
+
+    void start() noexcept {
+        if (valid()) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    /**
+     * @brief 停止计数
+     * @return start()之后的未命中次数
+     */
+    std::uint64_t stop() noexcept {
+        std::uint64_t count = 0;
+        if (valid()) {
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+        return count;
+    }
+
+private:
+    int fd;  // perf事件的文件描述符
+};
+
+/**
+ * @struct Result
+ * @brief 一种写入方式的测量结果
+ */
+struct Result {
+    double write_ms = std::numeric_limits<double>::max();  // 大块写入的时间
+    double pass_ms = std::numeric_limits<double>::max();   // 遍历工作集的时间
+    std::uint64_t misses = std::numeric_limits<std::uint64_t>::max();
+};
+
+/**
+ * @brief 沿随机指针链遍历工作集一次
+ * @param chain 指针链，chain[i]为下一个位置
+ * @return 最后到达的位置
+ */
+std::size_t chase(const user::Vector<std::size_t>& chain) {
+    const std::size_t* next = chain.begin();
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        pos = next[pos];
+    }
+    return pos;
+}
+
+/**
+ * @brief 执行大块写入后测量遍历工作集的时间
+ * @param chain 工作集
+ * @param write 大块写入
+ * @param counter 未命中计数器
+ * @return 多次运行中最好的结果
+ */
+template <typename Write>
+Result run(
+    const user::Vector<std::size_t>& chain, Write&& write,
+    CacheMissCounter& counter
+) {
+    Result result;
+    for (int rep = 0; rep < 5; ++rep) {
+        // 让工作集常驻缓存
+        user::bench::do_not_optimize(chase(chain));
+        user::bench::do_not_optimize(chase(chain));
+        result.write_ms =
+            std::min(result.write_ms, user::bench::measure(write, 1));
+        counter.start();
+        result.pass_ms = std::min(result.pass_ms, user::bench::measure([&] {
+            user::bench::do_not_optimize(chase(chain));
+        }, 1));
+        result.misses = std::min(result.misses, counter.stop());
+    }
+    return result;
+}
+
+/**
+ * @brief 输出一行结果
+ */
+void print(const char* name, const Result& result, bool has_counter) {
+    if (has_counter) {
+        std::printf(
+            "%-24s %12.3f ms %12.3f ms %14llu\n", name, result.write_ms,
+            result.pass_ms, static_cast<unsigned long long>(result.misses)
+        );
+    } else {
+        std::printf(
+            "%-24s %12.3f ms %12.3f ms %14s\n", name, result.write_ms,
+            result.pass_ms, "n/a"
+        );
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t big_mib =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512;
+    const std::size_t hot_kib =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+    const std::size_t big_n = (big_mib << 20) / sizeof(std::uint64_t);
+
+    // 随机排列构成的单个环，每一步都是不可预测的访问
+    const std::size_t hot_n = (hot_kib << 10) / sizeof(std::size_t);
+    user::Vector<std::size_t> order(hot_n);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+    user::Vector<std::size_t> chain(hot_n);
+    for (std::size_t i = 0; i < hot_n; ++i) {
+        *(chain.begin() + *(order.begin() + i)) =
+            *(order.begin() + (i + 1) % hot_n);
+    }
+
+    user::Vector<std::uint64_t> dst(big_n, 1);
+    const user::Vector<std::uint64_t> src(big_n, 2);
+    CacheMissCounter counter;
+    auto fill = [&] { dst.assign(big_n, 3); };
+    auto copy = [&] { dst = src; };
+
+    std::printf(
+        "vector: %zu MiB, working set: %zu KiB, default threshold: %zu bytes\n",
+        big_mib, hot_kib, user::stream_threshold()
+    );
+    std::printf(
+        "%-24s %15s %15s %14s\n", "case", "write", "working set", "LLC misses"
+    );
+    // 阈值为0时总是使用非临时写入，为最大值时总是使用普通写入
+    const std::size_t threshold = user::stream_threshold();
+    user::set_stream_threshold(0);
+    const Result fill_stream = run(chain, fill, counter);
+    const Result copy_stream = run(chain, copy, counter);
+    user::set_stream_threshold(std::numeric_limits<std::size_t>::max());
+    const Result fill_regular = run(chain, fill, counter);
+    const Result copy_regular = run(chain, copy, counter);
+    user::set_stream_threshold(threshold);
+
+    print("assign, regular", fill_regular, counter.valid());
+    print("assign, streaming", fill_stream, counter.valid());
+    print("copy, regular", copy_regular, counter.valid());
+    print("copy, streaming", copy_stream, counter.valid());
+    return 0;
+}
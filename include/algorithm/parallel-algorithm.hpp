@@ -0,0 +1,207 @@
+/* UTF-8 */
+/**
+ * @file parallel-algorithm.hpp
+ * @brief user::Vector的并行for_each、transform与count_if
+ * @details 区间按缓存大小切成块，每块的元素个数使一块的输入和输出
+ * 能放进二级缓存的一半，每个任务处理一段连续的块，调度开销被分摊到
+ * 整块上。块的划分和块到任务的映射只由元素个数、元素大小和线程数决定
+ * (见parallel_for_static)，同样的输入在同样的线程池上得到相同的划分
+ */
+
+#ifndef PARALLEL_ALGORITHM_HPP
+#define PARALLEL_ALGORITHM_HPP
+#include <unistd.h>
+
+#include <algorithm/simd-search.hpp>
+#include <algorithm>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <functional>
+#include <parallel/parallel-for.hpp>
+#include <parallel/thread-pool.hpp>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+
+namespace user {
+
+namespace parallel {
+
+// 无法获取二级缓存大小时使用的块大小(字节)
+inline constexpr std::size_t default_block_bytes = std::size_t{1} << 17;
+
+/**
+ * @brief 获取每块处理的字节数，为二级缓存大小的一半
+ * @return 块的字节数
+ */
+inline std::size_t block_bytes() noexcept {
+    static const std::size_t bytes = [] {
+        const long l2 = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+        return l2 > 0 ? static_cast<std::size_t>(l2) / 2
+                      : default_block_bytes;
+    }();
+    return bytes;
+}
+
+/**
+ * @brief 计算每块的元素个数
+ * @param element_bytes 每个元素读写的字节数
+ * @return 每块的元素个数
+ */
+inline std::size_t block_elements(std::size_t element_bytes) noexcept {
+    return std::max<std::size_t>(block_bytes() / element_bytes, 1);
+}
+
+/**
+ * @brief 将[0, n)按块大小切分后静态分配给线程并行处理
+ * @param n 元素个数
+ * @param block 每块的元素个数
+ * @param f 以(first, last)为参数的可调用对象
+ * @param pool 执行任务的线程池
+ */
+template <typename F>
+void for_each_chunk(
+    std::size_t n, std::size_t block, const F& f, ThreadPool& pool
+) {
+    const std::size_t chunks = (n + block - 1) / block;
+    user::parallel_for_static(
+        chunks,
+        [n, block, &f](std::size_t c) {
+            f(c * block, std::min(n, (c + 1) * block));
+        },
+        pool
+    );
+}
+
+}  // namespace parallel
+
+/**
+ * @brief 对容器中的每个元素并行调用f
+ * @param vec 容器
+ * @param f 以元素引用为参数的可调用对象，不同元素上的调用可能并发
+ * @param pool 执行任务的线程池
+ * @throw f抛出的第一个异常
+ */
+template <typename Tp, IsAllocator Alloc, typename F>
+void parallel_for_each(
+    Vector<Tp, Alloc>& vec, F f, ThreadPool& pool = ThreadPool::instance()
+) {
+    Tp* const data = vec.begin();
+    parallel::for_each_chunk(
+        vec.size(), parallel::block_elements(sizeof(Tp)),
+        [data, &f](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                std::invoke(f, data[i]);
+            }
+        },
+        pool
+    );
+}
+
+/**
+ * @brief 对容器中的每个元素并行调用f(只读)
+ * @param vec 容器
+ * @param f 以元素常量引用为参数的可调用对象，不同元素上的调用可能并发
+ * @param pool 执行任务的线程池
+ * @throw f抛出的第一个异常
+ */
+template <typename Tp, IsAllocator Alloc, typename F>
+void parallel_for_each(
+    const Vector<Tp, Alloc>& vec, F f, ThreadPool& pool = ThreadPool::instance()
+) {
+    const Tp* const data = vec.begin();
+    parallel::for_each_chunk(
+        vec.size(), parallel::block_elements(sizeof(Tp)),
+        [data, &f](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                std::invoke(f, data[i]);
+            }
+        },
+        pool
+    );
+}
+
+/**
+ * @brief 并行地将src中每个元素经f变换后写入dst
+ * @details dst先调整为与src相同的大小，新增的元素只默认初始化
+ * (可平凡构造的类型不写入内存)，再由各线程写入结果，
+ * 因此新内存页由写入它的线程第一次访问
+ * @param src 输入容器
+ * @param dst 输出容器，原有的元素会被覆盖，可以与src是同一个容器
+ * @param f 以输入元素为参数、返回值可赋值给输出元素的可调用对象
+ * @param pool 执行任务的线程池
+ * @throw f抛出的第一个异常
+ */
+template <
+    typename Tp, IsAllocator Alloc1, typename Up, IsAllocator Alloc2,
+    typename F>
+    requires std::is_assignable_v<
+        Up&, std::invoke_result_t<F&, const Tp&>>
+void parallel_transform(
+    const Vector<Tp, Alloc1>& src, Vector<Up, Alloc2>& dst, F f,
+    ThreadPool& pool = ThreadPool::instance()
+) {
+    const std::size_t n = src.size();
+    dst.resize(n);
+    const Tp* const in = src.begin();
+    Up* const out = dst.begin();
+    parallel::for_each_chunk(
+        n, parallel::block_elements(sizeof(Tp) + sizeof(Up)),
+        [in, out, &f](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                out[i] = std::invoke(f, in[i]);
+            }
+        },
+        pool
+    );
+}
+
+/**
+ * @brief 并行统计满足谓词的元素个数
+ * @details 每块的计数写入各自的位置后按块的顺序求和
+ * @param vec 容器
+ * @param pred 一元谓词，为ValuePredicate时每块使用向量化实现
+ * @param pool 执行任务的线程池
+ * @return 满足谓词的元素个数
+ * @throw pred抛出的第一个异常
+ */
+template <typename Tp, IsAllocator Alloc, typename Pred>
+std::size_t parallel_count_if(
+    const Vector<Tp, Alloc>& vec, Pred pred,
+    ThreadPool& pool = ThreadPool::instance()
+) {
+    const std::size_t n = vec.size();
+    const std::size_t block = parallel::block_elements(sizeof(Tp));
+    const std::size_t chunks = (n + block - 1) / block;
+    Vector<std::size_t> counts(chunks, 0);
+    std::size_t* const count = counts.begin();
+    const Tp* const data = vec.begin();
+    parallel::for_each_chunk(
+        n, block,
+        [data, count, block, &pred](std::size_t first, std::size_t last) {
+            std::size_t& c = count[first / block];
+            if constexpr (IsSimdPredicate<Pred, Tp>) {
+                constexpr CmpOp op = ValuePredicateTraits<Pred>::op;
+                c = simd_dispatch([&](auto tag) {
+                    return count_cmp(
+                        tag, std::integral_constant<CmpOp, op>{},
+                        data + first, data + last, pred.value
+                    );
+                });
+            } else {
+                c = static_cast<std::size_t>(std::count_if(
+                    data + first, data + last, std::ref(pred)
+                ));
+            }
+        },
+        pool
+    );
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < chunks; ++i) {
+        total += count[i];
+    }
+    return total;
+}
+
+}  // namespace user
+
+#endif  // PARALLEL_ALGORITHM_HPP
@@ -0,0 +1,379 @@
+/* UTF-8 */
+/**
+ * @file parallel-sort.hpp
+ * @brief user::Vector的并行排序
+ * @details parallel_sort使用样本排序:抽样选出分割值，按分割值将元素并行
+ * 分配到各个桶中，再并行排序每个桶;parallel_stable_sort使用并行归并排序，
+ * 各段稳定排序后逐层归并，每次归并按分割点拆成多个独立的子归并。
+ * 两者的临时缓冲区都由Vector的分配器分配
+ */
+
+#ifndef PARALLEL_SORT_HPP
+#define PARALLEL_SORT_HPP
+
+#include <algorithm>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <parallel/parallel-for.hpp>
+#include <parallel/thread-pool.hpp>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+namespace parallel {
+
+// 元素个数小于此值时直接使用串行排序
+inline constexpr std::size_t sort_threshold = 1 << 15;
+// 样本排序的最大桶数(桶编号使用一个字节保存)
+inline constexpr std::size_t max_buckets = 256;
+// 每个桶的样本数
+inline constexpr std::size_t oversampling = 16;
+// 归并时子归并的最小长度
+inline constexpr std::size_t merge_grain = 1 << 14;
+
+/**
+ * @class SortBuffer
+ * @brief 排序使用的临时缓冲区，由容器的分配器分配
+ * @details 缓冲区中的元素由调用者构造，construct_all()之后析构时
+ * 会销毁全部元素
+ */
+template <typename Tp, typename Alloc>
+class SortBuffer {
+public:
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    /**
+     * @brief 分配能容纳n个元素的未初始化内存
+     * @param alloc 分配器
+     * @param n 元素个数
+     */
+    SortBuffer(const Alloc& alloc, std::size_t n)
+        : alloc(alloc), data(alloc_traits::allocate(this->alloc, n)), n(n) {}
+
+    SortBuffer(const SortBuffer&) = delete;
+    SortBuffer& operator=(const SortBuffer&) = delete;
+
+    ~SortBuffer() {
+        if (constructed) {
+            std::destroy_n(data, n);
+        }
+        alloc_traits::deallocate(alloc, data, n);
+    }
+
+    /**
+     * @brief 标记缓冲区中的元素已经全部构造
+     */
+    void construct_all() noexcept { constructed = true; }
+
+    /**
+     * @brief 获取缓冲区首地址
+     */
+    [[nodiscard]] Tp* get() const noexcept { return data; }
+
+private:
+    Alloc alloc;               // 分配器
+    Tp* data;                  // 缓冲区
+    std::size_t n;             // 元素个数
+    bool constructed = false;  // 元素是否已经构造
+};
+
+/**
+ * @brief 并行地将[src, src + n)中的元素移动构造到未初始化的dst中
+ */
+template <typename Tp>
+void uninitialized_move(Tp* src, std::size_t n, Tp* dst, ThreadPool& pool) {
+    user::parallel_for<std::size_t>(
+        0, n, merge_grain,
+        [&](std::size_t first, std::size_t last) {
+            std::uninitialized_move(src + first, src + last, dst + first);
+        },
+        pool
+    );
+}
+
+/**
+ * @brief 并行地将[src, src + n)中的元素移动赋值到dst中
+ */
+template <typename Tp>
+void move_assign(Tp* src, std::size_t n, Tp* dst, ThreadPool& pool) {
+    user::parallel_for<std::size_t>(
+        0, n, merge_grain,
+        [&](std::size_t first, std::size_t last) {
+            std::move(src + first, src + last, dst + first);
+        },
+        pool
+    );
+}
+
+/**
+ * @brief 稳定地归并两个有序区间，较长的区间会被拆分后并行归并
+ * @details 将较长区间的中间元素作为分割点，在另一区间中二分查找其位置，
+ * 分割点两侧的子归并互不影响。拆分左区间时在右区间使用lower_bound，
+ * 拆分右区间时在左区间使用upper_bound，保证相等元素中左区间的在前
+ * @param group 任务组
+ * @param l1 左区间起点
+ * @param l2 左区间终点
+ * @param r1 右区间起点
+ * @param r2 右区间终点
+ * @param out 输出位置(元素已构造，使用移动赋值)
+ * @param comp 比较函数
+ */
+template <typename Tp, typename Compare>
+void merge(
+    TaskGroup& group, Tp* l1, Tp* l2, Tp* r1, Tp* r2, Tp* out,
+    const Compare& comp
+) {
+    while (static_cast<std::size_t>((l2 - l1) + (r2 - r1)) > merge_grain) {
+        Tp* lm;
+        Tp* rm;
+        if (l2 - l1 >= r2 - r1) {
+            lm = l1 + (l2 - l1) / 2;
+            rm = std::lower_bound(r1, r2, *lm, comp);
+        } else {
+            rm = r1 + (r2 - r1) / 2;
+            lm = std::upper_bound(l1, l2, *rm, comp);
+        }
+        Tp* out_mid = out + (lm - l1) + (rm - r1);
+        group.run([&group, lm, l2, rm, r2, out_mid, &comp] {
+            parallel::merge(group, lm, l2, rm, r2, out_mid, comp);
+        });
+        l2 = lm;
+        r2 = rm;
+    }
+    std::merge(
+        std::make_move_iterator(l1), std::make_move_iterator(l2),
+        std::make_move_iterator(r1), std::make_move_iterator(r2), out, comp
+    );
+}
+
+/**
+ * @brief 样本排序
+ * @param data 元素
+ * @param n 元素个数
+ * @param buffer 能容纳n个元素的未初始化缓冲区
+ * @param comp 比较函数
+ * @param pool 线程池
+ */
+template <typename Tp, typename Alloc, typename Compare>
+void sample_sort(
+    Tp* data, std::size_t n, SortBuffer<Tp, Alloc>& buffer, Compare& comp,
+    ThreadPool& pool
+) {
+    const std::size_t buckets = std::min(max_buckets, pool.size() * 4);
+    // 1. 用固定种子的线性同余生成器抽样，排序后等间隔选出分割值
+    const std::size_t sample_count = buckets * oversampling;
+    Vector<const Tp*> samples(sample_count);
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (const Tp*& sample : samples) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        sample = data + (state >> 33) % n;
+    }
+    auto comp_ptr = [&comp](const Tp* a, const Tp* b) { return comp(*a, *b); };
+    std::sort(samples.begin(), samples.end(), comp_ptr);
+    Vector<const Tp*> splitters(buckets - 1);
+    for (std::size_t i = 1; i < buckets; ++i) {
+        splitters.begin()[i - 1] = samples.begin()[i * oversampling];
+    }
+
+    // 2. 将数据分为若干块，并行计算每个元素的桶编号并统计每块中各桶的元素数
+    const std::size_t blocks = buckets;
+    const std::size_t block_size = (n + blocks - 1) / blocks;
+    Vector<std::uint8_t> ids(n);
+    Vector<std::size_t> counts(blocks * buckets, 0);
+    std::uint8_t* id = ids.begin();
+    std::size_t* count = counts.begin();
+    const Tp* const* split_first = splitters.begin();
+    const Tp* const* split_last = splitters.end();
+    user::parallel_for<std::size_t>(
+        0, blocks, 1,
+        [&](std::size_t b, std::size_t b_end) {
+            for (; b != b_end; ++b) {
+                std::size_t* row = count + b * buckets;
+                const std::size_t last = std::min(n, (b + 1) * block_size);
+                for (std::size_t i = b * block_size; i < last; ++i) {
+                    // 第一个大于该元素的分割值的序号即为桶编号
+                    const auto bucket = static_cast<std::uint8_t>(
+                        std::upper_bound(
+                            split_first, split_last, data + i, comp_ptr
+                        ) -
+                        split_first
+                    );
+                    id[i] = bucket;
+                    ++row[bucket];
+                }
+            }
+        },
+        pool
+    );
+
+    // 3. 按桶优先的顺序求前缀和，得到每块每桶在缓冲区中的起始位置
+    Vector<std::size_t> bucket_begin(buckets + 1);
+    std::size_t offset = 0;
+    for (std::size_t k = 0; k < buckets; ++k) {
+        bucket_begin.begin()[k] = offset;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            const std::size_t c = count[b * buckets + k];
+            count[b * buckets + k] = offset;
+            offset += c;
+        }
+    }
+    bucket_begin.begin()[buckets] = n;
+
+    // 4. 并行地将元素移动到缓冲区中对应的位置
+    Tp* scratch = buffer.get();
+    user::parallel_for<std::size_t>(
+        0, blocks, 1,
+        [&](std::size_t b, std::size_t b_end) {
+            for (; b != b_end; ++b) {
+                std::size_t* row = count + b * buckets;
+                const std::size_t last = std::min(n, (b + 1) * block_size);
+                for (std::size_t i = b * block_size; i < last; ++i) {
+                    std::construct_at(
+                        scratch + row[id[i]]++, std::move(data[i])
+                    );
+                }
+            }
+        },
+        pool
+    );
+    buffer.construct_all();
+
+    // 5. 并行排序每个桶，再移回原来的存储
+    const std::size_t* begin = bucket_begin.begin();
+    user::parallel_for<std::size_t>(
+        0, buckets, 1,
+        [&](std::size_t k, std::size_t k_end) {
+            for (; k != k_end; ++k) {
+                std::sort(scratch + begin[k], scratch + begin[k + 1], comp);
+                std::move(
+                    scratch + begin[k], scratch + begin[k + 1], data + begin[k]
+                );
+            }
+        },
+        pool
+    );
+}
+
+/**
+ * @brief 并行归并排序
+ * @param data 元素
+ * @param n 元素个数
+ * @param buffer 能容纳n个元素的未初始化缓冲区
+ * @param comp 比较函数
+ * @param pool 线程池
+ */
+template <typename Tp, typename Alloc, typename Compare>
+void merge_sort(
+    Tp* data, std::size_t n, SortBuffer<Tp, Alloc>& buffer, Compare& comp,
+    ThreadPool& pool
+) {
+    // 1. 分段并行稳定排序，段数为2的幂
+    std::size_t runs = 1;
+    while (runs < pool.size() * 4 && n / (runs * 2) >= merge_grain) {
+        runs *= 2;
+    }
+    const std::size_t run_size = (n + runs - 1) / runs;
+    auto run_begin = [&](std::size_t i) { return std::min(n, i * run_size); };
+    user::parallel_for<std::size_t>(
+        0, runs, 1,
+        [&](std::size_t r, std::size_t r_end) {
+            for (; r != r_end; ++r) {
+                std::stable_sort(
+                    data + run_begin(r), data + run_begin(r + 1), comp
+                );
+            }
+        },
+        pool
+    );
+
+    // 2. 缓冲区中先构造元素，之后在两块存储之间交替归并
+    Tp* scratch = buffer.get();
+    parallel::uninitialized_move(data, n, scratch, pool);
+    buffer.construct_all();
+    Tp* src = data;
+    Tp* dst = scratch;
+    for (std::size_t width = 1; width < runs; width *= 2) {
+        TaskGroup group(pool);
+        for (std::size_t r = 0; r < runs; r += 2 * width) {
+            const std::size_t l1 = run_begin(r);
+            const std::size_t l2 = run_begin(r + width);
+            const std::size_t r2 = run_begin(r + 2 * width);
+            group.run([&group, src, dst, l1, l2, r2, &comp] {
+                parallel::merge(
+                    group, src + l1, src + l2, src + l2, src + r2, dst + l1,
+                    comp
+                );
+            });
+        }
+        group.wait();
+        std::swap(src, dst);
+    }
+    if (src != data) {
+        parallel::move_assign(src, n, data, pool);
+    }
+}
+
+}  // namespace parallel
+
+/**
+ * @brief 并行排序(不稳定)
+ * @details 使用样本排序，元素较少、线程池只有一个线程或元素的移动操作
+ * 可能抛出异常时使用std::sort
+ * @param vec 需要排序的容器
+ * @param comp 比较函数
+ * @param pool 执行任务的线程池
+ * @note 比较函数抛出异常时容器中的元素处于有效但未指定的状态
+ */
+template <typename Tp, IsAllocator Alloc, typename Compare = std::less<>>
+void parallel_sort(
+    Vector<Tp, Alloc>& vec, Compare comp = Compare(),
+    ThreadPool& pool = ThreadPool::instance()
+) {
+    const std::size_t n = vec.size();
+    if (n < parallel::sort_threshold || pool.size() <= 1 ||
+        !std::is_nothrow_move_constructible_v<Tp> ||
+        !std::is_nothrow_move_assignable_v<Tp>) {
+        std::sort(vec.begin(), vec.end(), comp);
+        return;
+    }
+    using buffer_alloc =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Tp>;
+    parallel::SortBuffer<Tp, buffer_alloc> buffer(vec.get_allocator(), n);
+    parallel::sample_sort(vec.begin(), n, buffer, comp, pool);
+}
+
+/**
+ * @brief 并行稳定排序
+ * @details 使用并行归并排序，元素较少、线程池只有一个线程或元素的移动
+ * 操作可能抛出异常时使用std::stable_sort
+ * @param vec 需要排序的容器
+ * @param comp 比较函数
+ * @param pool 执行任务的线程池
+ * @note 比较函数抛出异常时容器中的元素处于有效但未指定的状态
+ */
+template <typename Tp, IsAllocator Alloc, typename Compare = std::less<>>
+void parallel_stable_sort(
+    Vector<Tp, Alloc>& vec, Compare comp = Compare(),
+    ThreadPool& pool = ThreadPool::instance()
+) {
+    const std::size_t n = vec.size();
+    if (n < parallel::sort_threshold || pool.size() <= 1 ||
+        !std::is_nothrow_move_constructible_v<Tp> ||
+        !std::is_nothrow_move_assignable_v<Tp>) {
+        std::stable_sort(vec.begin(), vec.end(), comp);
+        return;
+    }
+    using buffer_alloc =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Tp>;
+    parallel::SortBuffer<Tp, buffer_alloc> buffer(vec.get_allocator(), n);
+    parallel::merge_sort(vec.begin(), n, buffer, comp, pool);
+}
+
+}  // namespace user
+
+#endif  // PARALLEL_SORT_HPP
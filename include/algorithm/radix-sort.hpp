@@ -0,0 +1,406 @@
+/* UTF-8 */
+/**
+ * @file radix-sort.hpp
+ * @brief user::Vector的基数排序
+ * @details 支持整数、float、double以及按整数或浮点数键排序的
+ * 可平凡复制的结构体(键值对)。键先被转换为无符号整数，使无符号整数的
+ * 大小关系与原来的大小关系一致，之后每次按8位分配。
+ * 不超过32位的键使用LSD(从低位到高位)，所有元素都相同的位直接跳过;
+ * 64位的键使用MSD(从高位到低位)，桶足够小时改用插入排序。
+ * 两种方式都是稳定的，临时缓冲区是另一个使用相同分配器的Vector，
+ * 排序结果位于缓冲区时直接交换两个Vector的存储
+ */
+
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <parallel/parallel-for.hpp>
+#include <parallel/thread-pool.hpp>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @brief 判断类型是否可以作为基数排序的键
+ */
+template <typename K>
+concept IsRadixKey =
+    (std::integral<K> && !std::same_as<K, bool>) || std::same_as<K, float> ||
+    std::same_as<K, double>;
+
+namespace radix {
+
+// 每次分配使用的位数
+inline constexpr std::size_t digit_bits = 8;
+// 每次分配的桶数
+inline constexpr std::size_t radix = std::size_t{1} << digit_bits;
+// 元素个数小于此值时使用插入排序
+inline constexpr std::size_t insertion_threshold = 64;
+// 元素个数不小于此值时并行计数和分配
+inline constexpr std::size_t parallel_threshold = 1 << 18;
+// MSD中桶的元素个数不小于此值时作为单独的任务排序
+inline constexpr std::size_t task_threshold = 1 << 14;
+
+/**
+ * @brief 将键转换为保持大小关系的无符号整数
+ * @details 有符号整数翻转符号位;浮点数为负时翻转所有位，否则只翻转符号位
+ * @param key 键
+ * @return 无符号整数
+ * @note -0.0排在+0.0之前，NaN按符号排在两端
+ */
+template <IsRadixKey K>
+constexpr auto encode(K key) noexcept {
+    if constexpr (std::is_floating_point_v<K>) {
+        using U = std::conditional_t<sizeof(K) == 4, std::uint32_t,
+                                     std::uint64_t>;
+        const U bits = std::bit_cast<U>(key);
+        constexpr U sign = U{1} << (sizeof(U) * 8 - 1);
+        return (bits & sign) != 0 ? static_cast<U>(~bits)
+                                  : static_cast<U>(bits | sign);
+    } else if constexpr (std::is_signed_v<K>) {
+        using U = std::make_unsigned_t<K>;
+        constexpr U sign = U{1} << (sizeof(U) * 8 - 1);
+        return static_cast<U>(static_cast<U>(key) ^ sign);
+    } else {
+        return key;
+    }
+}
+
+/**
+ * @class Sorter
+ * @brief 保存排序所需的键函数和线程池
+ * @tparam Tp 元素类型
+ * @tparam KeyFn 键函数类型
+ */
+template <typename Tp, typename KeyFn>
+class Sorter {
+public:
+    // 键的类型
+    using key_type = std::remove_cvref_t<std::invoke_result_t<KeyFn&, const Tp&>>;
+    // 转换后的无符号整数类型
+    using code_type = decltype(encode(std::declval<key_type>()));
+    // 键的字节数，即分配次数
+    static constexpr std::size_t digits = sizeof(code_type);
+
+    Sorter(KeyFn& key, ThreadPool& pool) : key(key), pool(pool) {}
+
+    /**
+     * @brief 获取元素的无符号键
+     */
+    code_type code(const Tp& x) const { return encode(std::invoke(key, x)); }
+
+    /**
+     * @brief 获取元素第d个字节的值(d = 0为最低字节)
+     */
+    std::size_t digit(const Tp& x, std::size_t d) const {
+        return static_cast<std::size_t>(code(x) >> (d * digit_bits)) &
+               (radix - 1);
+    }
+
+    /**
+     * @brief 是否对n个元素并行处理
+     */
+    bool parallel(std::size_t n) const {
+        return n >= parallel_threshold && pool.size() > 1;
+    }
+
+    /**
+     * @brief 按无符号键稳定地插入排序
+     */
+    void insertion_sort(Tp* first, Tp* last) const {
+        for (Tp* i = first + 1; i < last; ++i) {
+            const Tp x = *i;
+            const code_type c = code(x);
+            Tp* j = i;
+            for (; j != first && c < code(*(j - 1)); --j) {
+                *j = *(j - 1);
+            }
+            *j = x;
+        }
+    }
+
+    /**
+     * @brief 按第d个字节将src稳定地分配到dst
+     * @param count 每个桶的元素个数，分配后变为每个桶的结束位置
+     */
+    void scatter(
+        const Tp* src, Tp* dst, std::size_t n, std::size_t d,
+        std::size_t* count
+    ) const {
+        std::size_t offset = 0;
+        for (std::size_t k = 0; k < radix; ++k) {
+            const std::size_t c = count[k];
+            count[k] = offset;
+            offset += c;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            dst[count[digit(src[i], d)]++] = src[i];
+        }
+    }
+
+    /**
+     * @brief 并行地按第d个字节将src稳定地分配到dst
+     * @details 各块并行计数，按桶优先、块其次的顺序求前缀和，
+     * 每块得到互不重叠的输出位置后再并行分配
+     * @param total 每个桶的元素个数，分配后变为每个桶的结束位置
+     */
+    void parallel_scatter(
+        const Tp* src, Tp* dst, std::size_t n, std::size_t d,
+        std::size_t* total
+    ) const {
+        const std::size_t blocks = pool.size() * 4;
+        const std::size_t block_size = (n + blocks - 1) / blocks;
+        Vector<std::size_t> counts(blocks * radix, 0);
+        std::size_t* count = counts.begin();
+        user::parallel_for<std::size_t>(
+            0, blocks, 1,
+            [&](std::size_t b, std::size_t b_end) {
+                for (; b != b_end; ++b) {
+                    std::size_t* row = count + b * radix;
+                    const std::size_t last = std::min(n, (b + 1) * block_size);
+                    for (std::size_t i = b * block_size; i < last; ++i) {
+                        ++row[digit(src[i], d)];
+                    }
+                }
+            },
+            pool
+        );
+        std::size_t offset = 0;
+        for (std::size_t k = 0; k < radix; ++k) {
+            for (std::size_t b = 0; b < blocks; ++b) {
+                const std::size_t c = count[b * radix + k];
+                count[b * radix + k] = offset;
+                offset += c;
+            }
+            total[k] = offset;
+        }
+        user::parallel_for<std::size_t>(
+            0, blocks, 1,
+            [&](std::size_t b, std::size_t b_end) {
+                for (; b != b_end; ++b) {
+                    std::size_t* row = count + b * radix;
+                    const std::size_t last = std::min(n, (b + 1) * block_size);
+                    for (std::size_t i = b * block_size; i < last; ++i) {
+                        dst[row[digit(src[i], d)]++] = src[i];
+                    }
+                }
+            },
+            pool
+        );
+    }
+
+    /**
+     * @brief 计算所有字节的直方图
+     * @param hist digits * radix个计数
+     */
+    void histogram(const Tp* data, std::size_t n, std::size_t* hist) const {
+        if (!parallel(n)) {
+            for (std::size_t i = 0; i < n; ++i) {
+                code_type c = code(data[i]);
+                for (std::size_t d = 0; d < digits; ++d) {
+                    ++hist[d * radix + (c & (radix - 1))];
+                    c >>= digit_bits;
+                }
+            }
+            return;
+        }
+        // 每块使用独立的直方图，最后合并
+        const std::size_t blocks = pool.size() * 4;
+        const std::size_t block_size = (n + blocks - 1) / blocks;
+        Vector<std::size_t> partial(blocks * digits * radix, 0);
+        std::size_t* part = partial.begin();
+        user::parallel_for<std::size_t>(
+            0, blocks, 1,
+            [&](std::size_t b, std::size_t b_end) {
+                for (; b != b_end; ++b) {
+                    std::size_t* h = part + b * digits * radix;
+                    const std::size_t last = std::min(n, (b + 1) * block_size);
+                    for (std::size_t i = b * block_size; i < last; ++i) {
+                        code_type c = code(data[i]);
+                        for (std::size_t d = 0; d < digits; ++d) {
+                            ++h[d * radix + (c & (radix - 1))];
+                            c >>= digit_bits;
+                        }
+                    }
+                }
+            },
+            pool
+        );
+        for (std::size_t b = 0; b < blocks; ++b) {
+            for (std::size_t i = 0; i < digits * radix; ++i) {
+                hist[i] += part[b * digits * radix + i];
+            }
+        }
+    }
+
+    /**
+     * @brief LSD基数排序
+     * @return 排序结果位于buffer时返回true
+     */
+    bool lsd_sort(Tp* data, Tp* buffer, std::size_t n) const {
+        std::size_t hist[digits * radix]{};
+        histogram(data, n, hist);
+        Tp* src = data;
+        Tp* dst = buffer;
+        for (std::size_t d = 0; d < digits; ++d) {
+            std::size_t* count = hist + d * radix;
+            // 所有元素的这一字节都相同时跳过
+            if (std::find(count, count + radix, n) != count + radix) {
+                continue;
+            }
+            if (parallel(n)) {
+                parallel_scatter(src, dst, n, d, count);
+            } else {
+                scatter(src, dst, n, d, count);
+            }
+            std::swap(src, dst);
+        }
+        return src != data;
+    }
+
+    /**
+     * @brief MSD基数排序
+     * @param src 需要排序的元素
+     * @param dst 同样大小的缓冲区
+     * @param n 元素个数
+     * @param d 当前处理的字节
+     * @param to_dst 为true时结果放在dst中，否则放在src中
+     * @param group 并行排序各个桶的任务组
+     */
+    void msd_sort(
+        Tp* src, Tp* dst, std::size_t n, std::size_t d, bool to_dst,
+        TaskGroup& group
+    ) const {
+        if (n <= insertion_threshold) {
+            insertion_sort(src, src + n);
+            if (to_dst) {
+                std::memcpy(
+                    static_cast<void*>(dst), static_cast<const void*>(src),
+                    n * sizeof(Tp)
+                );
+            }
+            return;
+        }
+        std::size_t count[radix]{};
+        if (parallel(n)) {
+            parallel_scatter(src, dst, n, d, count);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                ++count[digit(src[i], d)];
+            }
+            // 所有元素的这一字节都相同时不需要移动
+            if (std::find(count, count + radix, n) != count + radix) {
+                if (d == 0) {
+                    msd_finish(src, dst, n, to_dst);
+                } else {
+                    msd_sort(src, dst, n, d - 1, to_dst, group);
+                }
+                return;
+            }
+            scatter(src, dst, n, d, count);
+        }
+        // 现在元素位于dst中，各桶递归排序后结果应位于原来的目标位置
+        std::size_t begin = 0;
+        for (std::size_t k = 0; k < radix; ++k) {
+            const std::size_t end = count[k];
+            const std::size_t size = end - begin;
+            Tp* bucket_src = dst + begin;
+            Tp* bucket_dst = src + begin;
+            if (d == 0 || size <= 1) {
+                // 桶内的键完全相同
+                msd_finish(bucket_src, bucket_dst, size, !to_dst);
+            } else if (size >= task_threshold) {
+                group.run([this, bucket_src, bucket_dst, size, d, to_dst,
+                           &group] {
+                    msd_sort(
+                        bucket_src, bucket_dst, size, d - 1, !to_dst, group
+                    );
+                });
+            } else {
+                msd_sort(bucket_src, bucket_dst, size, d - 1, !to_dst, group);
+            }
+            begin = end;
+        }
+    }
+
+private:
+    /**
+     * @brief 键已经完全相同的元素放到目标位置
+     */
+    static void msd_finish(Tp* src, Tp* dst, std::size_t n, bool to_dst) {
+        if (to_dst && n != 0) {
+            std::memcpy(
+                static_cast<void*>(dst), static_cast<const void*>(src),
+                n * sizeof(Tp)
+            );
+        }
+    }
+
+    KeyFn& key;        // 键函数
+    ThreadPool& pool;  // 线程池
+};
+
+}  // namespace radix
+
+/**
+ * @brief 按键对容器进行稳定的基数排序
+ * @param vec 需要排序的容器，元素必须可以平凡复制
+ * @param key 键函数或成员指针，返回整数、float或double
+ * @param pool 并行计数和分配使用的线程池
+ */
+template <typename Tp, IsAllocator Alloc, typename KeyFn>
+    requires std::is_trivially_copyable_v<Tp> &&
+             std::default_initializable<Tp> &&
+             IsRadixKey<std::remove_cvref_t<
+                 std::invoke_result_t<KeyFn&, const Tp&>>>
+void radix_sort(
+    Vector<Tp, Alloc>& vec, KeyFn key, ThreadPool& pool = ThreadPool::instance()
+) {
+    using sorter_type = radix::Sorter<Tp, KeyFn>;
+    const std::size_t n = vec.size();
+    const sorter_type sorter(key, pool);
+    if (n <= radix::insertion_threshold) {
+        sorter.insertion_sort(vec.begin(), vec.end());
+        return;
+    }
+    // 缓冲区与容器使用相同的分配器，结果位于缓冲区时直接交换存储
+    Vector<Tp, Alloc> buffer(n, vec.get_allocator());
+    if constexpr (sorter_type::digits <= 4) {
+        if (sorter.lsd_sort(vec.begin(), buffer.begin(), n)) {
+            vec.swap(buffer);
+        }
+    } else {
+        TaskGroup group(pool);
+        sorter.msd_sort(
+            vec.begin(), buffer.begin(), n, sorter_type::digits - 1, false,
+            group
+        );
+        group.wait();
+    }
+}
+
+/**
+ * @brief 对整数或浮点数容器进行基数排序
+ * @param vec 需要排序的容器
+ * @param pool 并行计数和分配使用的线程池
+ */
+template <IsRadixKey Tp, IsAllocator Alloc>
+void radix_sort(
+    Vector<Tp, Alloc>& vec, ThreadPool& pool = ThreadPool::instance()
+) {
+    user::radix_sort(vec, std::identity{}, pool);
+}
+
+}  // namespace user
+
+#endif  // RADIX_SORT_HPP
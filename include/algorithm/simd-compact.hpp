@@ -0,0 +1,103 @@
+/* UTF-8 */
+/**
+ * @file simd-compact.hpp
+ * @brief user::Vector的向量化批量删除
+ * @details 谓词为ValuePredicate且元素类型为int32_t、int64_t、float、double时，
+ * erase_if使用向量比较得到掩码，再压缩写入(AVX-512的compress指令，
+ * AVX2/SSE4.2使用查表得到的排列)，单次遍历完成稳定的删除;
+ * 其他情况使用Vector::erase_if
+ */
+
+#ifndef SIMD_COMPACT_HPP
+#define SIMD_COMPACT_HPP
+#include <algorithm/simd-search.hpp>
+#include <algorithm/simd.hpp>
+#include <bit>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+
+namespace user {
+
+namespace simd {
+
+/**
+ * @brief 删除所有满足 (*it Op value) 的元素(标量实现)
+ */
+template <CmpOp Op, typename Tp>
+Tp* remove_cmp(
+    ScalarTag, std::integral_constant<CmpOp, Op>, Tp* first, Tp* last,
+    Tp value
+) {
+    Tp* out = first;
+    for (; first != last; ++first) {
+        if (!compare<Op>(*first, value)) {
+            *out++ = *first;
+        }
+    }
+    return out;
+}
+
+#if defined(USER_SIMD_X86)
+// 在每个指令集的命名空间中生成一份核心循环
+USER_SIMD_BEGIN_SSE42
+namespace sse42 {
+#include <algorithm/simd-compact.inc>
+}  // namespace sse42
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX2
+namespace avx2 {
+#include <algorithm/simd-compact.inc>
+}  // namespace avx2
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX512
+namespace avx512 {
+#include <algorithm/simd-compact.inc>
+}  // namespace avx512
+USER_SIMD_END
+#endif
+
+}  // namespace simd
+
+/**
+ * @brief 删除所有满足谓词的元素，保持其余元素的顺序
+ * @param vec 容器
+ * @param pred 一元谓词，为ValuePredicate时使用向量化实现
+ * @return 删除的元素个数
+ */
+template <typename Tp, IsAllocator Alloc, typename Pred>
+std::size_t erase_if(Vector<Tp, Alloc>& vec, Pred pred) {
+    if constexpr (IsSimdPredicate<Pred, Tp>) {
+        constexpr CmpOp op = ValuePredicateTraits<Pred>::op;
+        Tp* const new_end = simd_dispatch([&](auto tag) {
+            return remove_cmp(
+                tag, std::integral_constant<CmpOp, op>{}, vec.begin(),
+                vec.end(), pred.value
+            );
+        });
+        const std::size_t removed = vec.end() - new_end;
+        vec.resize(vec.size() - removed);
+        return removed;
+    } else {
+        return vec.erase_if(pred);
+    }
+}
+
+/**
+ * @brief 删除所有等于value的元素，保持其余元素的顺序
+ * @param vec 容器
+ * @param value 需要删除的值
+ * @return 删除的元素个数
+ */
+template <typename Tp, IsAllocator Alloc>
+std::size_t erase(Vector<Tp, Alloc>& vec, const Tp& value) {
+    return user::erase_if(vec, is_equal(value));
+}
+
+}  // namespace user
+
+#endif  // SIMD_COMPACT_HPP
@@ -0,0 +1,486 @@
+/* UTF-8 */
+/**
+ * @file simd-reduce.hpp
+ * @brief user::Vector的向量化归约与前缀和算法
+ * @details 对元素类型为int32_t、int64_t、float、double的Vector，
+ * 求和、内积、平方和以及前缀和使用SSE4.2/AVX2/AVX-512实现，并在运行时
+ * 选择指令集;其他元素类型使用<numeric>中的标准库算法。
+ * 数据按块处理，每块在寄存器中用多组累加向量求和，
+ * 浮点数的块间结果再使用Kahan补偿求和，误差不随元素个数线性增长。
+ * 元素很多时按固定大小分段交给线程池并行计算，分段方式与线程数无关，
+ * 所以结果是确定的
+ */
+
+#ifndef SIMD_REDUCE_HPP
+#define SIMD_REDUCE_HPP
+#include <algorithm/simd.hpp>
+#include <algorithm>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <parallel/parallel-for.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+namespace simd {
+
+// 归约时每块的元素个数
+inline constexpr std::size_t reduce_block_size = 4096;
+// 并行计算时每段的元素个数
+inline constexpr std::size_t parallel_chunk_size = 1 << 16;
+// 元素个数不小于此值时并行计算
+inline constexpr std::size_t parallel_threshold = 1 << 20;
+
+/**
+ * @brief 按补码回绕的加法
+ * @details 整数先转换为无符号类型再相加，结果转换回Tp，避免有符号整数
+ * 溢出的未定义行为;浮点数直接相加
+ */
+template <typename Tp>
+constexpr Tp wrap_add(Tp a, Tp b) noexcept {
+    if constexpr (std::is_integral_v<Tp>) {
+        using U = std::make_unsigned_t<decltype(a + b)>;
+        return static_cast<Tp>(static_cast<U>(a) + static_cast<U>(b));
+    } else {
+        return a + b;
+    }
+}
+
+/**
+ * @brief 按补码回绕的乘法，整数的处理方式与wrap_add相同
+ */
+template <typename Tp>
+constexpr Tp wrap_mul(Tp a, Tp b) noexcept {
+    if constexpr (std::is_integral_v<Tp>) {
+        using U = std::make_unsigned_t<decltype(a * b)>;
+        return static_cast<Tp>(static_cast<U>(a) * static_cast<U>(b));
+    } else {
+        return a * b;
+    }
+}
+
+/**
+ * @brief 计算一块元素的和(标量实现)
+ */
+template <typename Tp>
+Tp sum_block(ScalarTag, const Tp* first, const Tp* last) {
+    Tp acc[4]{};
+    for (; last - first >= 4; first += 4) {
+        acc[0] = wrap_add(acc[0], first[0]);
+        acc[1] = wrap_add(acc[1], first[1]);
+        acc[2] = wrap_add(acc[2], first[2]);
+        acc[3] = wrap_add(acc[3], first[3]);
+    }
+    Tp res = wrap_add(wrap_add(acc[0], acc[1]), wrap_add(acc[2], acc[3]));
+    for (; first != last; ++first) {
+        res = wrap_add(res, *first);
+    }
+    return res;
+}
+
+/**
+ * @brief 计算一块元素的内积(标量实现)
+ */
+template <typename Tp>
+Tp dot_block(ScalarTag, const Tp* a, const Tp* b, std::size_t n) {
+    Tp acc[4]{};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc[0] = wrap_add(acc[0], wrap_mul(a[i], b[i]));
+        acc[1] = wrap_add(acc[1], wrap_mul(a[i + 1], b[i + 1]));
+        acc[2] = wrap_add(acc[2], wrap_mul(a[i + 2], b[i + 2]));
+        acc[3] = wrap_add(acc[3], wrap_mul(a[i + 3], b[i + 3]));
+    }
+    Tp res = wrap_add(wrap_add(acc[0], acc[1]), wrap_add(acc[2], acc[3]));
+    for (; i < n; ++i) {
+        res = wrap_add(res, wrap_mul(a[i], b[i]));
+    }
+    return res;
+}
+
+/**
+ * @brief 计算一块元素的包含式前缀和(标量实现)
+ */
+template <typename Tp>
+Tp inclusive_scan_block(
+    ScalarTag, const Tp* first, const Tp* last, Tp* out, Tp carry
+) {
+    for (; first != last; ++first, ++out) {
+        carry = wrap_add(carry, *first);
+        *out = carry;
+    }
+    return carry;
+}
+
+/**
+ * @brief 计算一块元素的排除式前缀和(标量实现)
+ */
+template <typename Tp>
+Tp exclusive_scan_block(
+    ScalarTag, const Tp* first, const Tp* last, Tp* out, Tp carry
+) {
+    for (; first != last; ++first, ++out) {
+        const Tp x = *first;
+        *out = carry;
+        carry = wrap_add(carry, x);
+    }
+    return carry;
+}
+
+#if defined(USER_SIMD_X86)
+USER_SIMD_BEGIN_SSE42
+namespace sse42 {
+#include <algorithm/simd-reduce.inc>
+}  // namespace sse42
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX2
+namespace avx2 {
+#include <algorithm/simd-reduce.inc>
+}  // namespace avx2
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX512
+namespace avx512 {
+#include <algorithm/simd-reduce.inc>
+}  // namespace avx512
+USER_SIMD_END
+#endif
+
+/**
+ * @class BlockSum
+ * @brief 累加每块的部分和，浮点数使用Kahan补偿求和
+ */
+template <typename Tp>
+class BlockSum {
+public:
+    /**
+     * @brief 加上一块的部分和
+     * @param x 部分和
+     */
+    void add(Tp x) noexcept {
+        if constexpr (std::is_floating_point_v<Tp>) {
+            const Tp y = x - compensation;
+            const Tp t = sum + y;
+            compensation = (t - sum) - y;
+            sum = t;
+        } else {
+            sum = wrap_add(sum, x);
+        }
+    }
+
+    /**
+     * @brief 获取总和
+     * @return 所有部分和的和
+     */
+    [[nodiscard]] Tp get() const noexcept { return sum; }
+
+private:
+    Tp sum{};           // 当前的和
+    Tp compensation{};  // 丢失的低位部分
+};
+
+/**
+ * @brief 判断是否值得并行处理
+ * @param n 元素个数
+ * @return 元素足够多并且线程池有多个线程时返回true
+ */
+inline bool use_parallel(std::size_t n) {
+    return n >= parallel_threshold && ThreadPool::instance().size() > 1;
+}
+
+/**
+ * @brief 按块计算一段元素的和
+ * @param first 指向第一个元素的指针
+ * @param last 指向最后一个元素后一位置的指针
+ * @return 元素的和
+ */
+template <typename Tag, typename Tp>
+Tp sum_chunk(Tag tag, const Tp* first, const Tp* last) {
+    BlockSum<Tp> res;
+    while (first != last) {
+        const std::size_t n =
+            std::min<std::size_t>(last - first, reduce_block_size);
+        res.add(sum_block(tag, first, first + n));
+        first += n;
+    }
+    return res.get();
+}
+
+/**
+ * @brief 按块计算一段元素的内积
+ * @param a 指向第一组元素的指针
+ * @param b 指向第二组元素的指针
+ * @param n 元素个数
+ * @return 内积
+ */
+template <typename Tag, typename Tp>
+Tp dot_chunk(Tag tag, const Tp* a, const Tp* b, std::size_t n) {
+    BlockSum<Tp> res;
+    for (std::size_t i = 0; i < n; i += reduce_block_size) {
+        const std::size_t len = std::min(n - i, reduce_block_size);
+        res.add(dot_block(tag, a + i, b + i, len));
+    }
+    return res.get();
+}
+
+/**
+ * @brief 将n个元素分段计算后按顺序累加各段的结果
+ * @param n 元素个数
+ * @param chunk_value 以(段起点, 段长度)为参数，返回该段结果的可调用对象
+ * @return 各段结果的和
+ */
+template <typename Tp, typename F>
+Tp reduce_chunks(std::size_t n, const F& chunk_value) {
+    const std::size_t chunks =
+        (n + parallel_chunk_size - 1) / parallel_chunk_size;
+    auto value = [&](std::size_t i) {
+        const std::size_t begin = i * parallel_chunk_size;
+        return chunk_value(begin, std::min(n - begin, parallel_chunk_size));
+    };
+    BlockSum<Tp> res;
+    if (use_parallel(n)) {
+        Vector<Tp> partial(chunks);
+        Tp* out = partial.begin();
+        parallel_for<std::size_t>(
+            0, chunks, 1,
+            [&](std::size_t first, std::size_t last) {
+                for (; first != last; ++first) {
+                    out[first] = value(first);
+                }
+            }
+        );
+        for (std::size_t i = 0; i < chunks; ++i) {
+            res.add(out[i]);
+        }
+    } else {
+        for (std::size_t i = 0; i < chunks; ++i) {
+            res.add(value(i));
+        }
+    }
+    return res.get();
+}
+
+/**
+ * @brief 计算范围内元素的和
+ * @param first 指向第一个元素的指针
+ * @param last 指向最后一个元素后一位置的指针
+ * @return 元素的和
+ */
+template <typename Tp>
+Tp sum_range(const Tp* first, const Tp* last) {
+    return simd_dispatch([&](auto tag) {
+        return reduce_chunks<Tp>(
+            last - first,
+            [&](std::size_t begin, std::size_t n) {
+                return sum_chunk(tag, first + begin, first + begin + n);
+            }
+        );
+    });
+}
+
+/**
+ * @brief 计算两组元素的内积
+ * @param a 指向第一组元素的指针
+ * @param b 指向第二组元素的指针
+ * @param n 元素个数
+ * @return 内积
+ */
+template <typename Tp>
+Tp dot_range(const Tp* a, const Tp* b, std::size_t n) {
+    return simd_dispatch([&](auto tag) {
+        return reduce_chunks<Tp>(n, [&](std::size_t begin, std::size_t len) {
+            return dot_chunk(tag, a + begin, b + begin, len);
+        });
+    });
+}
+
+/**
+ * @brief 计算范围内元素的前缀和
+ * @details 并行时分三步:并行计算各段的和，顺序计算各段的起始值，
+ * 再并行计算每段内的前缀和
+ * @tparam Inclusive 为true时计算包含式前缀和，否则计算排除式前缀和
+ * @param first 指向第一个元素的指针
+ * @param last 指向最后一个元素后一位置的指针
+ * @param out 输出位置，可以与first相同
+ * @param init 初始值
+ * @return 初始值与所有元素的和
+ */
+template <bool Inclusive, typename Tp>
+Tp scan_range(const Tp* first, const Tp* last, Tp* out, Tp init) {
+    return simd_dispatch([&](auto tag) {
+        auto scan = [&](const Tp* begin, const Tp* end, Tp* dst, Tp carry) {
+            if constexpr (Inclusive) {
+                return inclusive_scan_block(tag, begin, end, dst, carry);
+            } else {
+                return exclusive_scan_block(tag, begin, end, dst, carry);
+            }
+        };
+        const std::size_t n = last - first;
+        if (!use_parallel(n)) {
+            return scan(first, last, out, init);
+        }
+        const std::size_t chunks =
+            (n + parallel_chunk_size - 1) / parallel_chunk_size;
+        auto chunk_begin = [&](std::size_t i) {
+            return first + std::min(i * parallel_chunk_size, n);
+        };
+        Vector<Tp> carries(chunks);
+        Tp* carry = carries.begin();
+        parallel_for<std::size_t>(
+            0, chunks, 1,
+            [&](std::size_t begin, std::size_t end) {
+                for (; begin != end; ++begin) {
+                    carry[begin] = sum_chunk(
+                        tag, chunk_begin(begin), chunk_begin(begin + 1)
+                    );
+                }
+            }
+        );
+        Tp total = init;
+        for (std::size_t i = 0; i < chunks; ++i) {
+            const Tp s = carry[i];
+            carry[i] = total;
+            total = wrap_add(total, s);
+        }
+        parallel_for<std::size_t>(
+            0, chunks, 1,
+            [&](std::size_t begin, std::size_t end) {
+                for (; begin != end; ++begin) {
+                    const Tp* src = chunk_begin(begin);
+                    scan(
+                        src, chunk_begin(begin + 1), out + (src - first),
+                        carry[begin]
+                    );
+                }
+            }
+        );
+        return total;
+    });
+}
+
+}  // namespace simd
+
+/**
+ * @brief 计算容器中所有元素的和
+ * @param vec 容器
+ * @return 元素的和，容器为空时返回Tp{}
+ * @note 整数溢出时按补码回绕;浮点数的求和顺序与逐个累加不同，
+ * 结果可能有舍入误差上的差别，但误差界更小
+ */
+template <typename Tp, IsAllocator Alloc>
+Tp sum(const Vector<Tp, Alloc>& vec) {
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return simd::sum_range<Tp>(vec.begin(), vec.end());
+    } else {
+        return std::accumulate(vec.begin(), vec.end(), Tp{});
+    }
+}
+
+/**
+ * @brief 计算两个容器的内积
+ * @param lhs 第一个容器
+ * @param rhs 第二个容器
+ * @return 对应元素乘积的和
+ * @throw std::invalid_argument 如果两个容器的元素个数不同
+ */
+template <typename Tp, IsAllocator Alloc1, IsAllocator Alloc2>
+Tp dot(const Vector<Tp, Alloc1>& lhs, const Vector<Tp, Alloc2>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        throw std::invalid_argument("user::dot: size mismatch");
+    }
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return simd::dot_range<Tp>(lhs.begin(), rhs.begin(), lhs.size());
+    } else {
+        return std::inner_product(lhs.begin(), lhs.end(), rhs.begin(), Tp{});
+    }
+}
+
+/**
+ * @brief 计算容器中所有元素的平方和
+ * @param vec 容器
+ * @return 元素平方的和
+ */
+template <typename Tp, IsAllocator Alloc>
+Tp sum_of_squares(const Vector<Tp, Alloc>& vec) {
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return simd::dot_range<Tp>(vec.begin(), vec.begin(), vec.size());
+    } else {
+        return std::inner_product(vec.begin(), vec.end(), vec.begin(), Tp{});
+    }
+}
+
+/**
+ * @brief 原地计算包含式前缀和，第i个元素变为原来前i + 1个元素的和
+ * @param vec 容器
+ */
+template <typename Tp, IsAllocator Alloc>
+void inclusive_scan(Vector<Tp, Alloc>& vec) {
+    if constexpr (IsSimdArithmetic<Tp>) {
+        simd::scan_range<true>(
+            std::as_const(vec).begin(), std::as_const(vec).end(), vec.begin(),
+            Tp{}
+        );
+    } else {
+        std::inclusive_scan(vec.begin(), vec.end(), vec.begin());
+    }
+}
+
+/**
+ * @brief 计算包含式前缀和并写入另一个容器
+ * @param src 输入容器
+ * @param dst 输出容器，大小会被调整为src.size()
+ */
+template <typename Tp, IsAllocator Alloc1, IsAllocator Alloc2>
+void inclusive_scan(const Vector<Tp, Alloc1>& src, Vector<Tp, Alloc2>& dst) {
+    dst.resize(src.size());
+    if constexpr (IsSimdArithmetic<Tp>) {
+        simd::scan_range<true>(src.begin(), src.end(), dst.begin(), Tp{});
+    } else {
+        std::inclusive_scan(src.begin(), src.end(), dst.begin());
+    }
+}
+
+/**
+ * @brief 原地计算排除式前缀和，第i个元素变为init与原来前i个元素的和
+ * @param vec 容器
+ * @param init 初始值
+ */
+template <typename Tp, IsAllocator Alloc>
+void exclusive_scan(Vector<Tp, Alloc>& vec, Tp init = Tp{}) {
+    if constexpr (IsSimdArithmetic<Tp>) {
+        simd::scan_range<false>(
+            std::as_const(vec).begin(), std::as_const(vec).end(), vec.begin(),
+            init
+        );
+    } else {
+        std::exclusive_scan(vec.begin(), vec.end(), vec.begin(), init);
+    }
+}
+
+/**
+ * @brief 计算排除式前缀和并写入另一个容器
+ * @param src 输入容器
+ * @param dst 输出容器，大小会被调整为src.size()
+ * @param init 初始值
+ */
+template <typename Tp, IsAllocator Alloc1, IsAllocator Alloc2>
+void exclusive_scan(
+    const Vector<Tp, Alloc1>& src, Vector<Tp, Alloc2>& dst, Tp init = Tp{}
+) {
+    dst.resize(src.size());
+    if constexpr (IsSimdArithmetic<Tp>) {
+        simd::scan_range<false>(src.begin(), src.end(), dst.begin(), init);
+    } else {
+        std::exclusive_scan(src.begin(), src.end(), dst.begin(), init);
+    }
+}
+
+}  // namespace user
+
+#endif  // SIMD_REDUCE_HPP
@@ -0,0 +1,357 @@
+/* UTF-8 */
+/**
+ * @file simd-search.hpp
+ * @brief user::Vector的向量化查找算法
+ * @details 对元素类型为int32_t、int64_t、float、double的Vector，
+ * 查找、计数、最值等算法使用SSE4.2/AVX2/AVX-512实现，并在运行时选择指令集;
+ * 其他元素类型以及不支持的CPU使用标准库算法
+ */
+
+#ifndef SIMD_SEARCH_HPP
+#define SIMD_SEARCH_HPP
+#include <algorithm/simd.hpp>
+#include <algorithm>
+#include <bit>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+namespace simd {
+
+/**
+ * @brief 查找第一个满足 (*it Op value) 的元素(标量实现)
+ */
+template <CmpOp Op, typename Tp>
+const Tp* find_cmp(
+    ScalarTag, std::integral_constant<CmpOp, Op>, const Tp* first,
+    const Tp* last, Tp value
+) {
+    for (; first != last; ++first) {
+        if (compare<Op>(*first, value)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+/**
+ * @brief 统计满足 (*it Op value) 的元素个数(标量实现)
+ */
+template <CmpOp Op, typename Tp>
+std::size_t count_cmp(
+    ScalarTag, std::integral_constant<CmpOp, Op>, const Tp* first,
+    const Tp* last, Tp value
+) {
+    std::size_t count = 0;
+    for (; first != last; ++first) {
+        count += compare<Op>(*first, value);
+    }
+    return count;
+}
+
+/**
+ * @brief 计算范围内元素的最小值和最大值(标量实现)
+ * @note 范围不可为空
+ */
+template <typename Tp>
+std::pair<Tp, Tp> minmax_value(ScalarTag, const Tp* first, const Tp* last) {
+    Tp min_value = *first;
+    Tp max_value = *first;
+    for (++first; first != last; ++first) {
+        min_value = *first < min_value ? *first : min_value;
+        max_value = max_value < *first ? *first : max_value;
+    }
+    return {min_value, max_value};
+}
+
+#if defined(USER_SIMD_X86)
+// 在每个指令集的命名空间中生成一份核心循环
+USER_SIMD_BEGIN_SSE42
+namespace sse42 {
+#include <algorithm/simd-search.inc>
+}  // namespace sse42
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX2
+namespace avx2 {
+#include <algorithm/simd-search.inc>
+}  // namespace avx2
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX512
+namespace avx512 {
+#include <algorithm/simd-search.inc>
+}  // namespace avx512
+USER_SIMD_END
+#endif
+
+}  // namespace simd
+
+/**
+ * @struct ValuePredicate
+ * @brief 与固定值比较的一元谓词，find_if和count_if对其使用向量化实现
+ * @tparam Op 比较运算
+ * @tparam Tp 值类型
+ */
+template <CmpOp Op, typename Tp>
+struct ValuePredicate {
+    Tp value;  // 比较的值
+
+    /**
+     * @brief 判断元素是否满足 (x Op value)
+     * @param x 元素
+     * @return 比较结果
+     */
+    constexpr bool operator()(const Tp& x) const noexcept {
+        return compare<Op>(x, value);
+    }
+};
+
+/**
+ * @struct ValuePredicateTraits
+ * @brief 获取ValuePredicate的比较运算和值类型
+ */
+template <typename Pred>
+struct ValuePredicateTraits : std::false_type {};
+
+template <CmpOp Op, typename Tp>
+struct ValuePredicateTraits<ValuePredicate<Op, Tp>> : std::true_type {
+    static constexpr CmpOp op = Op;  // 比较运算
+    using value_type = Tp;           // 值类型
+};
+
+/**
+ * @brief 判断谓词是否为可以向量化的ValuePredicate(值类型与元素类型相同)
+ */
+template <typename Pred, typename Tp>
+concept IsSimdPredicate =
+    IsSimdArithmetic<Tp> && ValuePredicateTraits<Pred>::value &&
+    std::is_same_v<typename ValuePredicateTraits<Pred>::value_type, Tp>;
+
+/**
+ * @brief 构造判断元素等于value的谓词
+ */
+template <typename Tp>
+constexpr ValuePredicate<CmpOp::Equal, Tp> is_equal(Tp value) noexcept {
+    return {value};
+}
+/**
+ * @brief 构造判断元素不等于value的谓词
+ */
+template <typename Tp>
+constexpr ValuePredicate<CmpOp::NotEqual, Tp> is_not_equal(Tp value) noexcept {
+    return {value};
+}
+/**
+ * @brief 构造判断元素小于value的谓词
+ */
+template <typename Tp>
+constexpr ValuePredicate<CmpOp::Less, Tp> is_less(Tp value) noexcept {
+    return {value};
+}
+/**
+ * @brief 构造判断元素小于等于value的谓词
+ */
+template <typename Tp>
+constexpr ValuePredicate<CmpOp::LessEqual, Tp> is_less_equal(Tp value) noexcept {
+    return {value};
+}
+/**
+ * @brief 构造判断元素大于value的谓词
+ */
+template <typename Tp>
+constexpr ValuePredicate<CmpOp::Greater, Tp> is_greater(Tp value) noexcept {
+    return {value};
+}
+/**
+ * @brief 构造判断元素大于等于value的谓词
+ */
+template <typename Tp>
+constexpr ValuePredicate<CmpOp::GreaterEqual, Tp> is_greater_equal(
+    Tp value
+) noexcept {
+    return {value};
+}
+
+/**
+ * @brief 查找第一个满足谓词的元素
+ * @param vec 需要查找的容器
+ * @param pred 一元谓词，为ValuePredicate时使用向量化实现
+ * @return 指向找到的元素的迭代器，没有找到时返回end()
+ */
+template <typename Tp, IsAllocator Alloc, typename Pred>
+typename Vector<Tp, Alloc>::const_iterator find_if(
+    const Vector<Tp, Alloc>& vec, Pred pred
+) {
+    if constexpr (IsSimdPredicate<Pred, Tp>) {
+        constexpr CmpOp op = ValuePredicateTraits<Pred>::op;
+        return simd_dispatch([&](auto tag) {
+            return find_cmp(
+                tag, std::integral_constant<CmpOp, op>{}, vec.begin(),
+                vec.end(), pred.value
+            );
+        });
+    }
+    return std::find_if(vec.begin(), vec.end(), pred);
+}
+
+/**
+ * @brief 查找第一个等于value的元素
+ * @param vec 需要查找的容器
+ * @param value 需要查找的值
+ * @return 指向找到的元素的迭代器，没有找到时返回end()
+ */
+template <typename Tp, IsAllocator Alloc>
+typename Vector<Tp, Alloc>::const_iterator find(
+    const Vector<Tp, Alloc>& vec, const Tp& value
+) {
+    return user::find_if(vec, is_equal(value));
+}
+
+/**
+ * @brief 判断容器中是否存在等于value的元素
+ * @param vec 需要查找的容器
+ * @param value 需要查找的值
+ * @return 存在时返回true
+ */
+template <typename Tp, IsAllocator Alloc>
+bool contains(const Vector<Tp, Alloc>& vec, const Tp& value) {
+    return user::find(vec, value) != vec.end();
+}
+
+/**
+ * @brief 统计满足谓词的元素个数
+ * @param vec 需要统计的容器
+ * @param pred 一元谓词，为ValuePredicate时使用向量化实现
+ * @return 满足谓词的元素个数
+ */
+template <typename Tp, IsAllocator Alloc, typename Pred>
+std::size_t count_if(const Vector<Tp, Alloc>& vec, Pred pred) {
+    if constexpr (IsSimdPredicate<Pred, Tp>) {
+        constexpr CmpOp op = ValuePredicateTraits<Pred>::op;
+        return simd_dispatch([&](auto tag) {
+            return count_cmp(
+                tag, std::integral_constant<CmpOp, op>{}, vec.begin(),
+                vec.end(), pred.value
+            );
+        });
+    }
+    return static_cast<std::size_t>(
+        std::count_if(vec.begin(), vec.end(), pred)
+    );
+}
+
+/**
+ * @brief 统计等于value的元素个数
+ * @param vec 需要统计的容器
+ * @param value 需要统计的值
+ * @return 等于value的元素个数
+ */
+template <typename Tp, IsAllocator Alloc>
+std::size_t count(const Vector<Tp, Alloc>& vec, const Tp& value) {
+    return user::count_if(vec, is_equal(value));
+}
+
+/**
+ * @brief 获取容器中的最小值和最大值
+ * @param vec 容器
+ * @return (最小值, 最大值)
+ * @throw std::out_of_range 如果容器为空
+ * @note 浮点数中存在NaN时结果未定义
+ */
+template <typename Tp, IsAllocator Alloc>
+std::pair<Tp, Tp> minmax(const Vector<Tp, Alloc>& vec) {
+    if (vec.size() == 0) {
+        throw std::out_of_range("user::minmax: empty Vector");
+    }
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return simd_dispatch([&](auto tag) {
+            return minmax_value(tag, vec.begin(), vec.end());
+        });
+    } else {
+        const auto [min_it, max_it] =
+            std::minmax_element(vec.begin(), vec.end());
+        return {*min_it, *max_it};
+    }
+}
+
+/**
+ * @brief 获取容器中的最小值
+ * @param vec 容器
+ * @return 最小值
+ * @throw std::out_of_range 如果容器为空
+ */
+template <typename Tp, IsAllocator Alloc>
+Tp min(const Vector<Tp, Alloc>& vec) {
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return user::minmax(vec).first;
+    } else {
+        if (vec.size() == 0) {
+            throw std::out_of_range("user::min: empty Vector");
+        }
+        return *std::min_element(vec.begin(), vec.end());
+    }
+}
+
+/**
+ * @brief 获取容器中的最大值
+ * @param vec 容器
+ * @return 最大值
+ * @throw std::out_of_range 如果容器为空
+ */
+template <typename Tp, IsAllocator Alloc>
+Tp max(const Vector<Tp, Alloc>& vec) {
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return user::minmax(vec).second;
+    } else {
+        if (vec.size() == 0) {
+            throw std::out_of_range("user::max: empty Vector");
+        }
+        return *std::max_element(vec.begin(), vec.end());
+    }
+}
+
+/**
+ * @brief 获取第一个最小值的下标
+ * @param vec 容器
+ * @return 第一个最小值的下标，容器为空时返回0
+ * @note 先求出最小值再查找其位置，两次遍历都是向量化的
+ */
+template <typename Tp, IsAllocator Alloc>
+std::size_t argmin(const Vector<Tp, Alloc>& vec) {
+    if (vec.size() == 0) {
+        return 0;
+    }
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return user::find(vec, user::min(vec)) - vec.begin();
+    } else {
+        return std::min_element(vec.begin(), vec.end()) - vec.begin();
+    }
+}
+
+/**
+ * @brief 获取第一个最大值的下标
+ * @param vec 容器
+ * @return 第一个最大值的下标，容器为空时返回0
+ */
+template <typename Tp, IsAllocator Alloc>
+std::size_t argmax(const Vector<Tp, Alloc>& vec) {
+    if (vec.size() == 0) {
+        return 0;
+    }
+    if constexpr (IsSimdArithmetic<Tp>) {
+        return user::find(vec, user::max(vec)) - vec.begin();
+    } else {
+        return std::max_element(vec.begin(), vec.end()) - vec.begin();
+    }
+}
+
+}  // namespace user
+
+#endif  // SIMD_SEARCH_HPP
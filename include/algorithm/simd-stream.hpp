@@ -0,0 +1,225 @@
+/* UTF-8 */
+/**
+ * @file simd-stream.hpp
+ * @brief 使用非临时写入的大块填充与复制
+ * @details 填充或复制远大于末级缓存的数据时，普通写入会先把目标缓存行读入
+ * 缓存，并挤出正在使用的数据。非临时写入(movnt)经写合并缓冲区直接写回内存，
+ * 既不污染缓存，也省去了读取目标缓存行的带宽。
+ * 数据量小于阈值时普通写入更快，因为写入的数据很可能马上被读取
+ */
+
+#ifndef SIMD_STREAM_HPP
+#define SIMD_STREAM_HPP
+#include <unistd.h>
+
+#include <algorithm/simd.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace user {
+
+namespace simd {
+
+// 缓存行大小，每次循环写入一个缓存行
+inline constexpr std::size_t cache_line = 64;
+// 无法获取末级缓存大小时使用的阈值
+inline constexpr std::size_t default_stream_threshold = std::size_t{1} << 25;
+
+/**
+ * @brief 获取保存非临时写入阈值的变量
+ * @details 默认值为末级缓存的大小
+ * @return 阈值的引用
+ */
+inline std::atomic<std::size_t>& S_stream_threshold() noexcept {
+    static std::atomic<std::size_t> threshold{[] {
+        const long l3 = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+        return l3 > 0 ? static_cast<std::size_t>(l3)
+                      : default_stream_threshold;
+    }()};
+    return threshold;
+}
+
+/**
+ * @brief 判断n个Tp的填充或复制是否使用非临时写入
+ * @param n 元素个数
+ * @return 应当使用时返回true
+ */
+template <typename Tp>
+bool use_stream(std::size_t n) noexcept {
+    if constexpr (!std::is_trivially_copyable_v<Tp>) {
+        return false;
+    } else {
+        return n != 0 &&
+               n >= S_stream_threshold().load(std::memory_order_relaxed) /
+                        sizeof(Tp);
+    }
+}
+
+/**
+ * @brief 复制内存(标量实现)
+ */
+inline void stream_copy(
+    ScalarTag, std::byte* dst, const std::byte* src, std::size_t bytes
+) {
+    std::memcpy(dst, src, bytes);
+}
+
+/**
+ * @brief 按重复的模式填充内存(标量实现)
+ */
+inline void stream_fill(
+    ScalarTag, std::byte* dst, const std::byte* pattern, std::size_t bytes
+) {
+    const std::size_t offset =
+        reinterpret_cast<std::uintptr_t>(dst) % cache_line;
+    const std::size_t head =
+        std::min(bytes, (cache_line - offset) % cache_line);
+    std::memcpy(dst, pattern + offset, head);
+    dst += head;
+    bytes -= head;
+    for (; bytes >= cache_line; bytes -= cache_line, dst += cache_line) {
+        std::memcpy(dst, pattern, cache_line);
+    }
+    std::memcpy(dst, pattern, bytes);
+}
+
+#if defined(USER_SIMD_X86)
+/*
+ * 每个指令集命名空间中的StreamOps提供以下静态成员:
+ * vec_type      向量类型
+ * width         一个向量的字节数
+ * load(p)       非对齐读取
+ * stream(p, v)  对齐的非临时写入
+ * fence()       使之前的非临时写入对其他线程可见
+ */
+USER_SIMD_BEGIN_SSE42
+namespace sse42 {
+struct StreamOps {
+    using vec_type = __m128i;
+    static constexpr std::size_t width = 16;
+    static vec_type load(const std::byte* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    static void stream(std::byte* p, vec_type v) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+    static void fence() { _mm_sfence(); }
+};
+#include <algorithm/simd-stream.inc>
+}  // namespace sse42
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX2
+namespace avx2 {
+struct StreamOps {
+    using vec_type = __m256i;
+    static constexpr std::size_t width = 32;
+    static vec_type load(const std::byte* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void stream(std::byte* p, vec_type v) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    static void fence() { _mm_sfence(); }
+};
+#include <algorithm/simd-stream.inc>
+}  // namespace avx2
+USER_SIMD_END
+
+USER_SIMD_BEGIN_AVX512
+namespace avx512 {
+struct StreamOps {
+    using vec_type = __m512i;
+    static constexpr std::size_t width = 64;
+    static vec_type load(const std::byte* p) {
+        return _mm512_loadu_si512(p);
+    }
+    static void stream(std::byte* p, vec_type v) {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(p), v);
+    }
+    static void fence() { _mm_sfence(); }
+};
+#include <algorithm/simd-stream.inc>
+}  // namespace avx512
+USER_SIMD_END
+#endif
+
+/**
+ * @brief 使用非临时写入以n个value填充区间
+ * @details 元素大小整除缓存行大小时，将value重复成一个缓存行的模式后写入，
+ * 否则使用std::fill_n
+ * @param first 区间起点，区间可以未初始化
+ * @param n 元素个数
+ * @param value 填充的值
+ * @return 区间终点
+ */
+template <typename Tp>
+    requires std::is_trivially_copyable_v<Tp>
+Tp* stream_fill_n(Tp* first, std::size_t n, const Tp& value) {
+    if constexpr (cache_line % sizeof(Tp) != 0) {
+        return std::fill_n(first, n, value);
+    } else {
+        // 模式按地址对缓存行取模索引，起点不一定按sizeof(Tp)对齐
+        alignas(cache_line) std::byte pattern[cache_line];
+        const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+        const std::size_t offset =
+            reinterpret_cast<std::uintptr_t>(first) % sizeof(Tp);
+        for (std::size_t i = 0; i < cache_line; ++i) {
+            pattern[i] = bytes[(i + sizeof(Tp) - offset) % sizeof(Tp)];
+        }
+        auto* dst = reinterpret_cast<std::byte*>(first);
+        simd_dispatch([&](auto tag) {
+            stream_fill(tag, dst, pattern, n * sizeof(Tp));
+        });
+        return first + n;
+    }
+}
+
+/**
+ * @brief 使用非临时写入复制n个元素
+ * @param src 源区间起点
+ * @param n 元素个数
+ * @param dst 目标区间起点，可以未初始化，不能与源区间重叠
+ * @return 目标区间终点
+ */
+template <typename Tp>
+    requires std::is_trivially_copyable_v<Tp>
+Tp* stream_copy_n(const Tp* src, std::size_t n, Tp* dst) {
+    if (n == 0) {
+        return dst;
+    }
+    simd_dispatch([&](auto tag) {
+        stream_copy(
+            tag, reinterpret_cast<std::byte*>(dst),
+            reinterpret_cast<const std::byte*>(src), n * sizeof(Tp)
+        );
+    });
+    return dst + n;
+}
+
+}  // namespace simd
+
+/**
+ * @brief 设置Vector填充与复制使用非临时写入的阈值
+ * @param bytes 总字节数不小于此值时使用非临时写入，
+ * 为std::numeric_limits<std::size_t>::max()时关闭
+ */
+inline void set_stream_threshold(std::size_t bytes) noexcept {
+    simd::S_stream_threshold().store(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 获取Vector填充与复制使用非临时写入的阈值
+ * @return 阈值(字节)，默认为末级缓存的大小
+ */
+inline std::size_t stream_threshold() noexcept {
+    return simd::S_stream_threshold().load(std::memory_order_relaxed);
+}
+
+}  // namespace user
+
+#endif  // SIMD_STREAM_HPP
@@ -0,0 +1,955 @@
+/* UTF-8 */
+/**
+ * @file simd.hpp
+ * @brief SIMD指令集的运行时检测以及各指令集的向量操作封装
+ * @details 每种指令集的向量操作定义在各自的命名空间中(sse42、avx2、avx512)，
+ * 并且只在该命名空间内打开对应的目标指令集，因此头文件不需要额外的编译选项。
+ * 算法头文件将与指令集无关的核心循环(*.inc)在每个命名空间中各包含一次，
+ * 再通过simd_dispatch()在运行时选择CPU支持的最高指令集
+ */
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define USER_SIMD_X86 1
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12的AVX-512头文件中_mm512_undefined_*()会产生误报的未初始化警告
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+// 打开和关闭指定指令集的代码区域(_Pragma只接受单个字符串字面量)
+#if defined(USER_SIMD_X86) && defined(__clang__)
+// clang-format off
+#define USER_SIMD_BEGIN_SSE42 _Pragma("clang attribute push(__attribute__((target(\"sse4.2,popcnt\"))), apply_to = function)")
+#define USER_SIMD_BEGIN_AVX2 _Pragma("clang attribute push(__attribute__((target(\"avx2,fma,popcnt,bmi,bmi2\"))), apply_to = function)")
+#define USER_SIMD_BEGIN_AVX512 _Pragma("clang attribute push(__attribute__((target(\"avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,popcnt,bmi,bmi2\"))), apply_to = function)")
+#define USER_SIMD_END _Pragma("clang attribute pop")
+// clang-format on
+#elif defined(USER_SIMD_X86)
+// clang-format off
+#define USER_SIMD_BEGIN_SSE42 _Pragma("GCC push_options") _Pragma("GCC target(\"sse4.2,popcnt\")")
+#define USER_SIMD_BEGIN_AVX2 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma,popcnt,bmi,bmi2\")")
+#define USER_SIMD_BEGIN_AVX512 _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,popcnt,bmi,bmi2\")")
+#define USER_SIMD_END _Pragma("GCC pop_options")
+// clang-format on
+#endif
+
+namespace user {
+
+/**
+ * @enum SimdIsa
+ * @brief 可使用的SIMD指令集，按从低到高的顺序排列
+ */
+enum class SimdIsa { Scalar, SSE42, AVX2, AVX512 };
+
+/**
+ * @enum CmpOp
+ * @brief 向量比较运算的种类
+ */
+enum class CmpOp { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+/**
+ * @brief 使用标量比较两个值
+ * @tparam Op 比较运算
+ * @param a 左操作数
+ * @param b 右操作数
+ * @return 比较结果
+ */
+template <CmpOp Op, typename Tp>
+constexpr bool compare(const Tp& a, const Tp& b) noexcept {
+    if constexpr (Op == CmpOp::Equal) {
+        return a == b;
+    } else if constexpr (Op == CmpOp::NotEqual) {
+        return a != b;
+    } else if constexpr (Op == CmpOp::Less) {
+        return a < b;
+    } else if constexpr (Op == CmpOp::LessEqual) {
+        return a <= b;
+    } else if constexpr (Op == CmpOp::Greater) {
+        return a > b;
+    } else {
+        return a >= b;
+    }
+}
+
+namespace simd {
+
+/**
+ * @brief 检测当前CPU支持的最高指令集
+ * @return 最高可用的指令集
+ */
+inline SimdIsa detect_isa() noexcept {
+#if defined(USER_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq")) {
+        return SimdIsa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+        __builtin_cpu_supports("bmi2")) {
+        return SimdIsa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2") &&
+        __builtin_cpu_supports("popcnt")) {
+        return SimdIsa::SSE42;
+    }
+#endif
+    return SimdIsa::Scalar;
+}
+
+/**
+ * @brief 获取保存当前使用的指令集的变量
+ * @return 当前指令集的引用
+ */
+inline SimdIsa& S_current_isa() noexcept {
+    static SimdIsa isa = detect_isa();
+    return isa;
+}
+
+}  // namespace simd
+
+/**
+ * @brief 获取当前算法使用的指令集
+ * @return 当前使用的指令集
+ */
+inline SimdIsa simd_isa() noexcept { return simd::S_current_isa(); }
+
+/**
+ * @brief 限制算法使用的指令集(用于测试和性能对比)
+ * @param isa 希望使用的指令集，超出CPU支持范围时使用CPU支持的最高指令集
+ * @warning 不是线程安全的，应在使用算法之前设置
+ */
+inline void set_simd_isa(SimdIsa isa) noexcept {
+    const SimdIsa max_isa = simd::detect_isa();
+    simd::S_current_isa() = isa < max_isa ? isa : max_isa;
+}
+
+namespace simd {
+
+/**
+ * @struct ScalarTag
+ * @brief 标量实现的标签类型
+ */
+struct ScalarTag {};
+
+}  // namespace simd
+
+}  // namespace user
+
+#if defined(USER_SIMD_X86)
+
+namespace user::simd {
+
+/**
+ * @brief 获取浮点数比较运算对应的AVX比较谓词
+ * @param op 比较运算
+ * @return _mm*_cmp_p*使用的谓词
+ */
+constexpr int float_predicate(CmpOp op) noexcept {
+    switch (op) {
+        case CmpOp::Equal:
+            return _CMP_EQ_OQ;
+        case CmpOp::NotEqual:
+            return _CMP_NEQ_UQ;  // 与NaN比较时结果为true，与!=一致
+        case CmpOp::Less:
+            return _CMP_LT_OQ;
+        case CmpOp::LessEqual:
+            return _CMP_LE_OQ;
+        case CmpOp::Greater:
+            return _CMP_GT_OQ;
+        default:
+            return _CMP_GE_OQ;
+    }
+}
+
+/**
+ * @brief 获取整数比较运算对应的AVX-512比较谓词
+ * @param op 比较运算
+ * @return _mm512_cmp_ep*_mask使用的谓词
+ */
+constexpr int int_predicate(CmpOp op) noexcept {
+    switch (op) {
+        case CmpOp::Equal:
+            return _MM_CMPINT_EQ;
+        case CmpOp::NotEqual:
+            return _MM_CMPINT_NE;
+        case CmpOp::Less:
+            return _MM_CMPINT_LT;
+        case CmpOp::LessEqual:
+            return _MM_CMPINT_LE;
+        case CmpOp::Greater:
+            return _MM_CMPINT_NLE;
+        default:
+            return _MM_CMPINT_NLT;
+    }
+}
+
+/**
+ * @brief 生成压缩元素使用的下标表
+ * @details 第m项的第j个4位是8位掩码m中第j个置位的位置，
+ * 多余的4位为0，AVX2展开后作为_mm256_permutevar8x32_*的下标
+ */
+constexpr std::array<std::uint32_t, 256> make_compress_index_table() noexcept {
+    std::array<std::uint32_t, 256> table{};
+    for (unsigned m = 0; m < 256; ++m) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < 8; ++i) {
+            if ((m >> i) & 1) {
+                table[m] |= i << (4 * j++);
+            }
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief 生成SSE压缩32位元素使用的字节重排表
+ * @details 第m项把4位掩码m选中的元素依次移到低位，作为_mm_shuffle_epi8的参数
+ */
+constexpr std::array<std::array<std::uint8_t, 16>, 16>
+make_compress_shuffle_table() noexcept {
+    std::array<std::array<std::uint8_t, 16>, 16> table{};
+    for (unsigned m = 0; m < 16; ++m) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            if ((m >> i) & 1) {
+                for (unsigned k = 0; k < 4; ++k) {
+                    table[m][4 * j + k] = static_cast<std::uint8_t>(4 * i + k);
+                }
+                ++j;
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr auto compress_index_table = make_compress_index_table();
+inline constexpr auto compress_shuffle_table = make_compress_shuffle_table();
+
+/*
+ * 每个指令集命名空间中的Ops<Tp>提供以下静态成员:
+ * vec_type          向量类型
+ * width             一个向量中的元素个数
+ * load/store/set1   非对齐读取、非对齐写入、广播
+ * zero              全0向量
+ * add/mul/fmadd     逐元素加法、乘法(整数取低位)、乘加 a * b + c
+ * shift<K>(a)       整体向高位移动K个元素，低位补0
+ * broadcast_last(a) 将最后一个元素广播到所有元素
+ * cmp<Op>(a, b)     逐元素比较，返回每个元素一位的掩码
+ * min/max           逐元素取最小值和最大值
+ * compress(p, a, m) 将掩码m选中的元素按顺序写到p开始的位置，
+ *                   可能写满整个向量，未选中的位置的值不确定
+ */
+
+/* ---------------------------- SSE4.2 ---------------------------- */
+USER_SIMD_BEGIN_SSE42
+namespace sse42 {
+
+struct Tag {};
+
+template <typename Tp>
+struct Ops;
+
+/**
+ * @brief 获取把掩码m选中的32位元素移到低位的字节重排参数
+ */
+inline __m128i compress_shuffle(unsigned m) {
+    return _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(compress_shuffle_table[m].data())
+    );
+}
+
+/**
+ * @brief 将64位元素的2位掩码展开为对应32位元素的4位掩码
+ */
+constexpr unsigned expand_mask2(unsigned m) noexcept {
+    return (m & 1) * 3 | (m & 2) * 6;
+}
+
+/**
+ * @brief 由相等和大于两种比较组合出整数的比较掩码
+ * @tparam Op 比较运算
+ * @tparam O 整数类型的Ops，需要提供eq(a, b)和gt(a, b)
+ * @return 每个元素一位的比较掩码
+ */
+template <CmpOp Op, typename O>
+inline unsigned int_cmp(typename O::vec_type a, typename O::vec_type b) {
+    constexpr unsigned full = (1u << O::width) - 1;
+    if constexpr (Op == CmpOp::Equal) {
+        return O::eq(a, b);
+    } else if constexpr (Op == CmpOp::NotEqual) {
+        return ~O::eq(a, b) & full;
+    } else if constexpr (Op == CmpOp::Greater) {
+        return O::gt(a, b);
+    } else if constexpr (Op == CmpOp::Less) {
+        return O::gt(b, a);
+    } else if constexpr (Op == CmpOp::LessEqual) {
+        return ~O::gt(a, b) & full;
+    } else {
+        return ~O::gt(b, a) & full;
+    }
+}
+
+template <>
+struct Ops<std::int32_t> {
+    using vec_type = __m128i;
+    static constexpr std::size_t width = 4;
+
+    static vec_type load(const std::int32_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    static void store(std::int32_t* p, vec_type a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a);
+    }
+    static vec_type set1(std::int32_t x) { return _mm_set1_epi32(x); }
+    static vec_type zero() { return _mm_setzero_si128(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm_add_epi32(a, b); }
+    static vec_type mul(vec_type a, vec_type b) {
+        return _mm_mullo_epi32(a, b);
+    }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm_slli_si128(a, K * 4);
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm_shuffle_epi32(a, 0xFF);
+    }
+    static unsigned mask(vec_type m) {
+        return _mm_movemask_ps(_mm_castsi128_ps(m));
+    }
+    static unsigned eq(vec_type a, vec_type b) {
+        return mask(_mm_cmpeq_epi32(a, b));
+    }
+    static unsigned gt(vec_type a, vec_type b) {
+        return mask(_mm_cmpgt_epi32(a, b));
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        return int_cmp<Op, Ops>(a, b);
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm_min_epi32(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm_max_epi32(a, b); }
+    static void compress(std::int32_t* p, vec_type a, unsigned m) {
+        store(p, _mm_shuffle_epi8(a, compress_shuffle(m)));
+    }
+};
+
+template <>
+struct Ops<std::int64_t> {
+    using vec_type = __m128i;
+    static constexpr std::size_t width = 2;
+
+    static vec_type load(const std::int64_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    static void store(std::int64_t* p, vec_type a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a);
+    }
+    static vec_type set1(std::int64_t x) { return _mm_set1_epi64x(x); }
+    static vec_type zero() { return _mm_setzero_si128(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm_add_epi64(a, b); }
+    static vec_type mul(vec_type a, vec_type b) {
+        // 没有64位整数乘法指令，由32位乘法组合得到低64位
+        const __m128i cross = _mm_add_epi64(
+            _mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+            _mm_mul_epu32(a, _mm_srli_epi64(b, 32))
+        );
+        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+    }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm_slli_si128(a, K * 8);
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm_shuffle_epi32(a, 0xEE);
+    }
+    static unsigned mask(vec_type m) {
+        return _mm_movemask_pd(_mm_castsi128_pd(m));
+    }
+    static unsigned eq(vec_type a, vec_type b) {
+        return mask(_mm_cmpeq_epi64(a, b));
+    }
+    static unsigned gt(vec_type a, vec_type b) {
+        return mask(_mm_cmpgt_epi64(a, b));
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        return int_cmp<Op, Ops>(a, b);
+    }
+    static vec_type min(vec_type a, vec_type b) {
+        return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b));
+    }
+    static vec_type max(vec_type a, vec_type b) {
+        return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b));
+    }
+    static void compress(std::int64_t* p, vec_type a, unsigned m) {
+        store(p, _mm_shuffle_epi8(a, compress_shuffle(expand_mask2(m))));
+    }
+};
+
+template <>
+struct Ops<float> {
+    using vec_type = __m128;
+    static constexpr std::size_t width = 4;
+
+    static vec_type load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, vec_type a) { _mm_storeu_ps(p, a); }
+    static vec_type set1(float x) { return _mm_set1_ps(x); }
+    static vec_type zero() { return _mm_setzero_ps(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm_add_ps(a, b); }
+    static vec_type mul(vec_type a, vec_type b) { return _mm_mul_ps(a, b); }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(a), K * 4));
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm_shuffle_ps(a, a, 0xFF);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        if constexpr (Op == CmpOp::Equal) {
+            return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+        } else if constexpr (Op == CmpOp::NotEqual) {
+            return _mm_movemask_ps(_mm_cmpneq_ps(a, b));
+        } else if constexpr (Op == CmpOp::Less) {
+            return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+        } else if constexpr (Op == CmpOp::LessEqual) {
+            return _mm_movemask_ps(_mm_cmple_ps(a, b));
+        } else if constexpr (Op == CmpOp::Greater) {
+            return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+        } else {
+            return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+        }
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm_min_ps(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm_max_ps(a, b); }
+    static void compress(float* p, vec_type a, unsigned m) {
+        store(
+            p, _mm_castsi128_ps(
+                   _mm_shuffle_epi8(_mm_castps_si128(a), compress_shuffle(m))
+               )
+        );
+    }
+};
+
+template <>
+struct Ops<double> {
+    using vec_type = __m128d;
+    static constexpr std::size_t width = 2;
+
+    static vec_type load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, vec_type a) { _mm_storeu_pd(p, a); }
+    static vec_type set1(double x) { return _mm_set1_pd(x); }
+    static vec_type zero() { return _mm_setzero_pd(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm_add_pd(a, b); }
+    static vec_type mul(vec_type a, vec_type b) { return _mm_mul_pd(a, b); }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(a), K * 8));
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm_unpackhi_pd(a, a);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        if constexpr (Op == CmpOp::Equal) {
+            return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+        } else if constexpr (Op == CmpOp::NotEqual) {
+            return _mm_movemask_pd(_mm_cmpneq_pd(a, b));
+        } else if constexpr (Op == CmpOp::Less) {
+            return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+        } else if constexpr (Op == CmpOp::LessEqual) {
+            return _mm_movemask_pd(_mm_cmple_pd(a, b));
+        } else if constexpr (Op == CmpOp::Greater) {
+            return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+        } else {
+            return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+        }
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm_min_pd(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm_max_pd(a, b); }
+    static void compress(double* p, vec_type a, unsigned m) {
+        store(p, _mm_castsi128_pd(_mm_shuffle_epi8(
+                     _mm_castpd_si128(a), compress_shuffle(expand_mask2(m))
+                 )));
+    }
+};
+
+}  // namespace sse42
+USER_SIMD_END
+
+/* ----------------------------- AVX2 ----------------------------- */
+USER_SIMD_BEGIN_AVX2
+namespace avx2 {
+
+struct Tag {};
+
+template <typename Tp>
+struct Ops;
+
+/**
+ * @brief 获取把8位掩码m选中的32位元素移到低位的排列下标
+ */
+inline __m256i compress_permutation(unsigned m) {
+    const __m256i packed =
+        _mm256_set1_epi32(static_cast<int>(compress_index_table[m]));
+    const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    return _mm256_and_si256(
+        _mm256_srlv_epi32(packed, shifts), _mm256_set1_epi32(7)
+    );
+}
+
+// 与sse42::int_cmp相同，在AVX2代码区域中重新定义以便内联
+template <CmpOp Op, typename O>
+inline unsigned int_cmp(typename O::vec_type a, typename O::vec_type b) {
+    constexpr unsigned full = (1u << O::width) - 1;
+    if constexpr (Op == CmpOp::Equal) {
+        return O::eq(a, b);
+    } else if constexpr (Op == CmpOp::NotEqual) {
+        return ~O::eq(a, b) & full;
+    } else if constexpr (Op == CmpOp::Greater) {
+        return O::gt(a, b);
+    } else if constexpr (Op == CmpOp::Less) {
+        return O::gt(b, a);
+    } else if constexpr (Op == CmpOp::LessEqual) {
+        return ~O::gt(a, b) & full;
+    } else {
+        return ~O::gt(b, a) & full;
+    }
+}
+
+/**
+ * @brief 将256位向量整体向高位移动Bytes个字节，低位补0
+ * @tparam Bytes 移动的字节数，不超过16
+ */
+template <std::size_t Bytes>
+inline __m256i shift_bytes(__m256i a) {
+    // t的低128位为0，高128位为a的低128位
+    const __m256i t = _mm256_permute2x128_si256(a, a, 0x08);
+    if constexpr (Bytes == 16) {
+        return t;
+    } else {
+        return _mm256_alignr_epi8(a, t, 16 - Bytes);
+    }
+}
+
+template <>
+struct Ops<std::int32_t> {
+    using vec_type = __m256i;
+    static constexpr std::size_t width = 8;
+
+    static vec_type load(const std::int32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void store(std::int32_t* p, vec_type a) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+    }
+    static vec_type set1(std::int32_t x) { return _mm256_set1_epi32(x); }
+    static vec_type zero() { return _mm256_setzero_si256(); }
+    static vec_type add(vec_type a, vec_type b) {
+        return _mm256_add_epi32(a, b);
+    }
+    static vec_type mul(vec_type a, vec_type b) {
+        return _mm256_mullo_epi32(a, b);
+    }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return shift_bytes<K * 4>(a);
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm256_permutevar8x32_epi32(a, _mm256_set1_epi32(7));
+    }
+    static unsigned mask(vec_type m) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(m));
+    }
+    static unsigned eq(vec_type a, vec_type b) {
+        return mask(_mm256_cmpeq_epi32(a, b));
+    }
+    static unsigned gt(vec_type a, vec_type b) {
+        return mask(_mm256_cmpgt_epi32(a, b));
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        return int_cmp<Op, Ops>(a, b);
+    }
+    static vec_type min(vec_type a, vec_type b) {
+        return _mm256_min_epi32(a, b);
+    }
+    static vec_type max(vec_type a, vec_type b) {
+        return _mm256_max_epi32(a, b);
+    }
+    static void compress(std::int32_t* p, vec_type a, unsigned m) {
+        store(p, _mm256_permutevar8x32_epi32(a, compress_permutation(m)));
+    }
+};
+
+template <>
+struct Ops<std::int64_t> {
+    using vec_type = __m256i;
+    static constexpr std::size_t width = 4;
+
+    static vec_type load(const std::int64_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void store(std::int64_t* p, vec_type a) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+    }
+    static vec_type set1(std::int64_t x) { return _mm256_set1_epi64x(x); }
+    static vec_type zero() { return _mm256_setzero_si256(); }
+    static vec_type add(vec_type a, vec_type b) {
+        return _mm256_add_epi64(a, b);
+    }
+    static vec_type mul(vec_type a, vec_type b) {
+        const __m256i cross = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+            _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32))
+        );
+        return _mm256_add_epi64(
+            _mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32)
+        );
+    }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return shift_bytes<K * 8>(a);
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm256_permute4x64_epi64(a, 0xFF);
+    }
+    static unsigned mask(vec_type m) {
+        return _mm256_movemask_pd(_mm256_castsi256_pd(m));
+    }
+    static unsigned eq(vec_type a, vec_type b) {
+        return mask(_mm256_cmpeq_epi64(a, b));
+    }
+    static unsigned gt(vec_type a, vec_type b) {
+        return mask(_mm256_cmpgt_epi64(a, b));
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        return int_cmp<Op, Ops>(a, b);
+    }
+    static vec_type min(vec_type a, vec_type b) {
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    }
+    static vec_type max(vec_type a, vec_type b) {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    }
+    static void compress(std::int64_t* p, vec_type a, unsigned m) {
+        store(
+            p, _mm256_permutevar8x32_epi32(
+                   a, compress_permutation(_pdep_u32(m, 0x55) * 3)
+               )
+        );
+    }
+};
+
+template <>
+struct Ops<float> {
+    using vec_type = __m256;
+    static constexpr std::size_t width = 8;
+
+    static vec_type load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, vec_type a) { _mm256_storeu_ps(p, a); }
+    static vec_type set1(float x) { return _mm256_set1_ps(x); }
+    static vec_type zero() { return _mm256_setzero_ps(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm256_add_ps(a, b); }
+    static vec_type mul(vec_type a, vec_type b) { return _mm256_mul_ps(a, b); }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm256_castsi256_ps(shift_bytes<K * 4>(_mm256_castps_si256(a)));
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm256_permutevar8x32_ps(a, _mm256_set1_epi32(7));
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        // 比较谓词必须是常量表达式(-O0时内建函数也要求立即数)
+        constexpr int pred = float_predicate(Op);
+        return _mm256_movemask_ps(_mm256_cmp_ps(a, b, pred));
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm256_min_ps(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm256_max_ps(a, b); }
+    static void compress(float* p, vec_type a, unsigned m) {
+        store(p, _mm256_permutevar8x32_ps(a, compress_permutation(m)));
+    }
+};
+
+template <>
+struct Ops<double> {
+    using vec_type = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static vec_type load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, vec_type a) { _mm256_storeu_pd(p, a); }
+    static vec_type set1(double x) { return _mm256_set1_pd(x); }
+    static vec_type zero() { return _mm256_setzero_pd(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm256_add_pd(a, b); }
+    static vec_type mul(vec_type a, vec_type b) { return _mm256_mul_pd(a, b); }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm256_castsi256_pd(shift_bytes<K * 8>(_mm256_castpd_si256(a)));
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm256_permute4x64_pd(a, 0xFF);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        constexpr int pred = float_predicate(Op);
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, pred));
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm256_min_pd(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm256_max_pd(a, b); }
+    static void compress(double* p, vec_type a, unsigned m) {
+        store(p, _mm256_castps_pd(_mm256_permutevar8x32_ps(
+                     _mm256_castpd_ps(a),
+                     compress_permutation(_pdep_u32(m, 0x55) * 3)
+                 )));
+    }
+};
+
+}  // namespace avx2
+USER_SIMD_END
+
+/* ---------------------------- AVX-512 ---------------------------- */
+USER_SIMD_BEGIN_AVX512
+namespace avx512 {
+
+struct Tag {};
+
+template <typename Tp>
+struct Ops;
+
+template <>
+struct Ops<std::int32_t> {
+    using vec_type = __m512i;
+    static constexpr std::size_t width = 16;
+
+    static vec_type load(const std::int32_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+    static void store(std::int32_t* p, vec_type a) {
+        _mm512_storeu_si512(p, a);
+    }
+    static vec_type set1(std::int32_t x) { return _mm512_set1_epi32(x); }
+    static vec_type zero() { return _mm512_setzero_si512(); }
+    static vec_type add(vec_type a, vec_type b) {
+        return _mm512_add_epi32(a, b);
+    }
+    static vec_type mul(vec_type a, vec_type b) {
+        return _mm512_mullo_epi32(a, b);
+    }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm512_alignr_epi32(a, _mm512_setzero_si512(), 16 - K);
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm512_permutexvar_epi32(_mm512_set1_epi32(15), a);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        constexpr int pred = int_predicate(Op);
+        return _mm512_cmp_epi32_mask(a, b, pred);
+    }
+    static vec_type min(vec_type a, vec_type b) {
+        return _mm512_min_epi32(a, b);
+    }
+    static vec_type max(vec_type a, vec_type b) {
+        return _mm512_max_epi32(a, b);
+    }
+    static void compress(std::int32_t* p, vec_type a, unsigned m) {
+        store(p, _mm512_maskz_compress_epi32(static_cast<__mmask16>(m), a));
+    }
+};
+
+template <>
+struct Ops<std::int64_t> {
+    using vec_type = __m512i;
+    static constexpr std::size_t width = 8;
+
+    static vec_type load(const std::int64_t* p) {
+        return _mm512_loadu_si512(p);
+    }
+    static void store(std::int64_t* p, vec_type a) {
+        _mm512_storeu_si512(p, a);
+    }
+    static vec_type set1(std::int64_t x) { return _mm512_set1_epi64(x); }
+    static vec_type zero() { return _mm512_setzero_si512(); }
+    static vec_type add(vec_type a, vec_type b) {
+        return _mm512_add_epi64(a, b);
+    }
+    static vec_type mul(vec_type a, vec_type b) {
+        return _mm512_mullo_epi64(a, b);
+    }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return add(mul(a, b), c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm512_alignr_epi64(a, _mm512_setzero_si512(), 8 - K);
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm512_permutexvar_epi64(_mm512_set1_epi64(7), a);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        constexpr int pred = int_predicate(Op);
+        return _mm512_cmp_epi64_mask(a, b, pred);
+    }
+    static vec_type min(vec_type a, vec_type b) {
+        return _mm512_min_epi64(a, b);
+    }
+    static vec_type max(vec_type a, vec_type b) {
+        return _mm512_max_epi64(a, b);
+    }
+    static void compress(std::int64_t* p, vec_type a, unsigned m) {
+        store(p, _mm512_maskz_compress_epi64(static_cast<__mmask8>(m), a));
+    }
+};
+
+template <>
+struct Ops<float> {
+    using vec_type = __m512;
+    static constexpr std::size_t width = 16;
+
+    static vec_type load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, vec_type a) { _mm512_storeu_ps(p, a); }
+    static vec_type set1(float x) { return _mm512_set1_ps(x); }
+    static vec_type zero() { return _mm512_setzero_ps(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm512_add_ps(a, b); }
+    static vec_type mul(vec_type a, vec_type b) { return _mm512_mul_ps(a, b); }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm512_castsi512_ps(_mm512_alignr_epi32(
+            _mm512_castps_si512(a), _mm512_setzero_si512(), 16 - K
+        ));
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm512_permutexvar_ps(_mm512_set1_epi32(15), a);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        constexpr int pred = float_predicate(Op);
+        return _mm512_cmp_ps_mask(a, b, pred);
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm512_min_ps(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm512_max_ps(a, b); }
+    static void compress(float* p, vec_type a, unsigned m) {
+        store(p, _mm512_maskz_compress_ps(static_cast<__mmask16>(m), a));
+    }
+};
+
+template <>
+struct Ops<double> {
+    using vec_type = __m512d;
+    static constexpr std::size_t width = 8;
+
+    static vec_type load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, vec_type a) { _mm512_storeu_pd(p, a); }
+    static vec_type set1(double x) { return _mm512_set1_pd(x); }
+    static vec_type zero() { return _mm512_setzero_pd(); }
+    static vec_type add(vec_type a, vec_type b) { return _mm512_add_pd(a, b); }
+    static vec_type mul(vec_type a, vec_type b) { return _mm512_mul_pd(a, b); }
+    static vec_type fmadd(vec_type a, vec_type b, vec_type c) {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+    template <std::size_t K>
+    static vec_type shift(vec_type a) {
+        return _mm512_castsi512_pd(_mm512_alignr_epi64(
+            _mm512_castpd_si512(a), _mm512_setzero_si512(), 8 - K
+        ));
+    }
+    static vec_type broadcast_last(vec_type a) {
+        return _mm512_permutexvar_pd(_mm512_set1_epi64(7), a);
+    }
+    template <CmpOp Op>
+    static unsigned cmp(vec_type a, vec_type b) {
+        constexpr int pred = float_predicate(Op);
+        return _mm512_cmp_pd_mask(a, b, pred);
+    }
+    static vec_type min(vec_type a, vec_type b) { return _mm512_min_pd(a, b); }
+    static vec_type max(vec_type a, vec_type b) { return _mm512_max_pd(a, b); }
+    static void compress(double* p, vec_type a, unsigned m) {
+        store(p, _mm512_maskz_compress_pd(static_cast<__mmask8>(m), a));
+    }
+};
+
+}  // namespace avx512
+USER_SIMD_END
+
+}  // namespace user::simd
+
+#endif  // USER_SIMD_X86
+
+namespace user {
+
+/**
+ * @brief 根据当前指令集调用对应的实现
+ * @details 将对应指令集命名空间中的标签类型(如simd::avx2::Tag)传入f，
+ * f通过实参依赖查找调用该命名空间中的核心函数
+ * @param f 以标签为参数的可调用对象
+ * @return f的返回值
+ */
+template <typename F>
+decltype(auto) simd_dispatch(F&& f) {
+#if defined(USER_SIMD_X86)
+    switch (simd_isa()) {
+        case SimdIsa::AVX512:
+            return f(simd::avx512::Tag{});
+        case SimdIsa::AVX2:
+            return f(simd::avx2::Tag{});
+        case SimdIsa::SSE42:
+            return f(simd::sse42::Tag{});
+        default:
+            break;
+    }
+#endif
+    return f(simd::ScalarTag{});
+}
+
+}  // namespace user
+
+#endif  // SIMD_HPP
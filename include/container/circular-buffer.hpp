@@ -0,0 +1,842 @@
+/* UTF-8 */
+/**
+ * @file circular-buffer.hpp
+ * @brief 实现固定容量、满时覆盖最旧元素的环形缓冲区CircularBuffer
+ * @details 在VectorBase的基础上增加指向第一个元素的指针M_first和元素个数
+ * M_size，M_finish指向下一次在末尾插入的位置。[M_start, M_end_of_shorage)
+ * 为整块内存，元素从M_first开始存放，到达内存末尾后回到M_start继续。
+ * 元素至多分成两段连续内存(array_one()和array_two())，可以直接交给
+ * 向量化的代码处理;linearize()在原内存中把元素旋转为一段
+ */
+
+#ifndef CIRCULAR_BUFFER_HPP
+#define CIRCULAR_BUFFER_HPP
+
+#include <algorithm>
+#include <compare>
+#include <container/vectorbase.hpp>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <small-utility/smallutility.hpp>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @struct CircularBufferBase
+ * @brief CircularBuffer的基类，在VectorBase的基础上记录元素的位置
+ * @details 继承自VectorBase的M_start与M_end_of_shorage仍表示整块内存，
+ * 因此VectorBase的析构函数能正确释放内存
+ * @tparam Tp 对象类型
+ * @tparam Alloc 分配器类型
+ */
+template <typename Tp, IsAllocator Alloc>
+struct CircularBufferBase : VectorBase<Tp, Alloc> {
+    using Base = VectorBase<Tp, Alloc>;
+    using typename Base::pointer;
+    using typename Base::Tp_alloc_type;
+
+    pointer M_first;         // 指向第一个元素的指针
+    std::size_t M_size = 0;  // 元素个数
+
+    constexpr CircularBufferBase() noexcept : M_first() {}
+
+    /**
+     * @brief 使用指定的分配器分配n个元素的内存
+     * @param n 容量
+     * @param a 分配器
+     */
+    constexpr CircularBufferBase(std::size_t n, const Tp_alloc_type& a)
+        : Base(a), M_first() {
+        this->M_start = this->M_allocate(n);
+        this->M_first = this->M_finish = this->M_start;
+        this->M_end_of_shorage = this->M_start + n;
+    }
+
+    /**
+     * @brief 移动构造函数，接管内存
+     */
+    constexpr CircularBufferBase(CircularBufferBase&& other) noexcept
+        : Base(std::move(other)), M_first(other.M_first), M_size(other.M_size) {
+        other.M_first = pointer{};
+        other.M_size = 0;
+    }
+
+    /**
+     * @brief 根据下标计算元素的地址
+     * @param i 下标，不超过容量
+     */
+    constexpr pointer M_locate(std::size_t i) const noexcept {
+        const std::size_t capacity = this->M_end_of_shorage - this->M_start;
+        std::size_t offset = (M_first - this->M_start) + i;
+        if (offset >= capacity) {
+            offset -= capacity;
+        }
+        return this->M_start + offset;
+    }
+
+    /**
+     * @brief 交换两个对象的内存
+     * @param other 另一对象
+     */
+    constexpr void M_swap_data(CircularBufferBase& other) noexcept {
+        Base::M_swap_data(other);
+        std::swap(M_first, other.M_first);
+        std::swap(M_size, other.M_size);
+    }
+};
+
+/**
+ * @class CircularBufferIterator
+ * @brief CircularBuffer的随机访问迭代器，保存内存的位置和下标
+ * @details 内存起点、容量和第一个元素的偏移在构造时复制到迭代器中，
+ * 交换或移动容器后迭代器仍然指向原来的内存。改变第一个元素位置的操作
+ * (在前端插入或删除、已满时在末尾插入、linearize()等)使迭代器失效
+ * @tparam Base CircularBufferBase类型
+ * @tparam Const 是否为常量迭代器
+ */
+template <typename Base, bool Const>
+class CircularBufferIterator {
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = typename Base::Tr::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<Const, const value_type&, value_type&>;
+
+    CircularBufferIterator() = default;
+
+    /**
+     * @brief 由容器和下标构造
+     */
+    CircularBufferIterator(const Base* buffer, std::size_t index)
+        : start(buffer->M_start),
+          capacity(buffer->M_end_of_shorage - buffer->M_start),
+          offset(buffer->M_first - buffer->M_start),
+          index(index) {}
+
+    /**
+     * @brief 由非常量迭代器构造常量迭代器
+     */
+    CircularBufferIterator(const CircularBufferIterator<Base, !Const>& other)
+        requires Const
+        : start(other.start),
+          capacity(other.capacity),
+          offset(other.offset),
+          index(other.index) {}
+
+    reference operator*() const { return *M_locate(index); }
+    pointer operator->() const { return std::to_address(M_locate(index)); }
+    reference operator[](difference_type n) const {
+        return *M_locate(index + n);
+    }
+
+    CircularBufferIterator& operator++() {
+        ++index;
+        return *this;
+    }
+    CircularBufferIterator operator++(int) {
+        CircularBufferIterator tmp = *this;
+        ++index;
+        return tmp;
+    }
+    CircularBufferIterator& operator--() {
+        --index;
+        return *this;
+    }
+    CircularBufferIterator operator--(int) {
+        CircularBufferIterator tmp = *this;
+        --index;
+        return tmp;
+    }
+    CircularBufferIterator& operator+=(difference_type n) {
+        index += n;
+        return *this;
+    }
+    CircularBufferIterator& operator-=(difference_type n) {
+        index -= n;
+        return *this;
+    }
+    friend CircularBufferIterator operator+(
+        CircularBufferIterator it, difference_type n
+    ) {
+        return it += n;
+    }
+    friend CircularBufferIterator operator+(
+        difference_type n, CircularBufferIterator it
+    ) {
+        return it += n;
+    }
+    friend CircularBufferIterator operator-(
+        CircularBufferIterator it, difference_type n
+    ) {
+        return it -= n;
+    }
+    friend difference_type operator-(
+        const CircularBufferIterator& a, const CircularBufferIterator& b
+    ) {
+        return static_cast<difference_type>(a.index - b.index);
+    }
+    friend bool operator==(
+        const CircularBufferIterator& a, const CircularBufferIterator& b
+    ) {
+        return a.index == b.index;
+    }
+    friend std::strong_ordering operator<=>(
+        const CircularBufferIterator& a, const CircularBufferIterator& b
+    ) {
+        return a.index <=> b.index;
+    }
+
+private:
+    template <typename, bool>
+    friend class CircularBufferIterator;
+
+    /**
+     * @brief 根据下标计算元素的地址，与CircularBufferBase::M_locate相同
+     * @param i 下标，不超过容量
+     */
+    typename Base::pointer M_locate(std::size_t i) const noexcept {
+        std::size_t pos = offset + i;
+        if (pos >= capacity) {
+            pos -= capacity;
+        }
+        return start + pos;
+    }
+
+    typename Base::pointer start{};  // 整块内存的起点
+    std::size_t capacity = 0;        // 容量
+    std::size_t offset = 0;          // 第一个元素相对起点的偏移
+    std::size_t index = 0;           // 下标
+};
+
+/**
+ * @class CircularBuffer
+ * @brief 固定容量的环形缓冲区，已满时插入会覆盖另一端的元素
+ * @details 两端的插入和删除均为O(1)且不会分配内存;
+ * 已满时push_back()覆盖最旧的元素，push_front()覆盖最新的元素
+ * @tparam Tp 要存储的数据类型，不可为const或volatile修饰类型
+ * @tparam Alloc 分配器类型，分配的类型需要与Tp相同
+ */
+template <NotConstVolatile Tp, IsAllocator Alloc = std::allocator<Tp>>
+    requires SameTypeAlloc<Tp, Alloc>
+class CircularBuffer : protected CircularBufferBase<Tp, Alloc> {
+    using Base = CircularBufferBase<Tp, Alloc>;          // 基类
+    using Tp_alloc_type = typename Base::Tp_alloc_type;  // 分配器类型
+    using Alloc_traits = std::allocator_traits<Tp_alloc_type>;
+
+    // 移动不抛出异常时才在原内存中线性化，否则改为重新分配，
+    // 保证移动中途失败时容器不变
+    static constexpr bool S_shift_in_place =
+        std::is_nothrow_move_constructible_v<Tp> &&
+        std::is_nothrow_move_assignable_v<Tp> &&
+        std::is_nothrow_swappable_v<Tp>;
+
+public:
+    using value_type = Tp;                                       // 数值类型
+    using pointer = typename Base::pointer;                      // 指针类型
+    using const_pointer = typename Alloc_traits::const_pointer;  // 常量指针类型
+    using reference = Tp&;                                       // 引用类型
+    using const_reference = const Tp&;                   // 常量引用类型
+    using iterator = CircularBufferIterator<Base, false>;  // 迭代器类型
+    using const_iterator = CircularBufferIterator<Base, true>;  // 常量迭代器
+    using reverse_iterator = std::reverse_iterator<iterator>;  // 反向迭代器
+    using const_reverse_iterator =
+        std::reverse_iterator<const_iterator>;  // 反向常量迭代器
+    using size_type = std::size_t;              // 元素个数类型
+    using difference_type = std::ptrdiff_t;     // 迭代器差值类型
+    using allocator_type = Alloc;               // 分配器类型
+
+    CircularBuffer() = default;
+
+    /**
+     * @brief 构造容量为capacity的空缓冲区
+     * @param capacity 容量
+     * @param a 分配器
+     */
+    explicit CircularBuffer(
+        size_type capacity, const allocator_type& a = allocator_type()
+    )
+        : Base(S_check_init_len(capacity), a) {}
+
+    /**
+     * @brief 构造容量为capacity的缓冲区，并依次插入范围中的元素
+     * @param capacity 容量
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @param a 分配器
+     * @note 元素多于容量时只保留最后capacity个
+     */
+    template <std::input_iterator InputIterator>
+    CircularBuffer(
+        size_type capacity, InputIterator first, InputIterator last,
+        const allocator_type& a = allocator_type()
+    )
+        : Base(S_check_init_len(capacity), a) {
+        try {
+            append(first, last);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 复制构造函数，元素从内存起点开始存放
+     * @param other 需要复制的CircularBuffer
+     */
+    CircularBuffer(const CircularBuffer& other)
+        : Base(
+              other.capacity(),
+              Alloc_traits::select_on_container_copy_construction(
+                  other.M_get_Tp_allocator()
+              )
+          ) {
+        const auto one = other.array_one();
+        const auto two = other.array_two();
+        const pointer mid =
+            std::uninitialized_copy(one.begin(), one.end(), this->M_start);
+        try {
+            std::uninitialized_copy(two.begin(), two.end(), mid);
+        } catch (...) {
+            std::destroy(this->M_start, mid);
+            throw;
+        }
+        this->M_size = other.size();
+        this->M_finish = this->M_locate(this->M_size);
+    }
+
+    /**
+     * @brief 移动构造函数
+     * @param other 右值CircularBuffer
+     */
+    CircularBuffer(CircularBuffer&& other) noexcept : Base(std::move(other)) {}
+
+    /**
+     * @brief 析构函数，析构所有元素
+     */
+    ~CircularBuffer() noexcept { M_destroy_all(); }
+
+    /**
+     * @brief 复制赋值运算符
+     * @param other 另一CircularBuffer
+     * @return 当前对象的引用
+     */
+    CircularBuffer& operator=(const CircularBuffer& other) {
+        if (this != std::addressof(other)) {
+            CircularBuffer tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 移动赋值运算符
+     * @param other 另一右值CircularBuffer
+     * @return 当前对象的引用
+     */
+    CircularBuffer& operator=(CircularBuffer&& other) noexcept {
+        this->M_swap_data(other);
+        // 分配器需要跟随内存一起转移
+        if constexpr (Alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            std::swap(this->M_get_Tp_allocator(), other.M_get_Tp_allocator());
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 交换两个容器的内容
+     * @param other 另一CircularBuffer
+     * @note 分配器只在propagate_on_container_swap为true时交换
+     */
+    void swap(CircularBuffer& other) noexcept {
+        this->M_swap_data(other);
+        if constexpr (Alloc_traits::propagate_on_container_swap::value) {
+            std::swap(this->M_get_Tp_allocator(), other.M_get_Tp_allocator());
+        }
+    }
+
+    /**
+     * @brief 获取容器的分配器
+     */
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(this->M_get_Tp_allocator());
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator(this, this->M_size);
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this, this->M_size);
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+    [[nodiscard]] reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 获取第一段连续的元素(从第一个元素到内存末尾或最后一个元素)
+     */
+    [[nodiscard]] std::span<Tp> array_one() noexcept {
+        return {this->M_first, M_one_size()};
+    }
+    [[nodiscard]] std::span<const Tp> array_one() const noexcept {
+        return {this->M_first, M_one_size()};
+    }
+
+    /**
+     * @brief 获取第二段连续的元素(从内存起点开始)，元素没有绕回时为空
+     */
+    [[nodiscard]] std::span<Tp> array_two() noexcept {
+        return {this->M_start, this->M_size - M_one_size()};
+    }
+    [[nodiscard]] std::span<const Tp> array_two() const noexcept {
+        return {this->M_start, this->M_size - M_one_size()};
+    }
+
+    /**
+     * @brief 判断元素是否存放在一段连续内存中
+     */
+    [[nodiscard]] bool is_linearized() const noexcept {
+        return M_one_size() == this->M_size;
+    }
+
+    /**
+     * @brief 将元素移到内存起点，使其连续存放
+     * @return 所有元素组成的一段连续内存
+     * @note 元素的移动不抛出异常时在原内存中完成，否则重新分配内存
+     */
+    std::span<Tp> linearize() {
+        if (this->M_first == this->M_start) {
+            return {this->M_start, this->M_size};
+        }
+        if constexpr (S_shift_in_place) {
+            M_linearize_in_place();
+        } else {
+            M_reallocate(capacity());
+        }
+        return {this->M_start, this->M_size};
+    }
+
+    /**
+     * @brief 按下标访问元素，下标0为最旧的元素
+     * @param i 下标，必须小于size()
+     */
+    [[nodiscard]] reference operator[](size_type i) noexcept {
+        return *this->M_locate(i);
+    }
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return *this->M_locate(i);
+    }
+
+    /**
+     * @brief 按下标访问元素并检查范围
+     * @param i 下标
+     * @throw std::out_of_range 下标不小于size()
+     */
+    [[nodiscard]] reference at(size_type i) {
+        M_check_index(i);
+        return (*this)[i];
+    }
+    [[nodiscard]] const_reference at(size_type i) const {
+        M_check_index(i);
+        return (*this)[i];
+    }
+
+    [[nodiscard]] reference front() noexcept { return *this->M_first; }
+    [[nodiscard]] const_reference front() const noexcept {
+        return *this->M_first;
+    }
+    [[nodiscard]] reference back() noexcept { return *M_prev(this->M_finish); }
+    [[nodiscard]] const_reference back() const noexcept {
+        return *M_prev(this->M_finish);
+    }
+
+    /**
+     * @brief 获取元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept { return this->M_size; }
+
+    /**
+     * @brief 判断容器是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept { return this->M_size == 0; }
+
+    /**
+     * @brief 判断容器是否已满，已满时插入会覆盖元素
+     */
+    [[nodiscard]] bool full() const noexcept {
+        return this->M_size == capacity();
+    }
+
+    /**
+     * @brief 获取容量
+     */
+    [[nodiscard]] size_type capacity() const noexcept {
+        return this->M_end_of_shorage - this->M_start;
+    }
+
+    /**
+     * @brief 获取最多可以容纳的元素个数
+     */
+    [[nodiscard]] size_type max_size() const noexcept {
+        return S_max_size();
+    }
+
+    /**
+     * @brief 修改容量，元素多于新容量时只保留最新的元素
+     * @param n 新的容量
+     */
+    void set_capacity(size_type n) {
+        if (n == capacity()) {
+            return;
+        }
+        S_check_init_len(n);
+        while (this->M_size > n) {
+            pop_front();
+        }
+        M_reallocate(n);
+    }
+
+    /**
+     * @brief 在末尾构造新元素，已满时先删除最旧的元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     * @note 容量必须大于0
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (full()) {
+            // 参数可能引用即将被覆盖的元素，先构造新元素
+            value_type tmp(std::forward<Args>(args)...);
+            pop_front();
+            return emplace_back(std::move(tmp));
+        }
+        const pointer p = this->M_finish;
+        Alloc_traits::construct(
+            this->M_get_Tp_allocator(), p, std::forward<Args>(args)...
+        );
+        this->M_finish = M_next(p);
+        ++this->M_size;
+        return *p;
+    }
+
+    /**
+     * @brief 在开头构造新元素，已满时先删除最新的元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     * @note 容量必须大于0
+     */
+    template <typename... Args>
+    reference emplace_front(Args&&... args) {
+        if (full()) {
+            // 参数可能引用即将被覆盖的元素，先构造新元素
+            value_type tmp(std::forward<Args>(args)...);
+            pop_back();
+            return emplace_front(std::move(tmp));
+        }
+        const pointer p = M_prev(this->M_first);
+        Alloc_traits::construct(
+            this->M_get_Tp_allocator(), p, std::forward<Args>(args)...
+        );
+        this->M_first = p;
+        ++this->M_size;
+        return *p;
+    }
+
+    /**
+     * @brief 在末尾插入元素，容量为0时不插入
+     * @param value 元素的值
+     */
+    void push_back(const value_type& value) {
+        if (capacity() != 0) {
+            emplace_back(value);
+        }
+    }
+    void push_back(value_type&& value) {
+        if (capacity() != 0) {
+            emplace_back(std::move(value));
+        }
+    }
+
+    /**
+     * @brief 在开头插入元素，容量为0时不插入
+     * @param value 元素的值
+     */
+    void push_front(const value_type& value) {
+        if (capacity() != 0) {
+            emplace_front(value);
+        }
+    }
+    void push_front(value_type&& value) {
+        if (capacity() != 0) {
+            emplace_front(std::move(value));
+        }
+    }
+
+    /**
+     * @brief 在末尾依次插入范围中的元素，已满时覆盖最旧的元素
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @note 可平凡复制的元素来自连续内存时，至多调用两次memcpy
+     */
+    template <std::input_iterator InputIterator>
+    void append(InputIterator first, InputIterator last) {
+        if constexpr (std::contiguous_iterator<InputIterator> &&
+                      std::is_trivially_copyable_v<Tp> &&
+                      std::is_same_v<std::iter_value_t<InputIterator>, Tp>) {
+            M_append_trivial(
+                std::to_address(first), static_cast<size_type>(last - first)
+            );
+        } else {
+            for (; first != last; ++first) {
+                push_back(*first);
+            }
+        }
+    }
+
+    /**
+     * @brief 删除最后一个元素
+     * @note 容器不能为空
+     */
+    void pop_back() noexcept {
+        this->M_finish = M_prev(this->M_finish);
+        Alloc_traits::destroy(this->M_get_Tp_allocator(), this->M_finish);
+        --this->M_size;
+    }
+
+    /**
+     * @brief 删除第一个元素
+     * @note 容器不能为空
+     */
+    void pop_front() noexcept {
+        Alloc_traits::destroy(this->M_get_Tp_allocator(), this->M_first);
+        this->M_first = M_next(this->M_first);
+        --this->M_size;
+    }
+
+    /**
+     * @brief 析构所有元素，保留内存
+     */
+    void clear() noexcept {
+        M_destroy_all();
+        this->M_first = this->M_finish = this->M_start;
+        this->M_size = 0;
+    }
+
+private:
+    /**
+     * @brief 获取第一段连续元素的个数
+     */
+    size_type M_one_size() const noexcept {
+        return std::min<size_type>(
+            this->M_size, this->M_end_of_shorage - this->M_first
+        );
+    }
+
+    /**
+     * @brief 获取环形内存中p的下一个位置
+     */
+    pointer M_next(pointer p) const noexcept {
+        return ++p == this->M_end_of_shorage ? this->M_start : p;
+    }
+
+    /**
+     * @brief 获取环形内存中p的上一个位置
+     */
+    pointer M_prev(pointer p) const noexcept {
+        return (p == this->M_start ? this->M_end_of_shorage : p) - 1;
+    }
+
+    /**
+     * @brief 析构所有元素，不修改位置信息
+     */
+    void M_destroy_all() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Tp>) {
+            const auto one = array_one();
+            const auto two = array_two();
+            std::destroy(one.begin(), one.end());
+            std::destroy(two.begin(), two.end());
+        }
+    }
+
+    /**
+     * @brief 在末尾插入n个可平凡复制的元素，至多两次memcpy
+     * @param src 元素的起始地址
+     * @param n 元素个数
+     */
+    void M_append_trivial(const Tp* src, size_type n) noexcept {
+        const size_type cap = capacity();
+        if (n >= cap) {
+            // 只有最后cap个元素会保留下来
+            src += n - cap;
+            if (cap != 0) {
+                std::memcpy(
+                    static_cast<void*>(std::to_address(this->M_start)), src,
+                    cap * sizeof(Tp)
+                );
+            }
+            this->M_first = this->M_finish = this->M_start;
+            this->M_size = cap;
+            return;
+        }
+        if (n == 0) {
+            return;
+        }
+        const size_type k = std::min<size_type>(
+            n, this->M_end_of_shorage - this->M_finish
+        );
+        std::memcpy(
+            static_cast<void*>(std::to_address(this->M_finish)), src,
+            k * sizeof(Tp)
+        );
+        if (k != n) {
+            std::memcpy(
+                static_cast<void*>(std::to_address(this->M_start)), src + k,
+                (n - k) * sizeof(Tp)
+            );
+        }
+        size_type offset = (this->M_finish - this->M_start) + n;
+        if (offset >= cap) {
+            offset -= cap;
+        }
+        this->M_finish = this->M_start + offset;
+        if (this->M_size + n > cap) {
+            // 覆盖了最旧的元素，第一个元素紧跟在最后一个元素之后
+            this->M_first = this->M_finish;
+            this->M_size = cap;
+        } else {
+            this->M_size += n;
+        }
+    }
+
+    /**
+     * @brief 在原内存中将元素旋转到内存起点
+     * @note 只在元素的移动和交换不抛出异常时使用
+     */
+    void M_linearize_in_place() noexcept {
+        const pointer start = this->M_start;
+        const size_type n = this->M_size;
+        const size_type one = M_one_size();
+        if (one != n) {
+            // 元素绕回:第二段位于起点，先把第一段前移到第二段之后，
+            // 再旋转两段的顺序
+            const pointer second_end = start + (n - one);
+            M_shift_down(this->M_first, one, second_end);
+            std::rotate(start, second_end, start + n);
+        } else {
+            M_shift_down(this->M_first, n, start);
+        }
+        this->M_first = start;
+        this->M_finish = this->M_locate(n);
+    }
+
+    /**
+     * @brief 将从first开始的n个元素移到更靠前的dest
+     * @details [dest, first)中没有构造元素，移动后[dest, dest + n)为元素，
+     * 原位置上多余的元素被析构
+     */
+    static void M_shift_down(pointer first, size_type n, pointer dest) noexcept {
+        if (dest == first || n == 0) {
+            return;
+        }
+        if constexpr (std::is_trivially_copyable_v<Tp>) {
+            std::memmove(
+                static_cast<void*>(std::to_address(dest)),
+                static_cast<const void*>(std::to_address(first)),
+                n * sizeof(Tp)
+            );
+        } else {
+            // 目标的前k个位置未构造，其余位置与原区间重叠
+            const size_type k = std::min<size_type>(first - dest, n);
+            std::uninitialized_move(first, first + k, dest);
+            std::move(first + k, first + n, dest + k);
+            std::destroy(std::max(dest + n, first), first + n);
+        }
+    }
+
+    /**
+     * @brief 将元素按顺序搬到容量为len的新内存的起点
+     * @param len 新的容量，不小于元素个数
+     */
+    void M_reallocate(size_type len) {
+        const pointer new_start = this->M_allocate(len);
+        const auto one = array_one();
+        const auto two = array_two();
+        pointer mid = new_start;
+        try {
+            mid = uninitialized_move_or_copy(one.begin(), one.end(), new_start);
+            uninitialized_move_or_copy(two.begin(), two.end(), mid);
+        } catch (...) {
+            std::destroy(new_start, mid);
+            this->M_deallocate(new_start, len);
+            throw;
+        }
+        M_destroy_all();
+        this->M_deallocate(this->M_start, capacity());
+        this->M_start = this->M_first = new_start;
+        this->M_end_of_shorage = new_start + len;
+        this->M_finish = this->M_locate(this->M_size);
+    }
+
+    /**
+     * @brief 检查下标是否有效
+     * @throw std::out_of_range 下标不小于size()
+     */
+    void M_check_index(size_type i) const {
+        if (i >= this->M_size) {
+            throw std::out_of_range("CircularBuffer::at");
+        }
+    }
+
+    /**
+     * @brief 判断容量是否可行
+     * @throw std::length_error 超出最大可分配数目
+     */
+    static size_type S_check_init_len(size_type n) {
+        if (n > S_max_size()) {
+            throw std::length_error(
+                "cannot create user::CircularBuffer larger than max_size()"
+            );
+        }
+        return n;
+    }
+
+    /**
+     * @brief 计算分配器可分配的元素的最大数量
+     */
+    static constexpr size_type S_max_size() noexcept {
+        const size_type diffmax =
+            std::numeric_limits<std::ptrdiff_t>::max() / sizeof(Tp);
+        const size_type allocmax = Alloc_traits::max_size(Tp_alloc_type{});
+        return std::min(diffmax, allocmax);
+    }
+};
+
+}  // namespace user
+
+#endif  // CIRCULAR_BUFFER_HPP
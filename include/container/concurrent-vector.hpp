@@ -0,0 +1,487 @@
+/* UTF-8 */
+/**
+ * @file concurrent-vector.hpp
+ * @brief user::ConcurrentVector类，可由多个线程无锁追加的只增数组
+ * @details 段的划分与StableVector相同，元素从不移动。追加分为三步:
+ * 1. 对reserved做fetch_add，预留连续的下标;
+ * 2. 所需的段不存在时各线程独立分配，用CAS安装到段目录，失败的一方释放;
+ * 3. 构造元素后发布:若published恰好等于预留的起点，用一次CAS直接推进，
+ *    否则在每个元素的就绪标记中置位，由先完成的线程顺带推进published。
+ * size()返回published，[0, size())内的元素都已构造完成，可以并发读取。
+ * 任何一步都不会等待其他线程，被挂起的线程只会推迟之后元素的发布
+ */
+
+#ifndef CONCURRENT_VECTOR_HPP
+#define CONCURRENT_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <container/stable-vector.hpp>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @class ConcurrentVector
+ * @brief 支持并发追加和并发读取的只增数组
+ * @tparam Tp 要存储的数据类型
+ * @tparam Alloc 分配器类型，分配的类型需要与Tp相同
+ * @note push_back、emplace_back、grow_by、reserve、size、operator[]、at、
+ * begin、end和snapshot可以并发调用;clear、析构只能在没有其他线程访问时调用。
+ * 元素的构造函数抛出异常时该位置改为值初始化后发布，因此Tp需要能够
+ * 不抛出异常地值初始化
+ */
+template <NotConstVolatile Tp, IsAllocator Alloc = Allocator<Tp>>
+    requires SameTypeAlloc<Tp, Alloc>
+class ConcurrentVector {
+    using Layout = StableVectorBase<Tp, Alloc>;  // 段的划分方式
+    using Tp_alloc_type = typename Layout::Tp_alloc_type;
+    using Alloc_traits = typename Layout::Tr;
+    using flag_type = std::atomic<unsigned char>;  // 元素的就绪标记
+    using Flag_alloc_type =
+        typename Alloc_traits::template rebind_alloc<flag_type>;
+    using Flag_traits = std::allocator_traits<Flag_alloc_type>;
+
+    static_assert(
+        std::is_nothrow_default_constructible_v<Tp>,
+        "ConcurrentVector requires nothrow value-initializable elements"
+    );
+
+public:
+    using value_type = Tp;                                   // 数值类型
+    using pointer = typename Layout::pointer;                // 指针类型
+    using reference = Tp&;                                   // 引用类型
+    using const_reference = const Tp&;                       // 常量引用类型
+    // 迭代器
+    using iterator =
+        StableVectorIterator<Layout, false, std::atomic<pointer>>;
+    // 常量迭代器
+    using const_iterator =
+        StableVectorIterator<Layout, true, std::atomic<pointer>>;
+    using size_type = std::size_t;           // 元素个数类型
+    using difference_type = std::ptrdiff_t;  // 迭代器差值类型
+    using allocator_type = Alloc;            // 分配器类型
+
+    ConcurrentVector() = default;
+
+    /**
+     * @brief 使用指定的分配器构造
+     * @param a 分配器
+     */
+    explicit ConcurrentVector(const allocator_type& a) noexcept
+        : alloc(a), flag_alloc(alloc) {}
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    /**
+     * @brief 析构所有元素并释放所有段
+     */
+    ~ConcurrentVector() noexcept {
+        clear();
+        for (size_type k = 0; k < Layout::S_max_segments; ++k) {
+            const pointer data = segments[k].load(std::memory_order_relaxed);
+            if (data != pointer{}) {
+                Alloc_traits::deallocate(
+                    alloc, data, Layout::S_segment_size(k)
+                );
+            }
+            flag_type* ready = flags[k].load(std::memory_order_relaxed);
+            if (ready != nullptr) {
+                Flag_traits::deallocate(
+                    flag_alloc, ready, Layout::S_segment_size(k)
+                );
+            }
+        }
+    }
+
+    /**
+     * @brief 在末尾构造新元素
+     * @param args 构造函数参数
+     * @return 新元素的引用，函数返回时该元素已发布
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        return (*this)[M_emplace(std::forward<Args>(args)...)];
+    }
+
+    /**
+     * @brief 在末尾插入元素
+     * @param value 元素的值
+     * @return 新元素的下标
+     */
+    size_type push_back(const value_type& value) { return M_emplace(value); }
+    size_type push_back(value_type&& value) {
+        return M_emplace(std::move(value));
+    }
+
+    /**
+     * @brief 在末尾追加n个值初始化的元素
+     * @param n 元素个数
+     * @return 第一个新元素的下标，追加的元素下标连续
+     */
+    size_type grow_by(size_type n) {
+        return M_grow(n, [this](pointer p, size_type) { M_construct(p); });
+    }
+
+    /**
+     * @brief 在末尾追加n个value
+     * @param n 元素个数
+     * @param value 元素的值
+     * @return 第一个新元素的下标
+     */
+    size_type grow_by(size_type n, const value_type& value) {
+        return M_grow(n, [this, &value](pointer p, size_type) {
+            M_construct(p, value);
+        });
+    }
+
+    /**
+     * @brief 在末尾追加[first, last)中的元素
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @return 第一个新元素的下标
+     */
+    template <std::random_access_iterator Iterator>
+    size_type grow_by(Iterator first, Iterator last) {
+        return M_grow(
+            static_cast<size_type>(last - first),
+            [this, first](pointer p, size_type j) { M_construct(p, first[j]); }
+        );
+    }
+
+    /**
+     * @brief 预先分配能容纳n个元素的段
+     * @param n 需要的容量
+     */
+    void reserve(size_type n) {
+        if (n != 0) {
+            M_ensure_segments(0, n);
+        }
+    }
+
+    /**
+     * @brief 获取已发布的元素个数
+     * @return 元素个数，[0, size())内的元素都可以安全读取
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return published.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 判断是否没有已发布的元素
+     */
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief 按下标访问元素
+     * @param i 下标，必须小于此前某次size()的返回值
+     */
+    [[nodiscard]] reference operator[](size_type i) noexcept {
+        return *Layout::S_locate(segments.data(), i);
+    }
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return *Layout::S_locate(segments.data(), i);
+    }
+
+    /**
+     * @brief 按下标访问元素并检查元素是否已发布
+     * @param i 下标
+     * @throw std::out_of_range 下标不小于size()
+     */
+    [[nodiscard]] reference at(size_type i) {
+        M_check_index(i);
+        return (*this)[i];
+    }
+    [[nodiscard]] const_reference at(size_type i) const {
+        M_check_index(i);
+        return (*this)[i];
+    }
+
+    /**
+     * @brief 获取起始迭代器
+     */
+    [[nodiscard]] iterator begin() noexcept {
+        return iterator(segments.data(), 0);
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(segments.data(), 0);
+    }
+
+    /**
+     * @brief 获取调用时已发布元素的尾后迭代器
+     */
+    [[nodiscard]] iterator end() noexcept {
+        return iterator(segments.data(), size());
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(segments.data(), size());
+    }
+
+    /**
+     * @brief 将已发布的元素复制到一个连续的Vector中
+     * @return 包含调用时已发布的全部元素的Vector
+     */
+    [[nodiscard]] Vector<Tp, Alloc> snapshot() const {
+        const const_iterator first = begin();
+        return Vector<Tp, Alloc>(first, first + size());
+    }
+
+    /**
+     * @brief 析构所有元素，保留已分配的段
+     * @note 不能与其他操作并发
+     */
+    void clear() noexcept {
+        const size_type n = reserved.load(std::memory_order_relaxed);
+        size_type remaining = n;
+        for (size_type k = 0; remaining != 0; ++k) {
+            const size_type count =
+                std::min(remaining, Layout::S_segment_size(k));
+            if constexpr (!std::is_trivially_destructible_v<Tp>) {
+                std::destroy_n(
+                    segments[k].load(std::memory_order_relaxed), count
+                );
+            }
+            // 走快速路径发布的元素没有置位，其余元素置位，统一清零
+            flag_type* ready = flags[k].load(std::memory_order_relaxed);
+            for (size_type j = 0; j < count; ++j) {
+                ready[j].store(0, std::memory_order_relaxed);
+            }
+            remaining -= count;
+        }
+        reserved.store(0, std::memory_order_relaxed);
+        published.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief 预留n个连续的下标并保证它们所在的段已分配
+     * @param n 元素个数，不能为0
+     * @return 第一个下标
+     */
+    size_type M_reserve(size_type n) {
+        const size_type first =
+            reserved.fetch_add(n, std::memory_order_relaxed);
+        M_ensure_segments(first, first + n);
+        return first;
+    }
+
+    /**
+     * @brief 保证[first, last)所在的段都已分配
+     * @throw std::length_error 超出段目录能表示的范围
+     */
+    void M_ensure_segments(size_type first, size_type last) {
+        if (last - 1 > std::numeric_limits<size_type>::max() -
+                           Layout::S_first_size) {
+            throw std::length_error("ConcurrentVector: too many elements");
+        }
+        const size_type k_last = S_segment_of(last - 1);
+        for (size_type k = S_segment_of(first); k <= k_last; ++k) {
+            M_ensure_segment(k);
+        }
+    }
+
+    /**
+     * @brief 保证第k段的元素和就绪标记都已分配
+     * @details 两者各自用CAS安装，竞争失败的一方释放自己分配的内存
+     */
+    void M_ensure_segment(size_type k) {
+        const size_type n = Layout::S_segment_size(k);
+        std::atomic<pointer>& data = segments[k];
+        if (data.load(std::memory_order_acquire) == pointer{}) {
+            pointer p = Alloc_traits::allocate(alloc, n);
+            pointer expected{};
+            if (!data.compare_exchange_strong(
+                    expected, p, std::memory_order_acq_rel,
+                    std::memory_order_acquire
+                )) {
+                Alloc_traits::deallocate(alloc, p, n);
+            }
+        }
+        std::atomic<flag_type*>& ready = flags[k];
+        if (ready.load(std::memory_order_acquire) == nullptr) {
+            flag_type* f = Flag_traits::allocate(flag_alloc, n);
+            std::uninitialized_value_construct_n(f, n);
+            flag_type* expected = nullptr;
+            if (!ready.compare_exchange_strong(
+                    expected, f, std::memory_order_acq_rel,
+                    std::memory_order_acquire
+                )) {
+                Flag_traits::deallocate(flag_alloc, f, n);
+            }
+        }
+    }
+
+    /**
+     * @brief 在末尾构造一个元素并发布
+     * @param args 构造函数参数
+     * @return 新元素的下标
+     */
+    template <typename... Args>
+    size_type M_emplace(Args&&... args) {
+        return M_grow(1, [this, &args...](pointer p, size_type) {
+            M_construct(p, std::forward<Args>(args)...);
+        });
+    }
+
+    /**
+     * @brief 预留n个元素，用construct逐个构造后发布
+     * @details 构造函数抛出异常时，剩余的位置都值初始化并发布后再抛出:
+     * 下标已经预留，不放入有效的元素之后的元素就永远无法发布
+     * @param n 元素个数
+     * @param construct 以(元素地址, 在本次追加中的序号)为参数的可调用对象
+     * @return 第一个新元素的下标
+     */
+    template <typename Construct>
+    size_type M_grow(size_type n, const Construct& construct) {
+        if (n == 0) {
+            return size();
+        }
+        const size_type first = M_reserve(n);
+        const size_type last = first + n;
+        size_type i = first;
+        try {
+            M_for_each_run(i, last, [&](pointer p, size_type count) {
+                for (size_type j = 0; j < count; ++j, ++i) {
+                    construct(p + j, i - first);
+                }
+            });
+        } catch (...) {
+            M_for_each_run(i, last, [this](pointer p, size_type count) {
+                for (size_type j = 0; j < count; ++j) {
+                    M_construct(p + j);
+                }
+            });
+            M_publish(first, last);
+            throw;
+        }
+        M_publish(first, last);
+        return first;
+    }
+
+    /**
+     * @brief 对[first, last)在每段中的连续部分调用f
+     * @param f 以(第一个元素的地址, 元素个数)为参数的可调用对象
+     */
+    template <typename F>
+    void M_for_each_run(size_type first, size_type last, F&& f) {
+        while (first != last) {
+            const size_type count = std::min(
+                last - first, Layout::S_capacity(S_segment_of(first) + 1) - first
+            );
+            f(Layout::S_locate(segments.data(), first), count);
+            first += count;
+        }
+    }
+
+    /**
+     * @brief 在p处构造元素
+     */
+    template <typename... Args>
+    void M_construct(pointer p, Args&&... args) {
+        Alloc_traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 发布已构造完成的[first, last)
+     * @details 快速路径:前面的元素都已发布时直接推进published;
+     * 否则为每个元素置位就绪标记。两种情况最后都继续推进published，
+     * 越过之后已就绪的元素。置位与推进都使用seq_cst，保证置位的线程和
+     * 推进到此处的线程至少有一方能看到对方的写入
+     */
+    void M_publish(size_type first, size_type last) noexcept {
+        size_type expected = first;
+        if (published.compare_exchange_strong(
+                expected, last, std::memory_order_seq_cst
+            )) {
+            expected = last;
+        } else {
+            for (size_type i = first; i < last; ++i) {
+                M_flag(i)->store(1, std::memory_order_seq_cst);
+            }
+            expected = published.load(std::memory_order_seq_cst);
+        }
+        for (;;) {
+            size_type end = expected;
+            const size_type limit = reserved.load(std::memory_order_relaxed);
+            while (end < limit && M_is_ready(end)) {
+                ++end;
+            }
+            if (end == expected) {
+                return;
+            }
+            // 失败时expected被更新为当前值，从那里继续
+            if (published.compare_exchange_weak(
+                    expected, end, std::memory_order_seq_cst
+                )) {
+                expected = end;
+            }
+        }
+    }
+
+    /**
+     * @brief 判断第i个元素是否已置位就绪标记
+     */
+    bool M_is_ready(size_type i) const noexcept {
+        const size_type k = S_segment_of(i);
+        flag_type* f = flags[k].load(std::memory_order_acquire);
+        return f != nullptr &&
+               f[i + Layout::S_first_size - Layout::S_segment_size(k)].load(
+                   std::memory_order_seq_cst
+               ) != 0;
+    }
+
+    /**
+     * @brief 获取第i个元素的就绪标记，所在的段必须已分配
+     */
+    flag_type* M_flag(size_type i) const noexcept {
+        const size_type k = S_segment_of(i);
+        return flags[k].load(std::memory_order_relaxed) +
+               (i + Layout::S_first_size - Layout::S_segment_size(k));
+    }
+
+    /**
+     * @brief 获取下标i所在的段
+     */
+    static size_type S_segment_of(size_type i) noexcept {
+        return static_cast<size_type>(
+                   std::bit_width(i + Layout::S_first_size)
+               ) - 1 - Layout::S_first_shift;
+    }
+
+    /**
+     * @brief 检查元素是否已发布
+     * @throw std::out_of_range 下标不小于size()
+     */
+    void M_check_index(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range("ConcurrentVector::at");
+        }
+    }
+
+    [[no_unique_address]] Tp_alloc_type alloc;  // 元素的分配器
+    [[no_unique_address]] Flag_alloc_type flag_alloc{alloc};  // 标记的分配器
+    // 段目录，每项只在安装新段时写入一次
+    alignas(64) std::array<std::atomic<pointer>, Layout::S_max_segments>
+        segments{};
+    // 就绪标记目录
+    std::array<std::atomic<flag_type*>, Layout::S_max_segments> flags{};
+    // 预留和发布的计数器位于不同的缓存行
+    alignas(64) std::atomic<size_type> reserved{0};   // 已预留的元素个数
+    alignas(64) std::atomic<size_type> published{0};  // 已发布的元素个数
+};
+
+}  // namespace user
+
+#endif  // CONCURRENT_VECTOR_HPP
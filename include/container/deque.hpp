@@ -0,0 +1,812 @@
+/* UTF-8 */
+/**
+ * @file deque.hpp
+ * @brief 实现分块存储的双端队列Deque类
+ * @details 元素存放在固定字节数(4KiB)的块中，块指针保存在容量为2的幂的
+ * 环形块目录里。两端插入只需在目录的头或尾加入一个块，目录满时才扩容;
+ * 第i个元素所在的块和块内偏移由移位和掩码算出。
+ * 块的内存来自可替换的块来源(与PoolMemory的PageSource接口相同)，
+ * 配合PooledPageSource可以在内存池中循环使用块;另外保留少量刚释放的块，
+ * 队列在块边界来回时不会反复分配和释放
+ */
+
+#ifndef DEQUE_HPP
+#define DEQUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <my-memory/poolmemory.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @struct DequeBase
+ * @brief Deque的基类，负责块目录和块的分配与释放(不执行构造和析构)
+ * @tparam Tp 对象类型
+ * @tparam Alloc 分配器类型，用于构造元素和分配块目录
+ * @tparam BlockSource 块来源，需要提供allocate(bytes)和deallocate(p, bytes)
+ */
+template <typename Tp, IsAllocator Alloc, typename BlockSource>
+struct DequeBase {
+    // 将内存分配器重绑定类型，保证分配器分配的数值类型与Tp相同
+    using Tp_alloc_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Tp>;
+    // 获取分配器特性类型
+    using Tr = std::allocator_traits<Tp_alloc_type>;
+    // 块目录的分配器类型
+    using Map_alloc_type = typename Tr::template rebind_alloc<Tp*>;
+    // 块目录的分配器特性类型
+    using Map_traits = std::allocator_traits<Map_alloc_type>;
+
+    static_assert(
+        alignof(Tp) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+        "Deque: over-aligned types are not supported by block sources"
+    );
+
+    // 每块元素个数的以2为底的对数，使一块不超过4KiB
+    static constexpr std::size_t S_block_shift =
+        std::bit_width(std::max<std::size_t>(4096 / sizeof(Tp), 1)) - 1;
+    // 每块的元素个数
+    static constexpr std::size_t S_block_size = std::size_t{1}
+                                                << S_block_shift;
+    // 每块的字节数
+    static constexpr std::size_t S_block_bytes = S_block_size * sizeof(Tp);
+    // 最多保留的空闲块数
+    static constexpr std::size_t S_max_spare = 2;
+    // 块目录的最小容量
+    static constexpr std::size_t S_min_map_size = 8;
+
+    // 无状态分配器不占用空间
+    [[no_unique_address]] Tp_alloc_type alloc;
+    [[no_unique_address]] BlockSource source;  // 块来源
+
+    Tp** M_map = nullptr;         // 环形块目录
+    std::size_t M_map_size = 0;   // 块目录的容量，为0或2的幂
+    std::size_t M_head = 0;       // 第一个块在目录中的位置
+    std::size_t M_blocks = 0;     // 正在使用的块数
+    std::size_t M_first = 0;      // 第一个元素在第一个块中的偏移
+    std::size_t M_size = 0;       // 元素个数
+    std::array<Tp*, S_max_spare> M_spare{};  // 保留的空闲块
+    std::size_t M_spare_count = 0;           // 保留的空闲块数
+
+    DequeBase() = default;
+
+    /**
+     * @brief 使用指定的分配器和块来源构造
+     * @param a 分配器
+     * @param source 块来源
+     */
+    DequeBase(const Tp_alloc_type& a, const BlockSource& source)
+        : alloc(a), source(source) {}
+
+    DequeBase(const DequeBase&) = delete;
+    DequeBase& operator=(const DequeBase&) = delete;
+
+    /**
+     * @brief 析构函数，释放所有块和块目录
+     */
+    ~DequeBase() noexcept {
+        for (std::size_t k = 0; k < M_blocks; ++k) {
+            source.deallocate(M_block(k), S_block_bytes);
+        }
+        M_release_spare();
+        if (M_map != nullptr) {
+            Map_alloc_type map_alloc(alloc);
+            Map_traits::deallocate(map_alloc, M_map, M_map_size);
+        }
+    }
+
+    /**
+     * @brief 获取正在使用的第k个块
+     */
+    Tp*& M_block(std::size_t k) const noexcept {
+        return M_map[(M_head + k) & (M_map_size - 1)];
+    }
+
+    /**
+     * @brief 根据下标计算元素的地址
+     * @param i 下标
+     * @return 元素的指针
+     */
+    Tp* M_locate(std::size_t i) const noexcept {
+        const std::size_t pos = M_first + i;
+        return M_block(pos >> S_block_shift) + (pos & (S_block_size - 1));
+    }
+
+    /**
+     * @brief 获取一个块，优先使用保留的空闲块
+     */
+    Tp* M_acquire_block() {
+        if (M_spare_count != 0) {
+            return M_spare[--M_spare_count];
+        }
+        return static_cast<Tp*>(source.allocate(S_block_bytes));
+    }
+
+    /**
+     * @brief 释放一个块，保留的空闲块未满时先保留
+     * @param block 块的首地址
+     */
+    void M_release_block(Tp* block) noexcept {
+        if (M_spare_count != S_max_spare) {
+            M_spare[M_spare_count++] = block;
+        } else {
+            source.deallocate(block, S_block_bytes);
+        }
+    }
+
+    /**
+     * @brief 将保留的空闲块还给块来源
+     */
+    void M_release_spare() noexcept {
+        while (M_spare_count != 0) {
+            source.deallocate(M_spare[--M_spare_count], S_block_bytes);
+        }
+    }
+
+    /**
+     * @brief 保证块目录中至少还有一个空位
+     * @details 目录满时容量加倍，正在使用的块按顺序移到新目录的开头
+     */
+    void M_reserve_map_slot() {
+        if (M_blocks != M_map_size) {
+            return;
+        }
+        const std::size_t len = std::max(S_min_map_size, 2 * M_map_size);
+        Map_alloc_type map_alloc(alloc);
+        Tp** map = Map_traits::allocate(map_alloc, len);
+        for (std::size_t k = 0; k < M_blocks; ++k) {
+            map[k] = M_block(k);
+        }
+        if (M_map != nullptr) {
+            Map_traits::deallocate(map_alloc, M_map, M_map_size);
+        }
+        M_map = map;
+        M_map_size = len;
+        M_head = 0;
+    }
+
+    /**
+     * @brief 交换两个对象的块目录、块和块来源
+     * @param other 另一对象
+     */
+    void M_swap_data(DequeBase& other) noexcept {
+        using std::swap;
+        swap(source, other.source);
+        swap(M_map, other.M_map);
+        swap(M_map_size, other.M_map_size);
+        swap(M_head, other.M_head);
+        swap(M_blocks, other.M_blocks);
+        swap(M_first, other.M_first);
+        swap(M_size, other.M_size);
+        swap(M_spare, other.M_spare);
+        swap(M_spare_count, other.M_spare_count);
+    }
+};
+
+/**
+ * @class DequeIterator
+ * @brief Deque的随机访问迭代器
+ * @details 保存当前元素的指针和所在块的末尾，顺序移动时只有跨过块边界
+ * 才需要查找块目录;比较和求差只使用下标。
+ * 迭代器保存的是块目录本身而不是容器的地址，交换或移动容器后
+ * 迭代器随块目录一起指向另一容器中的同一元素
+ * @tparam Base DequeBase类型
+ * @tparam Const 是否为常量迭代器
+ */
+template <typename Base, bool Const>
+class DequeIterator {
+    using block_pointer = typename Base::Tr::value_type*;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = typename Base::Tr::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<Const, const value_type&, value_type&>;
+
+    DequeIterator() = default;
+
+    /**
+     * @brief 由容器当前的块目录和下标构造
+     */
+    DequeIterator(const Base& deque, std::size_t index)
+        : map(deque.M_map),
+          mask(deque.M_map_size - 1),
+          origin((deque.M_head << Base::S_block_shift) + deque.M_first),
+          size(deque.M_size),
+          index(index) {
+        M_seek();
+    }
+
+    /**
+     * @brief 由非常量迭代器构造常量迭代器
+     */
+    DequeIterator(const DequeIterator<Base, !Const>& other)
+        requires Const
+        : map(other.map),
+          mask(other.mask),
+          origin(other.origin),
+          size(other.size),
+          cur(other.cur),
+          block_end(other.block_end),
+          index(other.index) {}
+
+    reference operator*() const { return *cur; }
+    pointer operator->() const { return cur; }
+    reference operator[](difference_type n) const {
+        return *M_locate(index + n);
+    }
+
+    DequeIterator& operator++() {
+        ++index;
+        if (++cur == block_end) {
+            M_seek();
+        }
+        return *this;
+    }
+    DequeIterator operator++(int) {
+        DequeIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    DequeIterator& operator--() {
+        --index;
+        if (cur == block_end - Base::S_block_size) {
+            M_seek();
+        } else {
+            --cur;
+        }
+        return *this;
+    }
+    DequeIterator operator--(int) {
+        DequeIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+    DequeIterator& operator+=(difference_type n) {
+        index += n;
+        M_seek();
+        return *this;
+    }
+    DequeIterator& operator-=(difference_type n) {
+        index -= n;
+        M_seek();
+        return *this;
+    }
+    friend DequeIterator operator+(DequeIterator it, difference_type n) {
+        return it += n;
+    }
+    friend DequeIterator operator+(difference_type n, DequeIterator it) {
+        return it += n;
+    }
+    friend DequeIterator operator-(DequeIterator it, difference_type n) {
+        return it -= n;
+    }
+    friend difference_type operator-(
+        const DequeIterator& a, const DequeIterator& b
+    ) {
+        return static_cast<difference_type>(a.index - b.index);
+    }
+    friend bool operator==(const DequeIterator& a, const DequeIterator& b) {
+        return a.index == b.index;
+    }
+    friend std::strong_ordering operator<=>(
+        const DequeIterator& a, const DequeIterator& b
+    ) {
+        return a.index <=> b.index;
+    }
+
+private:
+    template <typename, bool>
+    friend class DequeIterator;
+
+    /**
+     * @brief 根据下标计算元素的地址
+     * @param i 下标
+     * @return 元素的指针
+     */
+    block_pointer M_locate(std::size_t i) const noexcept {
+        const std::size_t pos = origin + i;
+        return map[(pos >> Base::S_block_shift) & mask] +
+               (pos & (Base::S_block_size - 1));
+    }
+
+    /**
+     * @brief 根据下标重新计算当前元素的指针和所在块的末尾
+     * @note 尾后迭代器指向最后一个元素之后，不访问目录中未使用的位置
+     */
+    void M_seek() noexcept {
+        if (size == 0) {
+            cur = block_end = nullptr;
+            return;
+        }
+        const std::size_t i = std::min(index, size - 1);
+        const std::size_t offset = (origin + i) & (Base::S_block_size - 1);
+        block_pointer p = M_locate(i);
+        block_end = p - offset + Base::S_block_size;
+        cur = p + (index - i);
+    }
+
+    const block_pointer* map = nullptr;  // 环形块目录
+    std::size_t mask = 0;                // 块目录容量减1
+    std::size_t origin = 0;  // 第一个元素相对于目录起点的位置
+    std::size_t size = 0;    // 构造迭代器时的元素个数
+    block_pointer cur = nullptr;        // 当前元素
+    block_pointer block_end = nullptr;  // 当前元素所在块的末尾
+    std::size_t index = 0;              // 下标
+};
+
+/**
+ * @class Deque
+ * @brief 分块存储的双端队列
+ * @details 两端插入和删除为O(1)，不移动已有元素;随机访问为O(1)。
+ * 任一端插入会使迭代器失效，但指向元素的指针和引用保持有效
+ * @tparam Tp 要存储的数据类型，不可为const或volatile修饰类型
+ * @tparam Alloc 分配器类型，分配的类型需要与Tp相同
+ * @tparam BlockSource 块来源，需要提供allocate(bytes)和deallocate(p, bytes)，
+ * 返回的内存按__STDCPP_DEFAULT_NEW_ALIGNMENT__对齐
+ */
+template <
+    NotConstVolatile Tp, IsAllocator Alloc = Allocator<Tp>,
+    typename BlockSource = NewPageSource>
+    requires SameTypeAlloc<Tp, Alloc>
+class Deque : protected DequeBase<Tp, Alloc, BlockSource> {
+    using Base = DequeBase<Tp, Alloc, BlockSource>;  // 基类
+    using Tp_alloc_type = typename Base::Tp_alloc_type;
+    using Alloc_traits = typename Base::Tr;          // 分配器特性
+
+public:
+    using value_type = Tp;                                 // 数值类型
+    using pointer = Tp*;                                   // 指针类型
+    using const_pointer = const Tp*;                       // 常量指针类型
+    using reference = Tp&;                                 // 引用类型
+    using const_reference = const Tp&;                     // 常量引用类型
+    using iterator = DequeIterator<Base, false>;           // 迭代器
+    using const_iterator = DequeIterator<Base, true>;      // 常量迭代器
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using size_type = std::size_t;           // 元素个数类型
+    using difference_type = std::ptrdiff_t;  // 迭代器差值类型
+    using allocator_type = Alloc;            // 分配器类型
+    using block_source_type = BlockSource;   // 块来源类型
+
+    // 每块的元素个数
+    static constexpr size_type block_size = Base::S_block_size;
+
+    Deque() = default;
+
+    /**
+     * @brief 使用指定的块来源构造空容器
+     * @param source 块来源
+     * @param a 分配器
+     */
+    explicit Deque(
+        const BlockSource& source, const allocator_type& a = allocator_type()
+    )
+        : Base(a, source) {}
+
+    /**
+     * @brief 构造n个值初始化的元素
+     * @param n 元素个数
+     */
+    explicit Deque(size_type n) {
+        try {
+            resize(n);
+        } catch (...) {
+            // 析构已构造的元素，块由基类析构函数释放
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 构造n个value
+     * @param n 元素个数
+     * @param value 元素的值
+     */
+    Deque(size_type n, const value_type& value) {
+        try {
+            for (size_type i = 0; i < n; ++i) {
+                emplace_back(value);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 根据迭代器范围构造
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     */
+    template <std::input_iterator InputIt>
+    Deque(InputIt first, InputIt last) {
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 根据初始化列表构造
+     * @param l 初始化列表
+     */
+    Deque(std::initializer_list<value_type> l) : Deque(l.begin(), l.end()) {}
+
+    /**
+     * @brief 复制构造函数，使用相同的块来源
+     * @param other 需要复制的Deque
+     */
+    Deque(const Deque& other)
+        : Base(
+              Alloc_traits::select_on_container_copy_construction(other.alloc),
+              other.source
+          ) {
+        try {
+            other.for_each_segment([this](const value_type* p, size_type n) {
+                for (size_type i = 0; i < n; ++i) {
+                    emplace_back(p[i]);
+                }
+            });
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 移动构造函数，直接接管块目录和块
+     * @param other 右值Deque
+     */
+    Deque(Deque&& other) noexcept : Base(other.alloc, other.source) {
+        this->M_swap_data(other);
+    }
+
+    /**
+     * @brief 析构函数，析构所有元素
+     */
+    ~Deque() noexcept { M_destroy_all(); }
+
+    /**
+     * @brief 复制赋值运算符
+     * @param other 另一Deque
+     * @return 当前对象的引用
+     */
+    Deque& operator=(const Deque& other) {
+        if (this != std::addressof(other)) {
+            Deque tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 移动赋值运算符，交换两个容器的内容
+     * @param other 另一右值Deque
+     * @return 当前对象的引用
+     */
+    Deque& operator=(Deque&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    /**
+     * @brief 交换两个容器的内容
+     * @param other 另一Deque
+     * @note 块来源随块一起交换
+     */
+    void swap(Deque& other) noexcept {
+        this->M_swap_data(other);
+        if constexpr (Alloc_traits::propagate_on_container_swap::value ||
+                      Alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            std::swap(this->alloc, other.alloc);
+        }
+    }
+
+    /**
+     * @brief 获取容器的分配器
+     */
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(this->alloc);
+    }
+
+    /**
+     * @brief 获取容器的块来源
+     */
+    [[nodiscard]] const block_source_type& get_block_source() const noexcept {
+        return this->source;
+    }
+
+    /**
+     * @brief 按下标访问元素
+     * @param i 下标，必须小于size()
+     */
+    [[nodiscard]] reference operator[](size_type i) noexcept {
+        return *this->M_locate(i);
+    }
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return *this->M_locate(i);
+    }
+
+    /**
+     * @brief 按下标访问元素并检查范围
+     * @param i 下标
+     * @throw std::out_of_range 下标不小于size()
+     */
+    [[nodiscard]] reference at(size_type i) {
+        M_check_index(i);
+        return (*this)[i];
+    }
+    [[nodiscard]] const_reference at(size_type i) const {
+        M_check_index(i);
+        return (*this)[i];
+    }
+
+    [[nodiscard]] reference front() noexcept { return (*this)[0]; }
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+    [[nodiscard]] reference back() noexcept { return (*this)[size() - 1]; }
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(*this, 0); }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(*this, 0);
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator(*this, this->M_size);
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(*this, this->M_size);
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+    [[nodiscard]] reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 获取元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept { return this->M_size; }
+
+    /**
+     * @brief 判断容器是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept { return this->M_size == 0; }
+
+    /**
+     * @brief 在末尾构造新元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        const size_type end = this->M_first + this->M_size;
+        if (this->M_size == 0 || (end & (block_size - 1)) == 0) {
+            // 最后一个块已满(或没有块)，在目录尾部加入新块
+            this->M_reserve_map_slot();
+            Tp* block = this->M_acquire_block();
+            if (this->M_size == 0) {
+                this->M_first = 0;
+            }
+            this->M_block(this->M_blocks) = block;
+            ++this->M_blocks;
+            try {
+                Alloc_traits::construct(
+                    this->alloc, block, std::forward<Args>(args)...
+                );
+            } catch (...) {
+                --this->M_blocks;
+                this->M_release_block(block);
+                throw;
+            }
+            ++this->M_size;
+            return *block;
+        }
+        Tp* p = this->M_locate(this->M_size);
+        Alloc_traits::construct(this->alloc, p, std::forward<Args>(args)...);
+        ++this->M_size;
+        return *p;
+    }
+
+    /**
+     * @brief 在开头构造新元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     */
+    template <typename... Args>
+    reference emplace_front(Args&&... args) {
+        if (this->M_size == 0 || this->M_first == 0) {
+            // 第一个块前面没有空位(或没有块)，在目录头部加入新块
+            this->M_reserve_map_slot();
+            Tp* block = this->M_acquire_block();
+            Tp* p = block + (block_size - 1);
+            try {
+                Alloc_traits::construct(
+                    this->alloc, p, std::forward<Args>(args)...
+                );
+            } catch (...) {
+                this->M_release_block(block);
+                throw;
+            }
+            this->M_head = (this->M_head - 1) & (this->M_map_size - 1);
+            this->M_block(0) = block;
+            ++this->M_blocks;
+            this->M_first = block_size - 1;
+            ++this->M_size;
+            return *p;
+        }
+        Tp* p = this->M_locate(0) - 1;
+        Alloc_traits::construct(this->alloc, p, std::forward<Args>(args)...);
+        --this->M_first;
+        ++this->M_size;
+        return *p;
+    }
+
+    /**
+     * @brief 在末尾插入元素
+     * @param value 元素的值
+     */
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+    /**
+     * @brief 在开头插入元素
+     * @param value 元素的值
+     */
+    void push_front(const value_type& value) { emplace_front(value); }
+    void push_front(value_type&& value) { emplace_front(std::move(value)); }
+
+    /**
+     * @brief 删除最后一个元素
+     * @note 容器不能为空，空出的块会被释放
+     */
+    void pop_back() noexcept {
+        --this->M_size;
+        Alloc_traits::destroy(this->alloc, this->M_locate(this->M_size));
+        const size_type end = this->M_first + this->M_size;
+        if (this->M_size == 0 || (end & (block_size - 1)) == 0) {
+            --this->M_blocks;
+            this->M_release_block(this->M_block(this->M_blocks));
+        }
+    }
+
+    /**
+     * @brief 删除第一个元素
+     * @note 容器不能为空，空出的块会被释放
+     */
+    void pop_front() noexcept {
+        Alloc_traits::destroy(this->alloc, this->M_locate(0));
+        --this->M_size;
+        ++this->M_first;
+        if (this->M_size == 0) {
+            --this->M_blocks;
+            this->M_release_block(this->M_block(0));
+            this->M_first = 0;
+        } else if (this->M_first == block_size) {
+            this->M_release_block(this->M_block(0));
+            this->M_head = (this->M_head + 1) & (this->M_map_size - 1);
+            --this->M_blocks;
+            this->M_first = 0;
+        }
+    }
+
+    /**
+     * @brief 调整元素个数，新增的元素值初始化
+     * @param n 新的元素个数
+     */
+    void resize(size_type n) {
+        while (this->M_size > n) {
+            pop_back();
+        }
+        while (this->M_size < n) {
+            emplace_back();
+        }
+    }
+
+    /**
+     * @brief 析构所有元素并释放所有块，保留块目录
+     */
+    void clear() noexcept {
+        M_destroy_all();
+        for (size_type k = 0; k < this->M_blocks; ++k) {
+            this->M_release_block(this->M_block(k));
+        }
+        this->M_blocks = 0;
+        this->M_first = 0;
+        this->M_size = 0;
+    }
+
+    /**
+     * @brief 将保留的空闲块还给块来源
+     */
+    void shrink_to_fit() noexcept { this->M_release_spare(); }
+
+    /**
+     * @brief 对每一块中连续存放的元素调用f
+     * @param f 以(指向第一个元素的指针, 元素个数)为参数的可调用对象
+     * @note 用于需要连续内存的批量处理(如向量化)
+     */
+    template <typename F>
+    void for_each_segment(F&& f) {
+        M_for_each_segment(f);
+    }
+    template <typename F>
+    void for_each_segment(F&& f) const {
+        M_for_each_segment(
+            [&f](const Tp* p, size_type n) { f(p, n); }
+        );
+    }
+
+private:
+    /**
+     * @brief 对每一块中连续存放的元素调用f
+     * @param f 以(指向第一个元素的指针, 元素个数)为参数的可调用对象
+     */
+    template <typename F>
+    void M_for_each_segment(F&& f) const {
+        size_type offset = this->M_first;
+        size_type remaining = this->M_size;
+        for (size_type k = 0; remaining != 0; ++k) {
+            const size_type count = std::min(remaining, block_size - offset);
+            f(this->M_block(k) + offset, count);
+            remaining -= count;
+            offset = 0;
+        }
+    }
+
+    /**
+     * @brief 析构所有元素，不释放块
+     */
+    void M_destroy_all() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Tp>) {
+            M_for_each_segment([](Tp* p, size_type n) { std::destroy_n(p, n); });
+        }
+    }
+
+    /**
+     * @brief 检查下标是否有效
+     * @throw std::out_of_range 下标不小于size()
+     */
+    void M_check_index(size_type i) const {
+        if (i >= this->M_size) {
+            throw std::out_of_range("Deque::at");
+        }
+    }
+};
+
+}  // namespace user
+
+#endif  // DEQUE_HPP
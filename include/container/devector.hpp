@@ -0,0 +1,748 @@
+/* UTF-8 */
+/**
+ * @file devector.hpp
+ * @brief 实现两端都可以高效插入删除的连续数组Devector
+ * @details 在VectorBase的基础上增加指向第一个元素的指针M_begin，
+ * [M_start, M_begin)为前端的空闲空间，[M_finish, M_end_of_shorage)为后端的
+ * 空闲空间。某一端没有空间时，若总的空闲空间不少于元素个数，则在原内存中将
+ * 元素移到中间(重新居中)，否则分配更大的内存，元素同样放在中间。
+ * 每次重新居中至少留出(容量 - 元素个数) / 2个空位，两端的插入均摊O(1)
+ */
+
+#ifndef DEVECTOR_HPP
+#define DEVECTOR_HPP
+
+#include <algorithm>
+#include <container/vectorbase.hpp>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <small-utility/smallutility.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @struct DevectorBase
+ * @brief Devector的基类，在VectorBase的基础上记录第一个元素的位置
+ * @details 继承自VectorBase的M_start与M_end_of_shorage仍表示整块内存，
+ * 因此VectorBase的析构函数能正确释放内存
+ * @tparam Tp 对象类型
+ * @tparam Alloc 分配器类型
+ */
+template <typename Tp, IsAllocator Alloc>
+struct DevectorBase : VectorBase<Tp, Alloc> {
+    using Base = VectorBase<Tp, Alloc>;
+    using typename Base::pointer;
+    using typename Base::Tp_alloc_type;
+
+    pointer M_begin;  // 指向第一个元素的指针
+
+    constexpr DevectorBase() noexcept : M_begin() {}
+
+    /**
+     * @brief 使用指定的分配器构造
+     * @param a 分配器
+     */
+    constexpr explicit DevectorBase(const Tp_alloc_type& a) noexcept
+        : Base(a), M_begin() {}
+
+    /**
+     * @brief 使用指定的分配器分配n个元素的内存，元素从内存起点开始存放
+     * @param n 元素个数
+     * @param a 分配器
+     */
+    constexpr DevectorBase(std::size_t n, const Tp_alloc_type& a)
+        : Base(a), M_begin() {
+        this->M_start = this->M_allocate(n);
+        this->M_begin = this->M_finish = this->M_start;
+        this->M_end_of_shorage = this->M_start + n;
+    }
+
+    /**
+     * @brief 移动构造函数，接管内存
+     */
+    constexpr DevectorBase(DevectorBase&& other) noexcept
+        : Base(std::move(other)), M_begin(other.M_begin) {
+        other.M_begin = pointer{};
+    }
+
+    /**
+     * @brief 交换两个对象的内存
+     * @param other 另一对象
+     */
+    constexpr void M_swap_data(DevectorBase& other) noexcept {
+        Base::M_swap_data(other);
+        std::swap(M_begin, other.M_begin);
+    }
+};
+
+/**
+ * @class Devector
+ * @brief 两端都可以均摊O(1)插入删除的连续数组
+ * @tparam Tp 要存储的数据类型，不可为const或volatile修饰类型
+ * @tparam Alloc 分配器类型，分配的类型需要与Tp相同
+ */
+template <NotConstVolatile Tp, IsAllocator Alloc = std::allocator<Tp>>
+    requires SameTypeAlloc<Tp, Alloc>
+class Devector : protected DevectorBase<Tp, Alloc> {
+    using Base = DevectorBase<Tp, Alloc>;                // 基类
+    using Tp_alloc_type = typename Base::Tp_alloc_type;  // 分配器类型
+    using Alloc_traits = std::allocator_traits<Tp_alloc_type>;
+
+    // 移动不抛出异常时才在原内存中重新居中，否则改为重新分配，
+    // 保证移动中途失败时容器不变
+    static constexpr bool S_shift_in_place =
+        std::is_nothrow_move_constructible_v<Tp> &&
+        std::is_nothrow_move_assignable_v<Tp>;
+
+public:
+    using value_type = Tp;                                       // 数值类型
+    using pointer = typename Base::pointer;                      // 指针类型
+    using const_pointer = typename Alloc_traits::const_pointer;  // 常量指针类型
+    using reference = Tp&;                                       // 引用类型
+    using const_reference = const Tp&;                 // 常量引用类型
+    using iterator = pointer;                          // 迭代器类型
+    using const_iterator = const_pointer;              // 常量迭代器
+    using reverse_iterator = std::reverse_iterator<pointer>;  // 反向迭代器
+    using const_reverse_iterator =
+        std::reverse_iterator<const_pointer>;  // 反向常量迭代器
+    using size_type = std::size_t;             // 元素个数类型
+    using difference_type = std::ptrdiff_t;    // 迭代器差值类型
+    using allocator_type = Alloc;              // 分配器类型
+
+    Devector() = default;
+
+    /**
+     * @brief 使用指定的分配器构造空容器
+     * @param a 分配器
+     */
+    explicit Devector(const allocator_type& a) noexcept : Base(a) {}
+
+    /**
+     * @brief 构造n个默认初始化的元素
+     * @param n 元素个数
+     * @param a 分配器
+     */
+    explicit Devector(size_type n, const allocator_type& a = allocator_type())
+        : Base(S_check_init_len(n), a) {
+        this->M_finish = std::uninitialized_default_construct_n(
+            this->M_begin, n
+        );
+    }
+
+    /**
+     * @brief 构造n个value
+     * @param n 元素个数
+     * @param value 元素的值
+     * @param a 分配器
+     */
+    Devector(
+        size_type n, const value_type& value,
+        const allocator_type& a = allocator_type()
+    )
+        : Base(S_check_init_len(n), a) {
+        this->M_finish = std::uninitialized_fill_n(this->M_begin, n, value);
+    }
+
+    /**
+     * @brief 根据迭代器范围构造
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     */
+    template <std::input_iterator InputIterator>
+    Devector(InputIterator first, InputIterator last) {
+        if constexpr (std::forward_iterator<InputIterator>) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            M_reallocate(S_check_init_len(n), 0);
+            this->M_finish =
+                std::uninitialized_copy(first, last, this->M_begin);
+        } else {
+            try {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief 根据初始化列表构造
+     * @param l 初始化列表
+     */
+    Devector(std::initializer_list<value_type> l)
+        : Devector(l.begin(), l.end()) {}
+
+    /**
+     * @brief 复制构造函数，元素从内存起点开始存放
+     * @param other 需要复制的Devector
+     */
+    Devector(const Devector& other)
+        : Base(
+              other.size(), Alloc_traits::select_on_container_copy_construction(
+                                other.M_get_Tp_allocator()
+                            )
+          ) {
+        this->M_finish =
+            std::uninitialized_copy(other.begin(), other.end(), this->M_begin);
+    }
+
+    /**
+     * @brief 移动构造函数
+     * @param other 右值Devector
+     */
+    Devector(Devector&& other) noexcept : Base(std::move(other)) {}
+
+    /**
+     * @brief 析构函数，析构所有元素
+     */
+    ~Devector() noexcept { std::destroy(this->M_begin, this->M_finish); }
+
+    /**
+     * @brief 复制赋值运算符
+     * @param other 另一Devector
+     * @return 当前对象的引用
+     */
+    Devector& operator=(const Devector& other) {
+        if (this != std::addressof(other)) {
+            Devector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 移动赋值运算符
+     * @param other 另一右值Devector
+     * @return 当前对象的引用
+     */
+    Devector& operator=(Devector&& other) noexcept {
+        this->M_swap_data(other);
+        // 分配器需要跟随内存一起转移
+        if constexpr (Alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            std::swap(this->M_get_Tp_allocator(), other.M_get_Tp_allocator());
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 交换两个容器的内容
+     * @param other 另一Devector
+     * @note 分配器只在propagate_on_container_swap为true时交换
+     */
+    void swap(Devector& other) noexcept {
+        this->M_swap_data(other);
+        if constexpr (Alloc_traits::propagate_on_container_swap::value) {
+            std::swap(this->M_get_Tp_allocator(), other.M_get_Tp_allocator());
+        }
+    }
+
+    /**
+     * @brief 获取容器的分配器
+     */
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(this->M_get_Tp_allocator());
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return this->M_begin; }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return this->M_begin;
+    }
+    [[nodiscard]] iterator end() noexcept { return this->M_finish; }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return this->M_finish;
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+    [[nodiscard]] reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 获取指向第一个元素的指针，元素连续存放
+     */
+    [[nodiscard]] pointer data() noexcept { return this->M_begin; }
+    [[nodiscard]] const_pointer data() const noexcept { return this->M_begin; }
+
+    /**
+     * @brief 按下标访问元素
+     * @param i 下标，必须小于size()
+     */
+    [[nodiscard]] reference operator[](size_type i) noexcept {
+        return this->M_begin[i];
+    }
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return this->M_begin[i];
+    }
+
+    /**
+     * @brief 按下标访问元素并检查范围
+     * @param i 下标
+     * @throw std::out_of_range 下标不小于size()
+     */
+    [[nodiscard]] reference at(size_type i) {
+        M_check_index(i);
+        return this->M_begin[i];
+    }
+    [[nodiscard]] const_reference at(size_type i) const {
+        M_check_index(i);
+        return this->M_begin[i];
+    }
+
+    [[nodiscard]] reference front() noexcept { return *this->M_begin; }
+    [[nodiscard]] const_reference front() const noexcept {
+        return *this->M_begin;
+    }
+    [[nodiscard]] reference back() noexcept { return *(this->M_finish - 1); }
+    [[nodiscard]] const_reference back() const noexcept {
+        return *(this->M_finish - 1);
+    }
+
+    /**
+     * @brief 获取元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return this->M_finish - this->M_begin;
+    }
+
+    /**
+     * @brief 判断容器是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        return this->M_begin == this->M_finish;
+    }
+
+    /**
+     * @brief 获取整块内存能容纳的元素个数
+     */
+    [[nodiscard]] size_type capacity() const noexcept {
+        return this->M_end_of_shorage - this->M_start;
+    }
+
+    /**
+     * @brief 获取不移动元素时前端还能插入的元素个数
+     */
+    [[nodiscard]] size_type front_free_capacity() const noexcept {
+        return this->M_begin - this->M_start;
+    }
+
+    /**
+     * @brief 获取不移动元素时后端还能插入的元素个数
+     */
+    [[nodiscard]] size_type back_free_capacity() const noexcept {
+        return this->M_end_of_shorage - this->M_finish;
+    }
+
+    /**
+     * @brief 获取最多可以容纳的元素个数
+     */
+    [[nodiscard]] size_type max_size() const noexcept {
+        return S_max_size();
+    }
+
+    /**
+     * @brief 预留至少n个元素的总容量，元素放在新内存的中间
+     * @param n 需要的容量
+     */
+    void reserve(size_type n) {
+        if (n > capacity()) {
+            M_reallocate(S_check_init_len(n), (n - size()) / 2);
+        }
+    }
+
+    /**
+     * @brief 保证前端至少有n个空位
+     * @param n 空位个数
+     */
+    void reserve_front(size_type n) {
+        if (n > front_free_capacity()) {
+            M_reallocate(
+                S_check_init_len(M_add(n, size() + back_free_capacity())), n
+            );
+        }
+    }
+
+    /**
+     * @brief 保证后端至少有n个空位
+     * @param n 空位个数
+     */
+    void reserve_back(size_type n) {
+        if (n > back_free_capacity()) {
+            M_reallocate(
+                S_check_init_len(M_add(n, size() + front_free_capacity())),
+                front_free_capacity()
+            );
+        }
+    }
+
+    /**
+     * @brief 释放两端所有的空闲空间
+     */
+    void shrink_to_fit() {
+        if (capacity() != size()) {
+            M_reallocate(size(), 0);
+        }
+    }
+
+    /**
+     * @brief 在末尾构造新元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (this->M_finish != this->M_end_of_shorage) {
+            Alloc_traits::construct(
+                this->M_get_Tp_allocator(), this->M_finish,
+                std::forward<Args>(args)...
+            );
+            ++this->M_finish;
+        } else {
+            M_make_room_and_emplace<false>(std::forward<Args>(args)...);
+        }
+        return back();
+    }
+
+    /**
+     * @brief 在开头构造新元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     */
+    template <typename... Args>
+    reference emplace_front(Args&&... args) {
+        if (this->M_begin != this->M_start) {
+            Alloc_traits::construct(
+                this->M_get_Tp_allocator(), this->M_begin - 1,
+                std::forward<Args>(args)...
+            );
+            --this->M_begin;
+        } else {
+            M_make_room_and_emplace<true>(std::forward<Args>(args)...);
+        }
+        return front();
+    }
+
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+    void push_front(const value_type& value) { emplace_front(value); }
+    void push_front(value_type&& value) { emplace_front(std::move(value)); }
+
+    /**
+     * @brief 删除最后一个元素
+     * @note 容器不能为空
+     */
+    void pop_back() noexcept {
+        --this->M_finish;
+        Alloc_traits::destroy(this->M_get_Tp_allocator(), this->M_finish);
+        M_recenter_if_empty();
+    }
+
+    /**
+     * @brief 删除第一个元素
+     * @note 容器不能为空
+     */
+    void pop_front() noexcept {
+        Alloc_traits::destroy(this->M_get_Tp_allocator(), this->M_begin);
+        ++this->M_begin;
+        M_recenter_if_empty();
+    }
+
+    /**
+     * @brief 删除一个元素
+     * @param pos 要删除的元素
+     * @return 被删除元素之后的元素
+     */
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    /**
+     * @brief 删除[first, last)中的元素，移动两侧中元素较少的一侧
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @return 被删除的元素之后的元素
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        const pointer f = this->M_begin + (first - cbegin());
+        const pointer l = this->M_begin + (last - cbegin());
+        if (f == l) {
+            return l;
+        }
+        if (f - this->M_begin < this->M_finish - l) {
+            // 前侧较短，将前侧向后移动
+            const pointer new_begin = std::move_backward(this->M_begin, f, l);
+            std::destroy(this->M_begin, new_begin);
+            this->M_begin = new_begin;
+            M_recenter_if_empty();
+            return l;
+        }
+        const pointer new_finish = std::move(l, this->M_finish, f);
+        std::destroy(new_finish, this->M_finish);
+        this->M_finish = new_finish;
+        M_recenter_if_empty();
+        return f;
+    }
+
+    /**
+     * @brief 调整元素个数，在后端增加或删除元素
+     * @param n 新的元素个数，新增元素值初始化
+     */
+    void resize(size_type n) {
+        if (n <= size()) {
+            const pointer new_finish = this->M_begin + n;
+            std::destroy(new_finish, this->M_finish);
+            this->M_finish = new_finish;
+            return;
+        }
+        const size_type extra = n - size();
+        if (extra > back_free_capacity()) {
+            // 新容量只按元素个数计算，不能保留原来的前端空位，
+            // 与reserve相同将n个元素放在新内存的中间
+            const size_type len = M_check_len(extra, "Devector::resize");
+            M_reallocate(len, (len - n) / 2);
+        }
+        this->M_finish =
+            std::uninitialized_value_construct_n(this->M_finish, extra);
+    }
+
+    /**
+     * @brief 删除所有元素，之后两端各有一半的空位
+     */
+    void clear() noexcept {
+        std::destroy(this->M_begin, this->M_finish);
+        this->M_finish = this->M_begin;
+        M_recenter_if_empty();
+    }
+
+private:
+    /**
+     * @brief 容器为空时将首尾指针放到内存中间，两端都留出空位
+     */
+    void M_recenter_if_empty() noexcept {
+        if (this->M_begin == this->M_finish) {
+            this->M_begin = this->M_finish = this->M_start + capacity() / 2;
+        }
+    }
+
+    /**
+     * @brief 某一端没有空位时腾出空间并在该端构造新元素
+     * @tparam Front 是否在前端插入
+     * @param args 构造函数参数
+     */
+    template <bool Front, typename... Args>
+    void M_make_room_and_emplace(Args&&... args) {
+        const size_type n = size();
+        // 新的前端空位数，两端的空位各占一半
+        auto front_gap = [n](size_type capacity) {
+            return (capacity - n - 1) / 2 + (Front ? 1 : 0);
+        };
+        if constexpr (S_shift_in_place) {
+            // 空位不少于元素个数时，重新居中后被填满的一端至少有n / 2个空位
+            if (capacity() > n && capacity() - n >= n) {
+                // 参数可能引用容器中的元素，先构造再移动元素
+                value_type tmp(std::forward<Args>(args)...);
+                M_shift(this->M_start + front_gap(capacity()));
+                M_emplace_at_end<Front>(std::move(tmp));
+                return;
+            }
+        }
+        const size_type len = M_check_len(1, "Devector::emplace");
+        const pointer new_start = this->M_allocate(len);
+        const pointer new_begin = new_start + front_gap(len);
+        const pointer slot = Front ? new_begin - 1 : new_begin + n;
+        try {
+            Alloc_traits::construct(
+                this->M_get_Tp_allocator(), slot, std::forward<Args>(args)...
+            );
+        } catch (...) {
+            this->M_deallocate(new_start, len);
+            throw;
+        }
+        try {
+            uninitialized_move_or_copy(
+                this->M_begin, this->M_finish, new_begin
+            );
+        } catch (...) {
+            Alloc_traits::destroy(this->M_get_Tp_allocator(), slot);
+            this->M_deallocate(new_start, len);
+            throw;
+        }
+        M_replace_storage(new_start, len, new_begin);
+        if constexpr (Front) {
+            this->M_begin = slot;
+        } else {
+            ++this->M_finish;
+        }
+    }
+
+    /**
+     * @brief 在已有空位的一端构造新元素
+     */
+    template <bool Front>
+    void M_emplace_at_end(value_type&& value) {
+        if constexpr (Front) {
+            Alloc_traits::construct(
+                this->M_get_Tp_allocator(), this->M_begin - 1, std::move(value)
+            );
+            --this->M_begin;
+        } else {
+            Alloc_traits::construct(
+                this->M_get_Tp_allocator(), this->M_finish, std::move(value)
+            );
+            ++this->M_finish;
+        }
+    }
+
+    /**
+     * @brief 在原内存中将所有元素移到new_begin开始的位置
+     * @param new_begin 新的起点，移动后的元素不能超出内存
+     * @note 只在元素的移动不抛出异常时使用
+     */
+    void M_shift(pointer new_begin) noexcept {
+        const pointer first = this->M_begin;
+        const pointer last = this->M_finish;
+        const size_type n = last - first;
+        if (new_begin == first) {
+            return;
+        }
+        if constexpr (std::is_trivially_copyable_v<Tp>) {
+            if (n != 0) {
+                std::memmove(
+                    static_cast<void*>(std::to_address(new_begin)),
+                    static_cast<const void*>(std::to_address(first)),
+                    n * sizeof(Tp)
+                );
+            }
+        } else if (new_begin < first) {
+            // 向前移动:目标的前k个位置未构造，其余位置与原区间重叠
+            const size_type k = std::min<size_type>(first - new_begin, n);
+            std::uninitialized_move(first, first + k, new_begin);
+            std::move(first + k, last, new_begin + k);
+            std::destroy(std::max(new_begin + n, first), last);
+        } else {
+            // 向后移动:目标的后k个位置未构造
+            const size_type k = std::min<size_type>(new_begin - first, n);
+            std::uninitialized_move(last - k, last, new_begin + (n - k));
+            std::move_backward(first, last - k, new_begin + (n - k));
+            std::destroy(first, std::min(new_begin, last));
+        }
+        this->M_begin = new_begin;
+        this->M_finish = new_begin + n;
+    }
+
+    /**
+     * @brief 将元素搬到容量为len的新内存中，前端留出front_gap个空位
+     * @param len 新的容量
+     * @param front_gap 前端的空位个数
+     */
+    void M_reallocate(size_type len, size_type front_gap) {
+        const pointer new_start = this->M_allocate(len);
+        const pointer new_begin = new_start + front_gap;
+        try {
+            uninitialized_move_or_copy(
+                this->M_begin, this->M_finish, new_begin
+            );
+        } catch (...) {
+            this->M_deallocate(new_start, len);
+            throw;
+        }
+        M_replace_storage(new_start, len, new_begin);
+    }
+
+    /**
+     * @brief 析构原有元素，释放原来的内存并换为新内存
+     * @param new_start 新内存的起点
+     * @param len 新内存的容量
+     * @param new_begin 新内存中第一个元素的位置，size()个元素已构造
+     */
+    void M_replace_storage(
+        pointer new_start, size_type len, pointer new_begin
+    ) noexcept {
+        const size_type n = size();
+        std::destroy(this->M_begin, this->M_finish);
+        this->M_deallocate(this->M_start, capacity());
+        this->M_start = new_start;
+        this->M_begin = new_begin;
+        this->M_finish = new_begin + n;
+        this->M_end_of_shorage = new_start + len;
+    }
+
+    /**
+     * @brief 计算需要增加n个元素时新的容量
+     * @param n 需要增加的元素个数
+     * @param s 调用函数名
+     * @throw std::length_error 超出max_size()
+     * @return 新的容量，至少为原来元素个数的两倍
+     */
+    size_type M_check_len(size_type n, const char* s) const {
+        if (max_size() - size() < n) {
+            throw std::length_error(s);
+        }
+        const size_type len = size() + std::max(size(), n);
+        return (len < size() || len > max_size()) ? max_size() : len;
+    }
+
+    /**
+     * @brief 计算a + b，溢出时抛出异常
+     * @throw std::length_error 结果溢出
+     */
+    static size_type M_add(size_type a, size_type b) {
+        if (a > std::numeric_limits<size_type>::max() - b) {
+            throw std::length_error("Devector: size overflow");
+        }
+        return a + b;
+    }
+
+    /**
+     * @brief 检查下标是否有效
+     * @throw std::out_of_range 下标不小于size()
+     */
+    void M_check_index(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range("Devector::at");
+        }
+    }
+
+    /**
+     * @brief 判断初始长度是否可行
+     * @throw std::length_error 超出最大可分配数目
+     */
+    static size_type S_check_init_len(size_type n) {
+        if (n > S_max_size()) {
+            throw std::length_error(
+                "cannot create user::Devector larger than max_size()"
+            );
+        }
+        return n;
+    }
+
+    /**
+     * @brief 计算分配器可分配的元素的最大数量
+     */
+    static constexpr size_type S_max_size() noexcept {
+        const size_type diffmax =
+            std::numeric_limits<std::ptrdiff_t>::max() / sizeof(Tp);
+        const size_type allocmax = Alloc_traits::max_size(Tp_alloc_type{});
+        return std::min(diffmax, allocmax);
+    }
+};
+
+}  // namespace user
+
+#endif  // DEVECTOR_HPP
@@ -0,0 +1,1519 @@
+/* UTF-8 */
+/**
+ * @file flat-hash-map.hpp
+ * @brief user::FlatHashMap和user::FlatHashSet，开放寻址的扁平哈希表
+ * @details 元素直接存放在一个数组中，另有一个与之对应的控制字节数组:
+ * 空位为0x80，有元素的位置保存哈希值的低7位(H2)。查找从哈希值其余部分(H1)
+ * 决定的位置开始，一次读取一组(SSE2为16个、AVX2为32个)控制字节与H2比较，
+ * 只对匹配的位置比较键，绝大多数查找只访问一组控制字节和一个元素。
+ * 探测按位置线性进行，删除时把后面可以前移的元素依次前移(backward shift)，
+ * 表中没有墓碑，反复插入删除之后查找也不会变慢。
+ * 组宽在编译时由-mavx2/-msse2等选项决定，没有使用simd.hpp中的运行时分发:
+ * 组宽决定了控制字节数组末尾镜像的长度和最小容量，属于表的内存布局，
+ * 且每次探测只比较一组，分发的开销会超过比较本身
+ */
+
+#ifndef FLAT_HASH_MAP_HPP
+#define FLAT_HASH_MAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace user {
+
+/**
+ * @class FlatHashBitMask
+ * @brief 一组控制字节的匹配结果
+ * @details 组内第k个位置匹配时，第(k << Shift)位为1
+ * @tparam Word 保存结果的整数类型
+ * @tparam Shift 每个位置占用的位数的对数
+ */
+template <typename Word, int Shift>
+class FlatHashBitMask {
+public:
+    explicit constexpr FlatHashBitMask(Word mask) noexcept : mask(mask) {}
+
+    /**
+     * @brief 判断是否有匹配的位置
+     */
+    explicit constexpr operator bool() const noexcept { return mask != 0; }
+
+    /**
+     * @brief 获取第一个匹配的位置在组内的下标
+     */
+    [[nodiscard]] constexpr std::size_t lowest() const noexcept {
+        return static_cast<std::size_t>(std::countr_zero(mask)) >> Shift;
+    }
+
+    /**
+     * @brief 去掉第一个匹配的位置
+     */
+    constexpr void clear_lowest() noexcept { mask &= mask - 1; }
+
+private:
+    Word mask;  // 匹配结果
+};
+
+#if defined(__AVX2__)
+/**
+ * @struct FlatHashGroupAvx2
+ * @brief 使用AVX2一次比较32个控制字节
+ */
+struct FlatHashGroupAvx2 {
+    static constexpr std::size_t width = 32;  // 每组的控制字节数
+
+    explicit FlatHashGroupAvx2(const std::uint8_t* p) noexcept
+        : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+    /**
+     * @brief 获取控制字节等于h2的位置
+     */
+    [[nodiscard]] FlatHashBitMask<std::uint32_t, 0> match(
+        std::uint8_t h2
+    ) const noexcept {
+        const __m256i eq =
+            _mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(static_cast<char>(h2)));
+        return FlatHashBitMask<std::uint32_t, 0>(
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(eq))
+        );
+    }
+
+    /**
+     * @brief 获取空位，空位的控制字节是唯一最高位为1的值
+     */
+    [[nodiscard]] FlatHashBitMask<std::uint32_t, 0> match_empty(
+    ) const noexcept {
+        return FlatHashBitMask<std::uint32_t, 0>(
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(ctrl))
+        );
+    }
+
+    __m256i ctrl;  // 一组控制字节
+};
+using FlatHashGroup = FlatHashGroupAvx2;
+
+#elif defined(__SSE2__)
+/**
+ * @struct FlatHashGroupSse2
+ * @brief 使用SSE2一次比较16个控制字节
+ */
+struct FlatHashGroupSse2 {
+    static constexpr std::size_t width = 16;  // 每组的控制字节数
+
+    explicit FlatHashGroupSse2(const std::uint8_t* p) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    /**
+     * @brief 获取控制字节等于h2的位置
+     */
+    [[nodiscard]] FlatHashBitMask<std::uint32_t, 0> match(
+        std::uint8_t h2
+    ) const noexcept {
+        const __m128i eq =
+            _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(h2)));
+        return FlatHashBitMask<std::uint32_t, 0>(
+            static_cast<std::uint32_t>(_mm_movemask_epi8(eq))
+        );
+    }
+
+    /**
+     * @brief 获取空位，空位的控制字节是唯一最高位为1的值
+     */
+    [[nodiscard]] FlatHashBitMask<std::uint32_t, 0> match_empty(
+    ) const noexcept {
+        return FlatHashBitMask<std::uint32_t, 0>(
+            static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl))
+        );
+    }
+
+    __m128i ctrl;  // 一组控制字节
+};
+using FlatHashGroup = FlatHashGroupSse2;
+
+#else
+/**
+ * @struct FlatHashGroupPortable
+ * @brief 在64位整数中一次比较8个控制字节(SWAR)
+ */
+struct FlatHashGroupPortable {
+    static constexpr std::size_t width = 8;  // 每组的控制字节数
+
+    static constexpr std::uint64_t S_lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t S_msbs = 0x8080808080808080ull;
+
+    explicit FlatHashGroupPortable(const std::uint8_t* p) noexcept {
+        std::memcpy(&ctrl, p, sizeof(ctrl));
+        if constexpr (std::endian::native == std::endian::big) {
+            ctrl = __builtin_bswap64(ctrl);
+        }
+    }
+
+    /**
+     * @brief 获取控制字节等于h2的位置
+     * @note 真正匹配的字节之后的有元素的位置可能被误报，调用者总会再比较键
+     */
+    [[nodiscard]] FlatHashBitMask<std::uint64_t, 3> match(
+        std::uint8_t h2
+    ) const noexcept {
+        const std::uint64_t x = ctrl ^ (S_lsbs * h2);
+        return FlatHashBitMask<std::uint64_t, 3>((x - S_lsbs) & ~x & S_msbs);
+    }
+
+    /**
+     * @brief 获取空位，空位的控制字节是唯一最高位为1的值
+     */
+    [[nodiscard]] FlatHashBitMask<std::uint64_t, 3> match_empty(
+    ) const noexcept {
+        return FlatHashBitMask<std::uint64_t, 3>(ctrl & S_msbs);
+    }
+
+    std::uint64_t ctrl;  // 一组控制字节
+};
+using FlatHashGroup = FlatHashGroupPortable;
+#endif
+
+/**
+ * @struct FlatHash
+ * @brief FlatHashMap和FlatHashSet默认的哈希函数
+ * @details 与std::hash相同，字符串版本支持以std::string_view和const char*
+ * 进行异构查找(还需要透明的键比较函数，如std::equal_to<>)
+ */
+template <typename Key>
+struct FlatHash : std::hash<Key> {};
+
+template <>
+struct FlatHash<std::string> {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>()(s);
+    }
+};
+
+/**
+ * @struct FlatHashSlot
+ * @brief 元素在表内搬移时使用的类型，默认为元素本身
+ */
+template <typename Value>
+struct FlatHashSlot {
+    using mutable_type = Value;
+};
+
+/**
+ * @brief 判断std::pair<const Key, T>与std::pair<Key, T>的布局是否相同
+ */
+template <typename Key, typename T>
+constexpr bool flat_hash_layout_compatible() noexcept {
+    using P = std::pair<const Key, T>;
+    using M = std::pair<Key, T>;
+    if constexpr (std::is_standard_layout_v<P> &&
+                  std::is_standard_layout_v<M>) {
+        return sizeof(P) == sizeof(M) && alignof(P) == alignof(M) &&
+               offsetof(P, first) == offsetof(M, first) &&
+               offsetof(P, second) == offsetof(M, second);
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @struct FlatHashSlot
+ * @brief 键值对的键为const，直接移动会复制键(可能抛出异常)。
+ * 与std::pair<Key, T>布局相同时，搬移时把元素当作std::pair<Key, T>
+ * 移动，键也被移动(与abseil的flat_hash_map相同的做法)
+ */
+template <typename Key, typename T>
+struct FlatHashSlot<std::pair<const Key, T>> {
+    using mutable_type = std::conditional_t<
+        flat_hash_layout_compatible<Key, T>(), std::pair<Key, T>,
+        std::pair<const Key, T>>;
+};
+
+template <
+    typename Key, typename Value, typename KeyOfValue, typename Hash,
+    typename KeyEqual, IsAllocator Alloc>
+class FlatHashTable;
+
+/**
+ * @class FlatHashIterator
+ * @brief 扁平哈希表的前向迭代器，跳过空位
+ * @tparam Value 元素类型
+ * @tparam Const 是否为常量迭代器
+ */
+template <typename Value, bool Const>
+class FlatHashIterator {
+    template <typename, bool>
+    friend class FlatHashIterator;
+    template <
+        typename, typename, typename, typename, typename, IsAllocator>
+    friend class FlatHashTable;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const Value*, Value*>;
+    using reference = std::conditional_t<Const, const Value&, Value&>;
+
+    FlatHashIterator() = default;
+
+    /**
+     * @brief 从非常量迭代器构造常量迭代器
+     */
+    FlatHashIterator(const FlatHashIterator<Value, !Const>& other) noexcept
+        requires Const
+        : ctrl(other.ctrl), slot(other.slot), end(other.end) {}
+
+    reference operator*() const noexcept { return *slot; }
+    pointer operator->() const noexcept { return slot; }
+
+    FlatHashIterator& operator++() noexcept {
+        ++ctrl;
+        ++slot;
+        M_skip_empty();
+        return *this;
+    }
+    FlatHashIterator operator++(int) noexcept {
+        FlatHashIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    friend bool operator==(
+        const FlatHashIterator& a, const FlatHashIterator& b
+    ) noexcept {
+        return a.slot == b.slot;
+    }
+
+private:
+    FlatHashIterator(
+        const std::uint8_t* ctrl, Value* slot, const std::uint8_t* end
+    ) noexcept
+        : ctrl(ctrl), slot(slot), end(end) {}
+
+    /**
+     * @brief 前进到第一个有元素的位置或者末尾
+     */
+    void M_skip_empty() noexcept {
+        while (ctrl != end && (*ctrl & 0x80) != 0) {
+            ++ctrl;
+            ++slot;
+        }
+    }
+
+    const std::uint8_t* ctrl = nullptr;  // 当前位置的控制字节
+    Value* slot = nullptr;               // 当前位置的元素
+    const std::uint8_t* end = nullptr;   // 控制字节的末尾(不含复制的部分)
+};
+
+/**
+ * @class FlatHashTable
+ * @brief FlatHashMap和FlatHashSet共用的开放寻址哈希表
+ * @details 容量为2的幂且不小于一组的宽度，控制字节数组末尾多出一组，
+ * 复制开头的一组控制字节，使从任意位置开始的一组都可以直接读取。
+ * 元素数不超过容量的7/8，因此探测总会遇到空位
+ * @tparam Key 键类型
+ * @tparam Value 元素类型
+ * @tparam KeyOfValue 从元素中取出键的函数类型
+ * @tparam Hash 哈希函数类型
+ * @tparam KeyEqual 键比较函数类型
+ * @tparam Alloc 元素的分配器类型
+ * @note 扩容和删除会在表内搬移元素，键值对搬移时键也被移动。
+ * 搬移或哈希函数可能抛出异常时，扩容先把元素复制到新表，全部成功后才
+ * 释放原来的元素，抛出异常时表保持不变;删除要求二者都不抛出异常
+ */
+template <
+    typename Key, typename Value, typename KeyOfValue, typename Hash,
+    typename KeyEqual, IsAllocator Alloc>
+class FlatHashTable {
+protected:
+    using Group = FlatHashGroup;
+    using Tr = std::allocator_traits<Alloc>;
+    using Ctrl_alloc_type = typename Tr::template rebind_alloc<std::uint8_t>;
+    using Ctrl_traits = std::allocator_traits<Ctrl_alloc_type>;
+
+    static constexpr std::uint8_t S_empty = 0x80;  // 空位的控制字节
+
+    // 搬移元素时使用的类型及其分配器
+    using Mutable = typename FlatHashSlot<Value>::mutable_type;
+    using Mutable_alloc_type = typename Tr::template rebind_alloc<Mutable>;
+    using Mutable_traits = std::allocator_traits<Mutable_alloc_type>;
+
+    // 搬移元素不会抛出异常
+    static constexpr bool S_nothrow_transfer =
+        std::is_trivially_copyable_v<Value> ||
+        std::is_nothrow_move_constructible_v<Mutable>;
+    // 扩容时搬移元素和计算哈希值都不会抛出异常，可以直接搬移
+    static constexpr bool S_nothrow_rehash =
+        S_nothrow_transfer &&
+        std::is_nothrow_invocable_v<const Hash&, const Key&>;
+
+    // 哈希函数与键比较函数都透明时支持异构查找
+    static constexpr bool S_transparent = requires {
+        typename Hash::is_transparent;
+        typename KeyEqual::is_transparent;
+    };
+
+public:
+    using key_type = Key;                    // 键类型
+    using value_type = Value;                // 元素类型
+    using size_type = std::size_t;           // 元素个数类型
+    using difference_type = std::ptrdiff_t;  // 迭代器差值类型
+    using hasher = Hash;                     // 哈希函数类型
+    using key_equal = KeyEqual;              // 键比较函数类型
+    using allocator_type = Alloc;            // 分配器类型
+    using reference = Value&;                // 引用类型
+    using const_reference = const Value&;    // 常量引用类型
+    using pointer = Value*;                  // 指针类型
+    using const_pointer = const Value*;      // 常量指针类型
+    // 集合的元素就是键，不能通过迭代器修改
+    using iterator =
+        FlatHashIterator<Value, std::is_same_v<Key, Value>>;  // 迭代器
+    using const_iterator = FlatHashIterator<Value, true>;     // 常量迭代器
+
+    FlatHashTable() = default;
+
+    /**
+     * @brief 构造空表并预留能容纳n个元素的空间
+     * @param n 元素个数
+     * @param hash 哈希函数
+     * @param equal 键比较函数
+     * @param a 分配器
+     */
+    explicit FlatHashTable(
+        size_type n, const Hash& hash = Hash(),
+        const KeyEqual& equal = KeyEqual(),
+        const allocator_type& a = allocator_type()
+    )
+        : alloc(a), hash(hash), equal(equal) {
+        reserve(n);
+    }
+
+    /**
+     * @brief 复制构造函数，使用相同的容量，元素放在相同的位置
+     * @param other 需要复制的表
+     */
+    FlatHashTable(const FlatHashTable& other)
+        : alloc(Tr::select_on_container_copy_construction(other.alloc)),
+          hash(other.hash),
+          equal(other.equal) {
+        if (other.M_size == 0) {
+            return;
+        }
+        M_allocate(other.M_capacity);
+        try {
+            for (size_type i = 0; i != M_capacity; ++i) {
+                if (S_is_full(other.M_ctrl[i])) {
+                    Tr::construct(alloc, M_slots + i, other.M_slots[i]);
+                    M_set_ctrl(i, other.M_ctrl[i]);
+                    ++M_size;
+                }
+            }
+        } catch (...) {
+            M_destroy_all();
+            M_deallocate();
+            throw;
+        }
+        M_growth_left = S_growth_limit(M_capacity) - M_size;
+    }
+
+    /**
+     * @brief 移动构造函数
+     * @param other 需要移动的表
+     */
+    FlatHashTable(FlatHashTable&& other) noexcept
+        : alloc(std::move(other.alloc)),
+          hash(std::move(other.hash)),
+          equal(std::move(other.equal)) {
+        M_steal(other);
+    }
+
+    /**
+     * @brief 复制赋值
+     * @param other 需要复制的表
+     * @return 自身的引用
+     */
+    FlatHashTable& operator=(const FlatHashTable& other) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        if constexpr (Tr::propagate_on_container_copy_assignment::value) {
+            if (alloc != other.alloc) {
+                M_deallocate();
+            }
+            alloc = other.alloc;
+        }
+        hash = other.hash;
+        equal = other.equal;
+        reserve(other.M_size);
+        for (const value_type& value : other) {
+            M_insert_new(M_hash(KeyOfValue()(value)), value);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 移动赋值
+     * @param other 需要移动的表
+     * @return 自身的引用
+     */
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept(
+        Tr::propagate_on_container_move_assignment::value ||
+        Tr::is_always_equal::value
+    ) {
+        if (this == &other) {
+            return *this;
+        }
+        hash = std::move(other.hash);
+        equal = std::move(other.equal);
+        if constexpr (Tr::propagate_on_container_move_assignment::value ||
+                      Tr::is_always_equal::value) {
+            M_destroy_all();
+            M_deallocate();
+            if constexpr (Tr::propagate_on_container_move_assignment::value) {
+                alloc = std::move(other.alloc);
+            }
+            M_steal(other);
+        } else {
+            if (alloc == other.alloc) {
+                M_destroy_all();
+                M_deallocate();
+                M_steal(other);
+            } else {
+                // 分配器不同时只能逐个移动元素
+                clear();
+                reserve(other.M_size);
+                for (value_type& value : other) {
+                    M_insert_new(
+                        M_hash(KeyOfValue()(value)), std::move(value)
+                    );
+                }
+                other.clear();
+            }
+        }
+        return *this;
+    }
+
+    ~FlatHashTable() noexcept {
+        M_destroy_all();
+        M_deallocate();
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        iterator it = M_iterator_at(0);
+        it.M_skip_empty();
+        return it;
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        const_iterator it = M_iterator_at(0);
+        it.M_skip_empty();
+        return it;
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] iterator end() noexcept { return M_iterator_at(M_capacity); }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return M_iterator_at(M_capacity);
+    }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    /**
+     * @brief 判断表是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept { return M_size == 0; }
+
+    /**
+     * @brief 获取元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept { return M_size; }
+
+    /**
+     * @brief 获取最大元素个数
+     */
+    [[nodiscard]] size_type max_size() const noexcept {
+        return S_growth_limit(
+            std::bit_floor(std::min(Tr::max_size(alloc), S_max_capacity()))
+        );
+    }
+
+    /**
+     * @brief 获取容量(位置的个数)
+     */
+    [[nodiscard]] size_type capacity() const noexcept { return M_capacity; }
+    [[nodiscard]] size_type bucket_count() const noexcept {
+        return M_capacity;
+    }
+
+    /**
+     * @brief 获取当前的负载因子
+     */
+    [[nodiscard]] float load_factor() const noexcept {
+        return M_capacity == 0 ? 0.0f
+                               : static_cast<float>(M_size) / M_capacity;
+    }
+
+    /**
+     * @brief 获取最大负载因子，固定为7/8
+     */
+    [[nodiscard]] float max_load_factor() const noexcept { return 0.875f; }
+
+    /**
+     * @brief 删除所有元素，保留容量
+     */
+    void clear() noexcept {
+        if (M_size != 0) {
+            M_destroy_all();
+            std::memset(M_ctrl, S_empty, M_capacity + Group::width);
+            M_size = 0;
+            M_growth_left = S_growth_limit(M_capacity);
+        }
+    }
+
+    /**
+     * @brief 预留空间，使插入n个元素之前不会扩容
+     * @param n 元素个数
+     */
+    void reserve(size_type n) {
+        if (n > M_size + M_growth_left) {
+            M_resize(S_capacity_for(n));
+        }
+    }
+
+    /**
+     * @brief 重新分配容量，新的容量不小于n并且能容纳现有元素
+     * @param n 最小容量
+     * @note n为0且表为空时释放全部内存
+     */
+    void rehash(size_type n) {
+        if (n == 0 && M_size == 0) {
+            M_deallocate();
+            return;
+        }
+        const size_type cap = std::max(
+            S_capacity_for(M_size),
+            n <= Group::width ? Group::width : std::bit_ceil(n)
+        );
+        if (cap != M_capacity) {
+            M_resize(cap);
+        }
+    }
+
+    /**
+     * @brief 插入元素，已存在相等的键时不插入
+     * @param value 元素
+     * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+     */
+    std::pair<iterator, bool> insert(const value_type& value) {
+        const auto& key = KeyOfValue()(value);
+        return M_try_emplace(M_hash(key), key, value);
+    }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        const auto& key = KeyOfValue()(value);
+        return M_try_emplace(M_hash(key), key, std::move(value));
+    }
+
+    /**
+     * @brief 批量插入范围中的元素
+     * @details 前向迭代器时先预留空间，插入第i个元素的同时计算第i + 16个
+     * 元素的哈希值并预取它的控制字节和元素，使各元素的缓存未命中互相重叠
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @note 预留空间按范围长度计算，范围中有大量重复的键时会多占用内存
+     */
+    template <std::input_iterator InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        if constexpr (std::forward_iterator<InputIterator>) {
+            reserve(M_size + std::distance(first, last));
+            // ahead比first领先distance个元素，hashes[k]为first处的哈希值
+            constexpr size_type distance = 16;
+            std::array<std::size_t, distance> hashes;
+            InputIterator ahead = first;
+            for (size_type n = 0; n != distance && ahead != last;
+                 ++n, ++ahead) {
+                hashes[n] = M_hash(KeyOfValue()(*ahead));
+                M_prefetch(hashes[n]);
+            }
+            for (size_type k = 0; first != last;
+                 ++first, k = (k + 1) % distance) {
+                const std::size_t h = hashes[k];
+                if (ahead != last) {
+                    hashes[k] = M_hash(KeyOfValue()(*ahead));
+                    M_prefetch(hashes[k]);
+                    ++ahead;
+                }
+                M_try_emplace(h, KeyOfValue()(*first), *first);
+            }
+        } else {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+    }
+    void insert(std::initializer_list<value_type> l) {
+        insert(l.begin(), l.end());
+    }
+
+    /**
+     * @brief 原地构造元素并插入，已存在相等的键时丢弃
+     * @param args 构造元素的参数
+     * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type tmp(std::forward<Args>(args)...);
+        const auto& key = KeyOfValue()(tmp);
+        return M_try_emplace(M_hash(key), key, std::move(tmp));
+    }
+
+    /**
+     * @brief 查找键
+     * @param key 键
+     * @return 指向该元素的迭代器，不存在时返回end()
+     */
+    [[nodiscard]] iterator find(const key_type& key) {
+        return M_iterator_at(M_find(key, M_hash(key)));
+    }
+    [[nodiscard]] const_iterator find(const key_type& key) const {
+        return M_iterator_at(M_find(key, M_hash(key)));
+    }
+    template <typename K>
+        requires S_transparent
+    [[nodiscard]] iterator find(const K& key) {
+        return M_iterator_at(M_find(key, M_hash(key)));
+    }
+    template <typename K>
+        requires S_transparent
+    [[nodiscard]] const_iterator find(const K& key) const {
+        return M_iterator_at(M_find(key, M_hash(key)));
+    }
+
+    /**
+     * @brief 判断键是否存在
+     */
+    [[nodiscard]] bool contains(const key_type& key) const {
+        return M_find(key, M_hash(key)) != M_capacity;
+    }
+    template <typename K>
+        requires S_transparent
+    [[nodiscard]] bool contains(const K& key) const {
+        return M_find(key, M_hash(key)) != M_capacity;
+    }
+
+    /**
+     * @brief 获取具有该键的元素个数(0或1)
+     */
+    [[nodiscard]] size_type count(const key_type& key) const {
+        return contains(key) ? 1 : 0;
+    }
+    template <typename K>
+        requires S_transparent
+    [[nodiscard]] size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * @brief 删除键
+     * @param key 键
+     * @return 删除的元素个数(0或1)
+     */
+    size_type erase(const key_type& key) { return M_erase_key(key); }
+    template <typename K>
+        requires S_transparent &&
+                 (!std::is_convertible_v<K, const_iterator>)
+    size_type erase(K&& key) {
+        return M_erase_key(key);
+    }
+
+    /**
+     * @brief 删除迭代器指向的元素
+     * @param pos 指向元素的迭代器
+     * @note 删除会把后面的元素前移到该位置，因此不返回下一个元素的迭代器，
+     * 遍历时删除请使用erase_if
+     */
+    void erase(const_iterator pos) {
+        M_erase_at(static_cast<size_type>(pos.ctrl - M_ctrl));
+    }
+
+    /**
+     * @brief 删除所有满足谓词的元素
+     * @param pred 一元谓词
+     * @return 删除的元素个数
+     * @note 绕回表头的元素前移时会被再次检查，谓词对同一元素应返回相同的结果
+     */
+    template <typename Pred>
+    size_type erase_if(Pred pred) {
+        const size_type old_size = M_size;
+        for (size_type i = 0; i != M_capacity; ++i) {
+            // 删除后该位置可能被后面的元素填上，需要再次检查
+            while (S_is_full(M_ctrl[i]) &&
+                   pred(std::as_const(M_slots[i]))) {
+                M_erase_at(i);
+            }
+        }
+        return old_size - M_size;
+    }
+
+    /**
+     * @brief 与另一个表交换内容
+     * @param other 另一个表
+     */
+    void swap(FlatHashTable& other) noexcept {
+        using std::swap;
+        if constexpr (Tr::propagate_on_container_swap::value) {
+            swap(alloc, other.alloc);
+        }
+        swap(hash, other.hash);
+        swap(equal, other.equal);
+        swap(M_ctrl, other.M_ctrl);
+        swap(M_slots, other.M_slots);
+        swap(M_capacity, other.M_capacity);
+        swap(M_mask, other.M_mask);
+        swap(M_size, other.M_size);
+        swap(M_growth_left, other.M_growth_left);
+    }
+
+    [[nodiscard]] hasher hash_function() const { return hash; }
+    [[nodiscard]] key_equal key_eq() const { return equal; }
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return alloc;
+    }
+
+    /**
+     * @brief 判断两个表是否包含相同的元素
+     */
+    friend bool operator==(const FlatHashTable& a, const FlatHashTable& b) {
+        if (a.M_size != b.M_size) {
+            return false;
+        }
+        for (const value_type& value : a) {
+            const auto& key = KeyOfValue()(value);
+            const size_type i = b.M_find(key, b.M_hash(key));
+            if (i == b.M_capacity || !(b.M_slots[i] == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+protected:
+    /**
+     * @brief 在键不存在时用args构造元素并插入
+     * @param h 键的哈希值
+     * @param key 键，只用于查找
+     * @param args 构造元素的参数
+     * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+     * @note 若key是表中元素的键则一定能找到，扩容不会使其失效
+     */
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> M_try_emplace(
+        std::size_t h, const K& key, Args&&... args
+    ) {
+        const std::uint8_t h2 = S_h2(h);
+        size_type pos = S_h1(h) & M_mask;
+        while (true) {
+            const Group group(M_ctrl + pos);
+            for (auto m = group.match(h2); m; m.clear_lowest()) {
+                const size_type i = (pos + m.lowest()) & M_mask;
+                if (equal(KeyOfValue()(M_slots[i]), key)) {
+                    return {M_iterator_at(i), false};
+                }
+            }
+            if (const auto empty = group.match_empty()) {
+                // 线性探测中键只可能位于第一个空位之前，第一个空位就是插入位置
+                const size_type i = (pos + empty.lowest()) & M_mask;
+                return {
+                    M_iterator_at(
+                        M_emplace_at(i, h, std::forward<Args>(args)...)
+                    ),
+                    true
+                };
+            }
+            pos = (pos + Group::width) & M_mask;
+        }
+    }
+
+    /**
+     * @brief 插入确定不存在的元素
+     * @param h 键的哈希值
+     * @param args 构造元素的参数
+     */
+    template <typename... Args>
+    void M_insert_new(std::size_t h, Args&&... args) {
+        M_emplace_at(M_find_empty(h), h, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 计算键的哈希值并混合，使std::hash对整数的恒等映射也能均匀分布
+     */
+    template <typename K>
+    std::size_t M_hash(const K& key) const {
+        const std::uint64_t h = hash(key);
+#if defined(__SIZEOF_INT128__)
+        // __int128是GCC扩展，用__extension__避免-Wpedantic警告
+        __extension__ using uint128 = unsigned __int128;
+        const uint128 m = static_cast<uint128>(h) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(
+            static_cast<std::uint64_t>(m) ^ static_cast<std::uint64_t>(m >> 64)
+        );
+#else
+        const std::uint64_t m = (h ^ (h >> 32)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(m ^ (m >> 29));
+#endif
+    }
+
+private:
+    /**
+     * @brief 在空位i构造元素，空间不足时先扩容再重新寻找空位
+     * @return 元素实际所在的位置
+     */
+    template <typename... Args>
+    size_type M_emplace_at(size_type i, std::size_t h, Args&&... args) {
+        if (M_growth_left == 0) {
+            M_resize(M_capacity == 0 ? Group::width : 2 * M_capacity);
+            i = M_find_empty(h);
+        }
+        Tr::construct(alloc, M_slots + i, std::forward<Args>(args)...);
+        M_set_ctrl(i, S_h2(h));
+        ++M_size;
+        --M_growth_left;
+        return i;
+    }
+
+    /**
+     * @brief 查找键所在的位置
+     * @return 键所在的位置，不存在时返回容量
+     */
+    template <typename K>
+    size_type M_find(const K& key, std::size_t h) const {
+        const std::uint8_t h2 = S_h2(h);
+        size_type pos = S_h1(h) & M_mask;
+        while (true) {
+            const Group group(M_ctrl + pos);
+            for (auto m = group.match(h2); m; m.clear_lowest()) {
+                const size_type i = (pos + m.lowest()) & M_mask;
+                if (equal(KeyOfValue()(M_slots[i]), key)) {
+                    return i;
+                }
+            }
+            if (group.match_empty()) {
+                return M_capacity;
+            }
+            pos = (pos + Group::width) & M_mask;
+        }
+    }
+
+    /**
+     * @brief 查找哈希值为h的元素的插入位置(从H1开始的第一个空位)
+     */
+    size_type M_find_empty(std::size_t h) const noexcept {
+        size_type pos = S_h1(h) & M_mask;
+        while (true) {
+            if (const auto empty = Group(M_ctrl + pos).match_empty()) {
+                return (pos + empty.lowest()) & M_mask;
+            }
+            pos = (pos + Group::width) & M_mask;
+        }
+    }
+
+    /**
+     * @brief 删除键，返回删除的元素个数
+     */
+    template <typename K>
+    size_type M_erase_key(const K& key) {
+        const size_type i = M_find(key, M_hash(key));
+        if (i == M_capacity) {
+            return 0;
+        }
+        M_erase_at(i);
+        return 1;
+    }
+
+    /**
+     * @brief 删除位置i的元素，并把后面的元素前移(backward shift)
+     * @details 从i之后直到第一个空位，元素的初始位置(H1)不在(空位, 该元素]
+     * 之间时可以前移到空位，前移后它原来的位置成为新的空位。
+     * 这样表中始终没有墓碑，线性探测的不变式保持成立
+     */
+    void M_erase_at(size_type i) {
+        Tr::destroy(alloc, M_slots + i);
+        size_type hole = i;
+        for (size_type j = (i + 1) & M_mask; S_is_full(M_ctrl[j]);
+             j = (j + 1) & M_mask) {
+            const size_type home =
+                S_h1(M_hash(KeyOfValue()(M_slots[j]))) & M_mask;
+            if (((j - home) & M_mask) >= ((j - hole) & M_mask)) {
+                M_transfer(M_slots + hole, M_slots + j);
+                M_set_ctrl(hole, M_ctrl[j]);
+                hole = j;
+            }
+        }
+        M_set_ctrl(hole, S_empty);
+        --M_size;
+        ++M_growth_left;
+    }
+
+    /**
+     * @brief 将容量改为cap并重新放置所有元素
+     * @param cap 新的容量，必须能容纳现有元素
+     */
+    void M_resize(size_type cap) {
+        std::uint8_t* const old_ctrl = M_ctrl;
+        const pointer old_slots = M_slots;
+        const size_type old_capacity = M_capacity;
+        const size_type old_growth_left = M_growth_left;
+        M_allocate(cap);
+        if constexpr (S_nothrow_rehash) {
+            for (size_type i = 0; i != old_capacity; ++i) {
+                if (S_is_full(old_ctrl[i])) {
+                    const std::size_t h = M_hash(KeyOfValue()(old_slots[i]));
+                    const size_type j = M_find_empty(h);
+                    M_transfer(M_slots + j, old_slots + i);
+                    M_set_ctrl(j, S_h2(h));
+                }
+            }
+        } else {
+            // 先复制到新表，原来的元素在全部复制成功后才析构
+            try {
+                for (size_type i = 0; i != old_capacity; ++i) {
+                    if (S_is_full(old_ctrl[i])) {
+                        const std::size_t h =
+                            M_hash(KeyOfValue()(old_slots[i]));
+                        const size_type j = M_find_empty(h);
+                        Tr::construct(
+                            alloc, M_slots + j,
+                            std::move_if_noexcept(old_slots[i])
+                        );
+                        M_set_ctrl(j, S_h2(h));
+                    }
+                }
+            } catch (...) {
+                // 析构新表中已复制的元素，恢复原来的表
+                M_destroy_all();
+                S_deallocate(alloc, M_ctrl, M_slots, M_capacity);
+                M_ctrl = old_ctrl;
+                M_slots = old_slots;
+                M_capacity = old_capacity;
+                M_mask = old_capacity == 0 ? 0 : old_capacity - 1;
+                M_growth_left = old_growth_left;
+                throw;
+            }
+            for (size_type i = 0; i != old_capacity; ++i) {
+                if (S_is_full(old_ctrl[i])) {
+                    Tr::destroy(alloc, old_slots + i);
+                }
+            }
+        }
+        M_growth_left = S_growth_limit(M_capacity) - M_size;
+        if (old_capacity != 0) {
+            S_deallocate(alloc, old_ctrl, old_slots, old_capacity);
+        }
+    }
+
+    /**
+     * @brief 分配容量为cap的空表，不释放原来的内存
+     */
+    void M_allocate(size_type cap) {
+        Ctrl_alloc_type ctrl_alloc(alloc);
+        std::uint8_t* const ctrl =
+            Ctrl_traits::allocate(ctrl_alloc, cap + Group::width);
+        try {
+            M_slots = Tr::allocate(alloc, cap);
+        } catch (...) {
+            Ctrl_traits::deallocate(ctrl_alloc, ctrl, cap + Group::width);
+            throw;
+        }
+        M_ctrl = ctrl;
+        std::memset(M_ctrl, S_empty, cap + Group::width);
+        M_capacity = cap;
+        M_mask = cap - 1;
+        M_growth_left = S_growth_limit(cap);
+    }
+
+    /**
+     * @brief 释放内存(不析构元素)并回到空表状态
+     */
+    void M_deallocate() noexcept {
+        if (M_capacity != 0) {
+            S_deallocate(alloc, M_ctrl, M_slots, M_capacity);
+        }
+        M_reset();
+    }
+
+    /**
+     * @brief 释放一组控制字节和元素的内存
+     */
+    static void S_deallocate(
+        Alloc& alloc, std::uint8_t* ctrl, pointer slots, size_type cap
+    ) noexcept {
+        Ctrl_alloc_type ctrl_alloc(alloc);
+        Ctrl_traits::deallocate(ctrl_alloc, ctrl, cap + Group::width);
+        Tr::deallocate(alloc, slots, cap);
+    }
+
+    /**
+     * @brief 回到不占用内存的空表状态
+     */
+    void M_reset() noexcept {
+        M_ctrl = S_empty_group.data();
+        M_slots = nullptr;
+        M_capacity = 0;
+        M_mask = 0;
+        M_size = 0;
+        M_growth_left = 0;
+    }
+
+    /**
+     * @brief 接管other的内存，other回到空表状态
+     */
+    void M_steal(FlatHashTable& other) noexcept {
+        M_ctrl = other.M_ctrl;
+        M_slots = other.M_slots;
+        M_capacity = other.M_capacity;
+        M_mask = other.M_mask;
+        M_size = other.M_size;
+        M_growth_left = other.M_growth_left;
+        other.M_reset();
+    }
+
+    /**
+     * @brief 析构所有元素，不修改控制字节
+     */
+    void M_destroy_all() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i != M_capacity; ++i) {
+                if (S_is_full(M_ctrl[i])) {
+                    Tr::destroy(alloc, M_slots + i);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 将src处的元素移动到未初始化的dst处并析构src
+     * @note 键值对按std::pair<Key, T>移动，键不会被复制
+     */
+    void M_transfer(pointer dst, pointer src) noexcept(S_nothrow_transfer) {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            std::memcpy(
+                static_cast<void*>(dst), static_cast<const void*>(src),
+                sizeof(value_type)
+            );
+        } else if constexpr (std::is_same_v<Mutable, value_type>) {
+            Tr::construct(alloc, dst, std::move(*src));
+            Tr::destroy(alloc, src);
+        } else {
+            Mutable_alloc_type a(alloc);
+            Mutable* const from = std::launder(reinterpret_cast<Mutable*>(src));
+            Mutable_traits::construct(
+                a, reinterpret_cast<Mutable*>(dst), std::move(*from)
+            );
+            Mutable_traits::destroy(a, from);
+        }
+    }
+
+    /**
+     * @brief 设置位置i的控制字节，开头一组的控制字节同时写入末尾的副本
+     */
+    void M_set_ctrl(size_type i, std::uint8_t c) noexcept {
+        M_ctrl[i] = c;
+        if (i < Group::width) {
+            M_ctrl[M_capacity + i] = c;
+        }
+    }
+
+    /**
+     * @brief 预取哈希值为h的元素所在的控制字节和元素
+     */
+    void M_prefetch(std::size_t h) const noexcept {
+        const size_type pos = S_h1(h) & M_mask;
+        __builtin_prefetch(M_ctrl + pos);
+        __builtin_prefetch(M_slots + pos);
+    }
+
+    /**
+     * @brief 获取位置i的迭代器
+     */
+    iterator M_iterator_at(size_type i) noexcept {
+        return iterator(M_ctrl + i, M_slots + i, M_ctrl + M_capacity);
+    }
+    const_iterator M_iterator_at(size_type i) const noexcept {
+        return const_iterator(M_ctrl + i, M_slots + i, M_ctrl + M_capacity);
+    }
+
+    static std::size_t S_h1(std::size_t h) noexcept { return h >> 7; }
+    static std::uint8_t S_h2(std::size_t h) noexcept {
+        return static_cast<std::uint8_t>(h & 0x7F);
+    }
+    static bool S_is_full(std::uint8_t c) noexcept { return (c & 0x80) == 0; }
+
+    /**
+     * @brief 容量为cap时最多能容纳的元素个数
+     */
+    static constexpr size_type S_growth_limit(size_type cap) noexcept {
+        return cap - cap / 8;
+    }
+
+    /**
+     * @brief 能容纳n个元素的最小容量
+     */
+    static size_type S_capacity_for(size_type n) {
+        if (n > S_growth_limit(S_max_capacity())) {
+            throw std::length_error("FlatHashTable: too many elements");
+        }
+        size_type cap = std::max(Group::width, std::bit_ceil(n));
+        if (S_growth_limit(cap) < n) {
+            cap *= 2;
+        }
+        return cap;
+    }
+
+    /**
+     * @brief 容量的上限
+     */
+    static constexpr size_type S_max_capacity() noexcept {
+        return std::bit_floor(
+            std::numeric_limits<size_type>::max() /
+            (sizeof(value_type) + 1) / 2
+        );
+    }
+
+    // 空表使用的一组只读的空位，使查找不需要判断表是否为空
+    alignas(Group::width) static inline std::array<
+        std::uint8_t, Group::width> S_empty_group = [] {
+        std::array<std::uint8_t, Group::width> group{};
+        group.fill(S_empty);
+        return group;
+    }();
+
+    [[no_unique_address]] Alloc alloc;     // 元素的分配器
+    [[no_unique_address]] Hash hash;       // 哈希函数
+    [[no_unique_address]] KeyEqual equal;  // 键比较函数
+    std::uint8_t* M_ctrl = S_empty_group.data();  // 控制字节
+    pointer M_slots = nullptr;                    // 元素
+    size_type M_capacity = 0;                     // 容量
+    size_type M_mask = 0;                         // 容量减一，空表时为0
+    size_type M_size = 0;                         // 元素个数
+    size_type M_growth_left = 0;                  // 扩容前还能插入的元素个数
+};
+
+/**
+ * @struct FlatHashMapKey
+ * @brief 从键值对中取出键
+ */
+struct FlatHashMapKey {
+    template <typename Pair>
+    constexpr const auto& operator()(const Pair& p) const noexcept {
+        return p.first;
+    }
+};
+
+/**
+ * @struct FlatHashSetKey
+ * @brief 集合的元素就是键
+ */
+struct FlatHashSetKey {
+    template <typename Key>
+    constexpr const Key& operator()(const Key& key) const noexcept {
+        return key;
+    }
+};
+
+/**
+ * @class FlatHashMap
+ * @brief 开放寻址的哈希映射
+ * @details 插入、删除和扩容都会使迭代器以及指向元素的指针和引用失效
+ * @tparam Key 键类型
+ * @tparam T 值类型
+ * @tparam Hash 哈希函数类型
+ * @tparam KeyEqual 键比较函数类型，与Hash都透明时支持异构查找
+ * @tparam Alloc 分配器类型，分配的类型需要为std::pair<const Key, T>
+ */
+template <
+    NotConstVolatile Key, NotConstVolatile T, typename Hash = FlatHash<Key>,
+    typename KeyEqual = std::equal_to<Key>,
+    IsAllocator Alloc = Allocator<std::pair<const Key, T>>>
+    requires SameTypeAlloc<std::pair<const Key, T>, Alloc>
+class FlatHashMap : protected FlatHashTable<
+                        Key, std::pair<const Key, T>, FlatHashMapKey, Hash,
+                        KeyEqual, Alloc> {
+    using Base = FlatHashTable<
+        Key, std::pair<const Key, T>, FlatHashMapKey, Hash, KeyEqual, Alloc>;
+
+public:
+    using mapped_type = T;  // 值类型
+    using typename Base::allocator_type;
+    using typename Base::const_iterator;
+    using typename Base::const_pointer;
+    using typename Base::const_reference;
+    using typename Base::difference_type;
+    using typename Base::hasher;
+    using typename Base::iterator;
+    using typename Base::key_equal;
+    using typename Base::key_type;
+    using typename Base::pointer;
+    using typename Base::reference;
+    using typename Base::size_type;
+    using typename Base::value_type;
+
+    using Base::Base;
+
+    FlatHashMap() = default;
+
+    /**
+     * @brief 根据迭代器范围构造
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @param n 预留的元素个数
+     */
+    template <std::input_iterator InputIterator>
+    FlatHashMap(InputIterator first, InputIterator last, size_type n = 0)
+        : Base(n) {
+        insert(first, last);
+    }
+
+    /**
+     * @brief 根据初始化列表构造
+     * @param l 初始化列表
+     */
+    FlatHashMap(std::initializer_list<value_type> l)
+        : FlatHashMap(l.begin(), l.end()) {}
+
+    using Base::begin;
+    using Base::bucket_count;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::count;
+    using Base::emplace;
+    using Base::empty;
+    using Base::end;
+    using Base::erase;
+    using Base::erase_if;
+    using Base::find;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::insert;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::max_size;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+
+    /**
+     * @brief 键不存在时用args构造值并插入，存在时不做任何事
+     * @param key 键
+     * @param args 构造值的参数
+     * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return this->M_try_emplace(
+            this->M_hash(key), key, std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...)
+        );
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return this->M_try_emplace(
+            this->M_hash(key), key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...)
+        );
+    }
+
+    /**
+     * @brief 键不存在时插入，存在时把值赋为obj
+     * @param key 键
+     * @param obj 值
+     * @return 指向具有该键的元素的迭代器，以及是否插入了新元素
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        auto result = try_emplace(key, std::forward<M>(obj));
+        if (!result.second) {
+            result.first->second = std::forward<M>(obj);
+        }
+        return result;
+    }
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+        auto result = try_emplace(std::move(key), std::forward<M>(obj));
+        if (!result.second) {
+            result.first->second = std::forward<M>(obj);
+        }
+        return result;
+    }
+
+    /**
+     * @brief 获取键对应的值，不存在时插入值初始化的值
+     * @param key 键
+     * @return 值的引用
+     */
+    mapped_type& operator[](const key_type& key) {
+        return try_emplace(key).first->second;
+    }
+    mapped_type& operator[](key_type&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    /**
+     * @brief 获取键对应的值
+     * @param key 键
+     * @return 值的引用
+     * @throw std::out_of_range 键不存在
+     */
+    [[nodiscard]] mapped_type& at(const key_type& key) {
+        const auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return it->second;
+    }
+    [[nodiscard]] const mapped_type& at(const key_type& key) const {
+        const auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief 与另一个映射交换内容
+     */
+    void swap(FlatHashMap& other) noexcept { Base::swap(other); }
+
+    /**
+     * @brief 判断两个映射是否包含相同的键值对
+     */
+    friend bool operator==(const FlatHashMap& a, const FlatHashMap& b) {
+        return static_cast<const Base&>(a) == static_cast<const Base&>(b);
+    }
+};
+
+/**
+ * @class FlatHashSet
+ * @brief 开放寻址的哈希集合
+ * @details 插入、删除和扩容都会使迭代器以及指向元素的指针和引用失效
+ * @tparam Key 键类型
+ * @tparam Hash 哈希函数类型
+ * @tparam KeyEqual 键比较函数类型，与Hash都透明时支持异构查找
+ * @tparam Alloc 分配器类型，分配的类型需要与Key相同
+ */
+template <
+    NotConstVolatile Key, typename Hash = FlatHash<Key>,
+    typename KeyEqual = std::equal_to<Key>,
+    IsAllocator Alloc = Allocator<Key>>
+    requires SameTypeAlloc<Key, Alloc>
+class FlatHashSet
+    : protected FlatHashTable<Key, Key, FlatHashSetKey, Hash, KeyEqual, Alloc> {
+    using Base =
+        FlatHashTable<Key, Key, FlatHashSetKey, Hash, KeyEqual, Alloc>;
+
+public:
+    using typename Base::allocator_type;
+    using typename Base::const_iterator;
+    using typename Base::const_pointer;
+    using typename Base::const_reference;
+    using typename Base::difference_type;
+    using typename Base::hasher;
+    using typename Base::iterator;
+    using typename Base::key_equal;
+    using typename Base::key_type;
+    using typename Base::pointer;
+    using typename Base::reference;
+    using typename Base::size_type;
+    using typename Base::value_type;
+
+    using Base::Base;
+
+    FlatHashSet() = default;
+
+    /**
+     * @brief 根据迭代器范围构造
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @param n 预留的元素个数
+     */
+    template <std::input_iterator InputIterator>
+    FlatHashSet(InputIterator first, InputIterator last, size_type n = 0)
+        : Base(n) {
+        insert(first, last);
+    }
+
+    /**
+     * @brief 根据初始化列表构造
+     * @param l 初始化列表
+     */
+    FlatHashSet(std::initializer_list<value_type> l)
+        : FlatHashSet(l.begin(), l.end()) {}
+
+    using Base::begin;
+    using Base::bucket_count;
+    using Base::capacity;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::clear;
+    using Base::contains;
+    using Base::count;
+    using Base::emplace;
+    using Base::empty;
+    using Base::end;
+    using Base::erase;
+    using Base::erase_if;
+    using Base::find;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::insert;
+    using Base::key_eq;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::max_size;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::size;
+
+    /**
+     * @brief 与另一个集合交换内容
+     */
+    void swap(FlatHashSet& other) noexcept { Base::swap(other); }
+
+    /**
+     * @brief 判断两个集合是否包含相同的元素
+     */
+    friend bool operator==(const FlatHashSet& a, const FlatHashSet& b) {
+        return static_cast<const Base&>(a) == static_cast<const Base&>(b);
+    }
+};
+
+}  // namespace user
+
+#endif  // FLAT_HASH_MAP_HPP
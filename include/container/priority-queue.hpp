@@ -0,0 +1,439 @@
+/* UTF-8 */
+/**
+ * @file priority-queue.hpp
+ * @brief user::PriorityQueue类，存放在user::Vector中的d叉隐式堆
+ * @details 结点i的孩子为d*i+1到d*i+d，父结点为(i-1)/d。与二叉堆相比，
+ * 4叉堆的深度减半，并且同一结点的孩子连续存放，通常位于同一缓存行中:
+ * 下沉时每层多比较几次，但缓存未命中次数减半。
+ * 可选的位置映射(IndexMap)在每个元素被放到新位置时得到通知，
+ * 使外部能够记录元素在堆中的位置，从而支持decrease_key、update和erase
+ */
+
+#ifndef PRIORITY_QUEUE_HPP
+#define PRIORITY_QUEUE_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <userconcept/myconcept.hpp>
+
+namespace user {
+
+/**
+ * @struct NoHeapIndex
+ * @brief 不记录元素位置的位置映射，所有通知都是空操作
+ */
+struct NoHeapIndex {
+    template <typename Tp>
+    constexpr void operator()(const Tp&, std::size_t) const noexcept {}
+};
+
+/**
+ * @class PriorityQueue
+ * @brief d叉堆实现的优先队列
+ * @details 与std::priority_queue相同，comp(a, b)为true表示a的优先级低于b，
+ * 默认的std::less使堆顶为最大元素，std::greater使堆顶为最小元素
+ * @tparam Tp 元素类型
+ * @tparam Compare 比较函数类型
+ * @tparam Arity 每个结点的孩子数，至少为2
+ * @tparam IndexMap 位置映射类型，以(元素, 新位置)调用
+ * @tparam Alloc 分配器类型
+ * @note 堆内移动元素时若移动赋值抛出异常，正在移动的元素会丢失
+ */
+template <
+    NotConstVolatile Tp, typename Compare = std::less<Tp>,
+    std::size_t Arity = 4, typename IndexMap = NoHeapIndex,
+    IsAllocator Alloc = std::allocator<Tp>>
+    requires(Arity >= 2) &&
+            std::invocable<IndexMap&, const Tp&, std::size_t>
+class PriorityQueue {
+public:
+    using value_type = Tp;                     // 元素类型
+    using reference = Tp&;                     // 引用类型
+    using const_reference = const Tp&;         // 常量引用类型
+    using size_type = std::size_t;             // 元素个数类型
+    using container_type = Vector<Tp, Alloc>;  // 底层容器类型
+    using value_compare = Compare;             // 比较函数类型
+    using index_map = IndexMap;                // 位置映射类型
+    using allocator_type = Alloc;              // 分配器类型
+
+    static constexpr size_type arity = Arity;  // 每个结点的孩子数
+
+    PriorityQueue() = default;
+
+    /**
+     * @brief 构造空的优先队列
+     * @param comp 比较函数
+     * @param index 位置映射
+     * @param a 分配器
+     */
+    explicit PriorityQueue(
+        const Compare& comp, const IndexMap& index = IndexMap(),
+        const allocator_type& a = allocator_type()
+    )
+        : comp(comp), index(index), c(a) {}
+
+    /**
+     * @brief 由范围中的元素建堆，O(n)
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @param comp 比较函数
+     * @param index 位置映射
+     * @param a 分配器
+     */
+    template <std::input_iterator InputIterator>
+    PriorityQueue(
+        InputIterator first, InputIterator last,
+        const Compare& comp = Compare(), const IndexMap& index = IndexMap(),
+        const allocator_type& a = allocator_type()
+    )
+        : comp(comp), index(index), c(a) {
+        M_append(first, last);
+        M_make_heap();
+    }
+
+    /**
+     * @brief 接管容器中的元素并建堆，O(n)
+     * @param cont 元素所在的容器
+     * @param comp 比较函数
+     * @param index 位置映射
+     */
+    explicit PriorityQueue(
+        container_type&& cont, const Compare& comp = Compare(),
+        const IndexMap& index = IndexMap()
+    )
+        : comp(comp), index(index), c(std::move(cont)) {
+        M_notify_range(0);
+        M_make_heap();
+    }
+
+    /**
+     * @brief 获取堆顶元素
+     * @return 优先级最高的元素
+     * @note 队列不能为空
+     */
+    [[nodiscard]] const_reference top() const noexcept { return c.front(); }
+
+    /**
+     * @brief 获取堆中位置i的元素
+     * @param i 位置，由位置映射得到
+     * @return 该位置的元素
+     */
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return c.begin()[i];
+    }
+
+    /**
+     * @brief 获取元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept { return c.size(); }
+
+    /**
+     * @brief 判断队列是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept { return c.size() == 0; }
+
+    /**
+     * @brief 获取不重新分配内存时能容纳的元素个数
+     */
+    [[nodiscard]] size_type capacity() const noexcept { return c.capacity(); }
+
+    /**
+     * @brief 预留至少能容纳n个元素的内存
+     * @param n 元素个数
+     */
+    void reserve(size_type n) { c.reserve(n); }
+
+    /**
+     * @brief 删除所有元素
+     */
+    void clear() noexcept { c.clear(); }
+
+    /**
+     * @brief 插入元素
+     * @param value 元素的值
+     */
+    void push(const value_type& value) { emplace(value); }
+    void push(value_type&& value) { emplace(std::move(value)); }
+
+    /**
+     * @brief 原地构造并插入元素
+     * @param args 构造元素的参数
+     */
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        c.emplace_back(std::forward<Args>(args)...);
+        const size_type hole = c.size() - 1;
+        M_sift_up(hole, std::move(c.begin()[hole]));
+    }
+
+    /**
+     * @brief 批量插入范围中的元素
+     * @details 插入的元素个数超过原有元素个数时整体重新建堆(O(n))，
+     * 否则逐个上浮(随机数据下平均每个O(1))
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     */
+    template <std::input_iterator InputIterator>
+    void push_range(InputIterator first, InputIterator last) {
+        const size_type old_size = c.size();
+        M_append(first, last);
+        const size_type n = c.size();
+        if (n - old_size > old_size) {
+            M_make_heap();
+            return;
+        }
+        for (size_type i = old_size; i != n; ++i) {
+            M_sift_up(i, std::move(c.begin()[i]));
+        }
+    }
+
+    /**
+     * @brief 删除堆顶元素
+     * @note 队列不能为空
+     */
+    void pop() {
+        const auto last = c.end() - 1;
+        if (last != c.begin()) {
+            M_sift_down(0, std::move(*last), c.size() - 1);
+        }
+        c.unordered_erase(last);
+    }
+
+    /**
+     * @brief 删除堆顶元素后插入value，只需一次下沉
+     * @details 等价于pop()后push(value)，比分开调用少一次上浮并且不改变大小，
+     * 适合取出定时器后重新调度的场景
+     * @param value 插入的元素
+     * @note 队列不能为空
+     */
+    void pop_push(const value_type& value) {
+        M_sift_down(0, value, c.size());
+    }
+    void pop_push(value_type&& value) {
+        M_sift_down(0, std::move(value), c.size());
+    }
+
+    /**
+     * @brief 提高位置i处元素的优先级
+     * @details 对于std::greater的最小堆即为减小键值，元素只会向堆顶移动
+     * @param i 元素的位置，由位置映射得到
+     * @param value 新的值，其优先级不能低于原值
+     */
+    void decrease_key(size_type i, value_type value) {
+        M_sift_up(i, std::move(value));
+    }
+
+    /**
+     * @brief 修改位置i处元素的值，并按需上浮或下沉
+     * @param i 元素的位置，由位置映射得到
+     * @param value 新的值
+     */
+    void update(size_type i, value_type value) {
+        const Tp* const p = c.begin();
+        if (i != 0 && comp(p[(i - 1) / Arity], value)) {
+            M_sift_up(i, std::move(value));
+        } else {
+            M_sift_down(i, std::move(value), c.size());
+        }
+    }
+
+    /**
+     * @brief 删除位置i处的元素
+     * @param i 元素的位置，由位置映射得到
+     */
+    void erase(size_type i) {
+        const auto last = c.end() - 1;
+        if (c.begin() + i != last) {
+            value_type tmp = std::move(*last);
+            c.unordered_erase(last);
+            update(i, std::move(tmp));
+        } else {
+            c.unordered_erase(last);
+        }
+    }
+
+    /**
+     * @brief 获取比较函数
+     */
+    [[nodiscard]] value_compare value_comp() const { return comp; }
+
+    /**
+     * @brief 获取位置映射
+     */
+    [[nodiscard]] index_map& get_index_map() noexcept { return index; }
+    [[nodiscard]] const index_map& get_index_map() const noexcept {
+        return index;
+    }
+
+    /**
+     * @brief 与另一个优先队列交换内容
+     * @param other 另一个优先队列
+     */
+    void swap(PriorityQueue& other) noexcept(
+        std::is_nothrow_swappable_v<Compare> &&
+        std::is_nothrow_swappable_v<IndexMap>
+    ) {
+        using std::swap;
+        swap(comp, other.comp);
+        swap(index, other.index);
+        c.swap(other.c);
+    }
+
+private:
+    // 元素放到新位置时是否需要通知位置映射
+    static constexpr bool S_has_index = !std::is_same_v<IndexMap, NoHeapIndex>;
+
+    // 选择孩子时是否在寄存器中保存当前优先级最高的值
+    static constexpr bool S_keep_best =
+        std::is_trivially_copy_constructible_v<Tp> &&
+        std::is_trivially_destructible_v<Tp> && std::is_copy_assignable_v<Tp> &&
+        sizeof(Tp) <= 2 * sizeof(void*);
+
+    /**
+     * @brief 将范围中的元素追加到末尾，并通知位置映射
+     */
+    template <std::input_iterator InputIterator>
+    void M_append(InputIterator first, InputIterator last) {
+        const size_type old_size = c.size();
+        if constexpr (std::forward_iterator<InputIterator>) {
+            c.reserve(old_size + std::distance(first, last));
+        }
+        for (; first != last; ++first) {
+            c.emplace_back(*first);
+        }
+        M_notify_range(old_size);
+    }
+
+    /**
+     * @brief 通知位置映射从first开始的所有元素的位置
+     */
+    void M_notify_range(size_type first) {
+        if constexpr (S_has_index) {
+            const Tp* const p = c.begin();
+            for (const size_type n = c.size(); first != n; ++first) {
+                index(p[first], first);
+            }
+        }
+    }
+
+    /**
+     * @brief 自底向上建堆(Floyd)，O(n)
+     */
+    void M_make_heap() {
+        const size_type n = c.size();
+        if (n < 2) {
+            return;
+        }
+        for (size_type i = (n - 2) / Arity + 1; i-- != 0;) {
+            M_sift_down(i, std::move(c.begin()[i]), n);
+        }
+    }
+
+    /**
+     * @brief 从空位hole开始上浮value
+     * @param hole 空位，其中的元素已被移出或可被覆盖
+     * @param value 要放入的元素，按值传递，因而可以来自空位本身
+     */
+    void M_sift_up(size_type hole, value_type value, size_type top = 0) {
+        Tp* const p = c.begin();
+        while (hole != top) {
+            const size_type parent = (hole - 1) / Arity;
+            if (!comp(p[parent], value)) {
+                break;
+            }
+            p[hole] = std::move(p[parent]);
+            index(std::as_const(p[hole]), hole);
+            hole = parent;
+        }
+        p[hole] = std::move(value);
+        index(std::as_const(p[hole]), hole);
+    }
+
+    /**
+     * @brief 从空位hole开始下沉value
+     * @details 自底向上(Floyd):先沿优先级较高的孩子把空位一直移到叶结点，
+     * 再从那里上浮value。出堆时value来自堆底，通常只需上浮很少几层，
+     * 这样每层只需选出最高的孩子，省去与value的比较和难以预测的分支
+     * @param hole 空位，其中的元素已被移出或可被覆盖
+     * @param value 要放入的元素，按值传递，因而可以来自堆中的任意位置
+     * @param n 堆的大小，pop()时不包含仍在容器末尾的最后一个元素
+     */
+    void M_sift_down(size_type hole, value_type value, size_type n) {
+        Tp* const p = c.begin();
+        const size_type top = hole;
+        // 所有孩子都存在的结点
+        const size_type full = n > Arity ? (n - Arity - 1) / Arity + 1 : 0;
+        while (hole < full) {
+            const size_type first = Arity * hole + 1;
+            // 孙结点连续存放在Arity * first + 1之后，比较孩子的同时预取，
+            // 使下一层的缓存未命中与这一层的比较重叠
+            if (Arity * first + 1 < n) {
+                S_prefetch_children(p + Arity * first + 1);
+            }
+            const size_type best = M_best_child(p, first);
+            p[hole] = std::move(p[best]);
+            index(std::as_const(p[hole]), hole);
+            hole = best;
+        }
+        // 最后一个内部结点可能只有部分孩子
+        const size_type first = Arity * hole + 1;
+        if (first < n) {
+            size_type best = first;
+            for (size_type k = first + 1; k < n; ++k) {
+                best = comp(p[best], p[k]) ? k : best;
+            }
+            p[hole] = std::move(p[best]);
+            index(std::as_const(p[hole]), hole);
+            hole = best;
+        }
+        M_sift_up(hole, std::move(value), top);
+    }
+
+    /**
+     * @brief 选出first开始的Arity个孩子中优先级最高的一个
+     * @details 小的可平凡复制构造的类型在寄存器中保存当前最大值，
+     * 各孩子的读取互不依赖，比较结果只用于条件传送
+     */
+    size_type M_best_child(const Tp* p, size_type first) const {
+        size_type best = first;
+        if constexpr (S_keep_best) {
+            Tp best_value = p[first];
+            for (size_type k = first + 1; k != first + Arity; ++k) {
+                const Tp x = p[k];
+                const bool greater = comp(best_value, x);
+                best = greater ? k : best;
+                best_value = greater ? x : best_value;
+            }
+        } else {
+            for (size_type k = first + 1; k != first + Arity; ++k) {
+                best = comp(p[best], p[k]) ? k : best;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief 预取从p开始的Arity * Arity个元素所在的缓存行
+     */
+    static void S_prefetch_children(const Tp* p) noexcept {
+        const char* const bytes = reinterpret_cast<const char*>(p);
+        for (size_type off = 0; off < Arity * Arity * sizeof(Tp); off += 64) {
+            __builtin_prefetch(bytes + off);
+        }
+    }
+
+    [[no_unique_address]] Compare comp;    // 比较函数
+    [[no_unique_address]] IndexMap index;  // 位置映射
+    container_type c;                      // 按堆序存放的元素
+};
+
+}  // namespace user
+
+#endif  // PRIORITY_QUEUE_HPP
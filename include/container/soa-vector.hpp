@@ -0,0 +1,822 @@
+/* UTF-8 */
+/**
+ * @file soa-vector.hpp
+ * @brief 实现按列存储的SoAVector类
+ * @details 每个字段存放在单独的一列中，所有列位于同一块内存，各列的起点
+ * 按缓存行(64字节)对齐，便于对单独一列做向量化处理。只访问一两个字段的
+ * 循环只读取这些列，不会把整个结构体读入缓存。扩容时一次分配新的内存，
+ * 再将所有列搬移过去
+ */
+
+#ifndef SOA_VECTOR_HPP
+#define SOA_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <small-utility/smallutility.hpp>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @struct SoAVectorBase
+ * @brief SoAVector的基类，负责整块内存的分配、释放以及列的划分
+ * (不执行构造和析构)
+ * @tparam Alloc 分配器类型，会被重绑定为按缓存行分配
+ * @tparam Ts 各列的类型
+ */
+template <IsAllocator Alloc, typename... Ts>
+struct SoAVectorBase {
+    // 各列起点的对齐字节数
+    static constexpr std::size_t S_column_align = 64;
+
+    static_assert(
+        ((alignof(Ts) <= S_column_align) && ...),
+        "SoAVector columns must not be aligned beyond a cache line"
+    );
+
+    /**
+     * @struct Line
+     * @brief 内存分配的单位，保证每一列都从缓存行边界开始
+     */
+    struct alignas(S_column_align) Line {
+        std::byte bytes[S_column_align];
+    };
+
+    // 将内存分配器重绑定为按缓存行分配
+    using Line_alloc_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Line>;
+    // 获取分配器特性类型
+    using Tr = std::allocator_traits<Line_alloc_type>;
+    // 各列起点组成的元组
+    using columns_type = std::tuple<Ts*...>;
+    // 构造和析构某一列元素时使用的分配器类型
+    template <typename Tp>
+    using Column_alloc_type = typename Tr::template rebind_alloc<Tp>;
+
+    /**
+     * @struct Storage
+     * @brief 一次分配得到的内存及其划分
+     */
+    struct Storage {
+        Line* buffer = nullptr;   // 整块内存
+        std::size_t lines = 0;    // 缓存行数
+        columns_type columns{};   // 各列的起点
+    };
+
+    // 无状态分配器不占用空间
+    [[no_unique_address]] Line_alloc_type alloc;
+
+    Storage M_storage;            // 当前的内存
+    std::size_t M_size = 0;       // 元素(行)个数
+    std::size_t M_capacity = 0;   // 容量
+
+    SoAVectorBase() = default;
+
+    /**
+     * @brief 使用指定的分配器构造
+     * @param a 分配器
+     */
+    explicit SoAVectorBase(const Line_alloc_type& a) noexcept : alloc(a) {}
+
+    SoAVectorBase(const SoAVectorBase&) = delete;
+    SoAVectorBase& operator=(const SoAVectorBase&) = delete;
+
+    /**
+     * @brief 析构函数，释放内存
+     */
+    ~SoAVectorBase() noexcept { M_deallocate(M_storage); }
+
+    /**
+     * @brief 计算一列占用的缓存行数
+     * @param bytes 该列的字节数
+     */
+    static constexpr std::size_t S_column_lines(std::size_t bytes) noexcept {
+        return (bytes + S_column_align - 1) / S_column_align;
+    }
+
+    /**
+     * @brief 取出下一列的起点，并将偏移移动到该列之后
+     * @param base 整块内存的起点
+     * @param offset 当前偏移(缓存行数)
+     * @param capacity 容量
+     */
+    template <typename Tp>
+    static Tp* S_take_column(
+        Line* base, std::size_t& offset, std::size_t capacity
+    ) noexcept {
+        Tp* column = reinterpret_cast<Tp*>(base + offset);
+        offset += S_column_lines(capacity * sizeof(Tp));
+        return column;
+    }
+
+    /**
+     * @brief 分配能容纳capacity行的内存并划分各列
+     * @param capacity 容量
+     * @return 分配的内存，capacity为0时不分配
+     */
+    Storage M_allocate(std::size_t capacity) {
+        Storage s;
+        if (capacity == 0) {
+            return s;
+        }
+        s.lines = (S_column_lines(capacity * sizeof(Ts)) + ...);
+        s.buffer = Tr::allocate(alloc, s.lines);
+        std::size_t offset = 0;
+        // 花括号初始化保证从左到右求值
+        s.columns = columns_type{
+            S_take_column<Ts>(s.buffer, offset, capacity)...
+        };
+        return s;
+    }
+
+    /**
+     * @brief 释放内存
+     * @param s M_allocate分配的内存
+     */
+    void M_deallocate(Storage& s) noexcept {
+        if (s.buffer != nullptr) {
+            Tr::deallocate(alloc, s.buffer, s.lines);
+        }
+        s = Storage{};
+    }
+
+    /**
+     * @brief 通过分配器在p处构造一列中的元素
+     * @param p 元素的地址
+     * @param args 构造函数参数
+     */
+    template <typename Tp, typename... Args>
+    void M_construct(Tp* p, Args&&... args) {
+        Column_alloc_type<Tp> a(alloc);
+        std::allocator_traits<Column_alloc_type<Tp>>::construct(
+            a, p, std::forward<Args>(args)...
+        );
+    }
+
+    /**
+     * @brief 通过分配器析构一列中从p开始的n个元素
+     * @param p 第一个元素的地址
+     * @param n 元素个数
+     */
+    template <typename Tp>
+    void M_destroy(Tp* p, std::size_t n) noexcept {
+        Column_alloc_type<Tp> a(alloc);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::allocator_traits<Column_alloc_type<Tp>>::destroy(a, p + i);
+        }
+    }
+
+    /**
+     * @brief 交换两个对象的内存
+     * @param other 另一对象
+     */
+    void M_swap_data(SoAVectorBase& other) noexcept {
+        std::swap(M_storage, other.M_storage);
+        std::swap(M_size, other.M_size);
+        std::swap(M_capacity, other.M_capacity);
+    }
+};
+
+/**
+ * @class BasicSoAVector
+ * @brief 按列存储的可变数组
+ * @details 行通过std::tuple<Ts&...>访问，可以使用结构化绑定:
+ * @code
+ * SoAVector<float, float, int> particles;
+ * particles.emplace_back(1.0f, 2.0f, 3);
+ * auto [x, y, id] = particles[0];  // x、y、id均为引用
+ * std::span<float> xs = particles.column<0>();
+ * @endcode
+ * @tparam Alloc 分配器类型
+ * @tparam Ts 各列的类型，不可为const或volatile修饰类型
+ */
+template <IsAllocator Alloc, NotConstVolatile... Ts>
+    requires(sizeof...(Ts) > 0)
+class BasicSoAVector : protected SoAVectorBase<Alloc, Ts...> {
+    using Base = SoAVectorBase<Alloc, Ts...>;  // 基类
+    using Storage = typename Base::Storage;
+    using columns_type = typename Base::columns_type;
+    using indices = std::index_sequence_for<Ts...>;
+
+    template <bool Const>
+    class Iterator;
+
+public:
+    using value_type = std::tuple<Ts...>;              // 一行的值
+    using reference = std::tuple<Ts&...>;              // 一行的引用
+    using const_reference = std::tuple<const Ts&...>;  // 一行的常量引用
+    using iterator = Iterator<false>;                  // 迭代器
+    using const_iterator = Iterator<true>;             // 常量迭代器
+    using size_type = std::size_t;                     // 元素个数类型
+    using difference_type = std::ptrdiff_t;            // 迭代器差值类型
+    using allocator_type = Alloc;                      // 分配器类型
+
+    // 第K列的类型
+    template <std::size_t K>
+    using column_type = std::tuple_element_t<K, value_type>;
+
+    BasicSoAVector() = default;
+
+    /**
+     * @brief 使用指定的分配器构造空容器
+     * @param a 分配器
+     */
+    explicit BasicSoAVector(const allocator_type& a) noexcept : Base(a) {}
+
+    /**
+     * @brief 构造n个值初始化的行
+     * @param n 行数
+     */
+    explicit BasicSoAVector(size_type n) { resize(n); }
+
+    /**
+     * @brief 根据初始化列表构造
+     * @param l 初始化列表，每个元素为一行
+     */
+    BasicSoAVector(std::initializer_list<value_type> l) {
+        reserve(l.size());
+        for (const value_type& row : l) {
+            push_back(row);
+        }
+    }
+
+    /**
+     * @brief 复制构造函数，逐列复制
+     * @param other 需要复制的容器
+     */
+    BasicSoAVector(const BasicSoAVector& other)
+        : Base(Base::Tr::select_on_container_copy_construction(other.alloc)
+          ) {
+        Storage s = this->M_allocate(other.size());
+        try {
+            M_transfer_columns(
+                other.M_storage.columns, s, other.size(),
+                [](const auto* first, const auto* last, auto* out) {
+                    std::uninitialized_copy(first, last, out);
+                },
+                indices{}
+            );
+        } catch (...) {
+            this->M_deallocate(s);
+            throw;
+        }
+        this->M_storage = s;
+        this->M_size = this->M_capacity = other.size();
+    }
+
+    /**
+     * @brief 移动构造函数，直接接管内存
+     * @param other 右值容器
+     */
+    BasicSoAVector(BasicSoAVector&& other) noexcept : Base(other.alloc) {
+        this->M_swap_data(other);
+    }
+
+    /**
+     * @brief 析构函数，析构所有元素
+     */
+    ~BasicSoAVector() noexcept { clear(); }
+
+    /**
+     * @brief 复制赋值运算符
+     * @param other 另一容器
+     * @return 当前对象的引用
+     */
+    BasicSoAVector& operator=(const BasicSoAVector& other) {
+        if (this != std::addressof(other)) {
+            BasicSoAVector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 移动赋值运算符，交换两个容器的内容
+     * @param other 另一右值容器
+     * @return 当前对象的引用
+     */
+    BasicSoAVector& operator=(BasicSoAVector&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    /**
+     * @brief 交换两个容器的内容
+     * @param other 另一容器
+     */
+    void swap(BasicSoAVector& other) noexcept {
+        this->M_swap_data(other);
+        if constexpr (Base::Tr::propagate_on_container_swap::value ||
+                      Base::Tr::propagate_on_container_move_assignment::
+                          value) {
+            std::swap(this->alloc, other.alloc);
+        }
+    }
+
+    /**
+     * @brief 获取容器的分配器
+     */
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(this->alloc);
+    }
+
+    /**
+     * @brief 获取行数
+     */
+    [[nodiscard]] size_type size() const noexcept { return this->M_size; }
+
+    /**
+     * @brief 判断容器是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept { return this->M_size == 0; }
+
+    /**
+     * @brief 获取容量
+     */
+    [[nodiscard]] size_type capacity() const noexcept {
+        return this->M_capacity;
+    }
+
+    /**
+     * @brief 获取最多可以容纳的行数
+     */
+    [[nodiscard]] static constexpr size_type max_size() noexcept {
+        // 每列最多浪费一个缓存行
+        return (std::numeric_limits<std::ptrdiff_t>::max() -
+                Base::S_column_align * sizeof...(Ts)) /
+               (sizeof(Ts) + ...);
+    }
+
+    /**
+     * @brief 获取第K列
+     * @return 该列的连续内存，长度为size()
+     * @note 列的起点按缓存行对齐，扩容后之前获取的列失效
+     */
+    template <std::size_t K>
+    [[nodiscard]] std::span<column_type<K>> column() noexcept {
+        return {std::get<K>(this->M_storage.columns), this->M_size};
+    }
+    template <std::size_t K>
+    [[nodiscard]] std::span<const column_type<K>> column() const noexcept {
+        return {std::get<K>(this->M_storage.columns), this->M_size};
+    }
+
+    /**
+     * @brief 按下标访问一行
+     * @param i 下标，必须小于size()
+     * @return 该行各字段的引用组成的元组
+     */
+    [[nodiscard]] reference operator[](size_type i) noexcept {
+        return S_row<reference>(this->M_storage.columns, i);
+    }
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return S_row<const_reference>(this->M_storage.columns, i);
+    }
+
+    /**
+     * @brief 按下标访问一行并检查范围
+     * @param i 下标
+     * @throw std::out_of_range 下标不小于size()
+     */
+    [[nodiscard]] reference at(size_type i) {
+        M_check_index(i);
+        return (*this)[i];
+    }
+    [[nodiscard]] const_reference at(size_type i) const {
+        M_check_index(i);
+        return (*this)[i];
+    }
+
+    [[nodiscard]] reference front() noexcept { return (*this)[0]; }
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+    [[nodiscard]] reference back() noexcept { return (*this)[size() - 1]; }
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        return iterator(this->M_storage.columns, 0);
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this->M_storage.columns, 0);
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator(this->M_storage.columns, this->M_size);
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this->M_storage.columns, this->M_size);
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    /**
+     * @brief 预留至少n行的容量
+     * @param n 需要的容量
+     * @throw std::length_error n超出max_size()
+     */
+    void reserve(size_type n) {
+        if (n > max_size()) {
+            throw std::length_error("SoAVector::reserve");
+        }
+        if (n > this->M_capacity) {
+            M_relocate(n);
+        }
+    }
+
+    /**
+     * @brief 将容量缩小到与行数相同
+     */
+    void shrink_to_fit() {
+        if (this->M_capacity > this->M_size) {
+            M_relocate(this->M_size);
+        }
+    }
+
+    /**
+     * @brief 在末尾构造新的一行
+     * @param args 各列的构造参数，每列一个
+     * @return 新行的引用
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Ts))
+    reference emplace_back(Args&&... args) {
+        if (this->M_size == this->M_capacity) {
+            M_realloc_append(std::forward<Args>(args)...);
+        } else {
+            M_construct_row(
+                this->M_storage.columns, this->M_size, indices{},
+                std::forward<Args>(args)...
+            );
+        }
+        ++this->M_size;
+        return back();
+    }
+
+    /**
+     * @brief 在末尾插入一行
+     * @param row 行的值
+     */
+    void push_back(const value_type& row) {
+        std::apply(
+            [this](const Ts&... fields) { emplace_back(fields...); }, row
+        );
+    }
+    void push_back(value_type&& row) {
+        std::apply(
+            [this](Ts&... fields) { emplace_back(std::move(fields)...); }, row
+        );
+    }
+
+    /**
+     * @brief 删除最后一行
+     * @note 容器不能为空
+     */
+    void pop_back() noexcept {
+        --this->M_size;
+        M_destroy_rows(this->M_storage.columns, this->M_size, 1, indices{});
+    }
+
+    /**
+     * @brief 调整行数，新增的行值初始化
+     * @param n 新的行数
+     */
+    void resize(size_type n) {
+        if (n < this->M_size) {
+            M_destroy_rows(
+                this->M_storage.columns, n, this->M_size - n, indices{}
+            );
+            this->M_size = n;
+            return;
+        }
+        if (n > this->M_capacity) {
+            reserve(std::max(n, this->M_size * 2));
+        }
+        M_value_construct_rows(n - this->M_size, indices{});
+        this->M_size = n;
+    }
+
+    /**
+     * @brief 删除所有行，保留内存
+     */
+    void clear() noexcept {
+        M_destroy_rows(this->M_storage.columns, 0, this->M_size, indices{});
+        this->M_size = 0;
+    }
+
+private:
+    /**
+     * @class Iterator
+     * @brief 按行访问的随机访问迭代器，解引用得到行的引用元组
+     * @tparam Const 是否为常量迭代器
+     */
+    template <bool Const>
+    class Iterator {
+    public:
+        // 解引用得到的是代理对象，按C++20的规定只能声明为输入迭代器
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+            std::conditional_t<Const, std::tuple<const Ts&...>, std::tuple<Ts&...>>;
+
+        Iterator() = default;
+
+        /**
+         * @brief 由各列的起点和下标构造
+         * @note 保存各列起点的副本而不是容器内的地址，容器交换或移动后
+         * 迭代器仍然指向原来的内存
+         */
+        Iterator(const columns_type& columns, std::size_t index)
+            : columns(columns), index(index) {}
+
+        /**
+         * @brief 由非常量迭代器构造常量迭代器
+         */
+        Iterator(const Iterator<!Const>& other)
+            requires Const
+            : columns(other.columns), index(other.index) {}
+
+        reference operator*() const {
+            return S_row<reference>(columns, index);
+        }
+        reference operator[](difference_type n) const {
+            return S_row<reference>(columns, index + n);
+        }
+
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++index;
+            return tmp;
+        }
+        Iterator& operator--() {
+            --index;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator tmp = *this;
+            --index;
+            return tmp;
+        }
+        Iterator& operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(
+            const Iterator& a, const Iterator& b
+        ) {
+            return static_cast<difference_type>(a.index - b.index);
+        }
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            return a.index == b.index;
+        }
+        friend auto operator<=>(const Iterator& a, const Iterator& b) {
+            return a.index <=> b.index;
+        }
+
+    private:
+        friend class Iterator<!Const>;
+
+        columns_type columns{};  // 各列的起点
+        std::size_t index = 0;   // 行号
+    };
+
+    /**
+     * @brief 由各列的起点和行号构造行的引用元组
+     * @tparam Ref reference或const_reference
+     */
+    template <typename Ref>
+    static Ref S_row(const columns_type& columns, size_type i) noexcept {
+        return std::apply(
+            [i](auto*... column) { return Ref(column[i]...); }, columns
+        );
+    }
+
+    /**
+     * @brief 在第i行逐列构造元素，某列抛出异常时析构已构造的列
+     * @param columns 各列的起点
+     * @param i 行号
+     * @param args 各列的构造参数
+     */
+    template <std::size_t... Is, typename... Args>
+    void M_construct_row(
+        const columns_type& columns, size_type i, std::index_sequence<Is...>,
+        Args&&... args
+    ) {
+        std::size_t built = 0;
+        try {
+            ((this->M_construct(
+                  std::get<Is>(columns) + i, std::forward<Args>(args)
+              ),
+              ++built),
+             ...);
+        } catch (...) {
+            ((Is < built ? this->M_destroy(std::get<Is>(columns) + i, 1)
+                         : void()),
+             ...);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 析构从第first行开始的n行
+     */
+    template <std::size_t... Is>
+    void M_destroy_rows(
+        const columns_type& columns, size_type first, size_type n,
+        std::index_sequence<Is...>
+    ) noexcept {
+        (this->M_destroy(std::get<Is>(columns) + first, n), ...);
+    }
+
+    /**
+     * @brief 在末尾值初始化n行，逐列批量构造
+     * @param n 行数，调用前容量必须足够
+     */
+    template <std::size_t... Is>
+    void M_value_construct_rows(size_type n, std::index_sequence<Is...>) {
+        const columns_type& columns = this->M_storage.columns;
+        std::size_t built = 0;
+        try {
+            ((M_value_construct_column(std::get<Is>(columns) + this->M_size, n),
+              ++built),
+             ...);
+        } catch (...) {
+            ((Is < built
+                  ? this->M_destroy(std::get<Is>(columns) + this->M_size, n)
+                  : void()),
+             ...);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 在一列中值初始化n个元素，中途抛出异常时析构已构造的元素
+     * @param p 第一个元素的地址
+     * @param n 元素个数
+     */
+    template <typename Tp>
+    void M_value_construct_column(Tp* p, size_type n) {
+        size_type i = 0;
+        try {
+            for (; i < n; ++i) {
+                this->M_construct(p + i);
+            }
+        } catch (...) {
+            this->M_destroy(p, i);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 逐列把前n行从from搬到to
+     * @details 某列失败时析构to中已搬移的列，to的内存由调用者释放
+     * @param transfer 以(起点, 终点, 目标)为参数、构造目标元素的可调用对象
+     */
+    template <typename Transfer, std::size_t... Is>
+    void M_transfer_columns(
+        const columns_type& from, Storage& to, size_type n,
+        const Transfer& transfer, std::index_sequence<Is...>
+    ) {
+        std::size_t moved = 0;
+        try {
+            ((transfer(
+                  std::get<Is>(from), std::get<Is>(from) + n,
+                  std::get<Is>(to.columns)
+              ),
+              ++moved),
+             ...);
+        } catch (...) {
+            ((Is < moved ? this->M_destroy(std::get<Is>(to.columns), n)
+                         : void()),
+             ...);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 将原有的行逐列移动(不可移动时复制)到新内存
+     * @param s 新内存
+     */
+    void M_move_columns(Storage& s) {
+        M_transfer_columns(
+            this->M_storage.columns, s, this->M_size,
+            [](auto* first, auto* last, auto* out) {
+                uninitialized_move_or_copy(first, last, out);
+            },
+            indices{}
+        );
+    }
+
+    /**
+     * @brief 将所有列搬移到容量为capacity的新内存中
+     * @param capacity 新的容量，不小于size()
+     */
+    void M_relocate(size_type capacity) {
+        Storage s = this->M_allocate(capacity);
+        try {
+            M_move_columns(s);
+        } catch (...) {
+            this->M_deallocate(s);
+            throw;
+        }
+        M_replace_storage(s, capacity);
+    }
+
+    /**
+     * @brief 容量已满时追加一行
+     * @details 先在新内存中构造新行，再搬移原有的行，
+     * 参数引用容器中的元素时也能正确处理
+     * @param args 各列的构造参数
+     */
+    template <typename... Args>
+    void M_realloc_append(Args&&... args) {
+        if (this->M_size == max_size()) {
+            throw std::length_error("SoAVector::emplace_back");
+        }
+        const size_type capacity = std::min(
+            max_size(), this->M_size + std::max<size_type>(this->M_size, 1)
+        );
+        Storage s = this->M_allocate(capacity);
+        try {
+            M_construct_row(
+                s.columns, this->M_size, indices{},
+                std::forward<Args>(args)...
+            );
+        } catch (...) {
+            this->M_deallocate(s);
+            throw;
+        }
+        try {
+            M_move_columns(s);
+        } catch (...) {
+            M_destroy_rows(s.columns, this->M_size, 1, indices{});
+            this->M_deallocate(s);
+            throw;
+        }
+        M_replace_storage(s, capacity);
+    }
+
+    /**
+     * @brief 析构原有的行并释放原来的内存，换为新内存
+     * @param s 新内存，前size()行已构造
+     * @param capacity 新的容量
+     */
+    void M_replace_storage(Storage& s, size_type capacity) noexcept {
+        M_destroy_rows(this->M_storage.columns, 0, this->M_size, indices{});
+        this->M_deallocate(this->M_storage);
+        this->M_storage = s;
+        this->M_capacity = capacity;
+    }
+
+    /**
+     * @brief 检查下标是否有效
+     * @throw std::out_of_range 下标不小于size()
+     */
+    void M_check_index(size_type i) const {
+        if (i >= this->M_size) {
+            throw std::out_of_range("SoAVector::at");
+        }
+    }
+};
+
+/**
+ * @brief 使用user::Allocator的按列存储数组
+ * @tparam Ts 各列的类型
+ */
+template <NotConstVolatile... Ts>
+using SoAVector = BasicSoAVector<Allocator<std::byte>, Ts...>;
+
+}  // namespace user
+
+#endif  // SOA_VECTOR_HPP
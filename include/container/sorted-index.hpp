@@ -0,0 +1,251 @@
+/* UTF-8 */
+/**
+ * @file sorted-index.hpp
+ * @brief user::SortedIndex类，对有序数据进行大量查找的静态索引
+ * @details std::lower_bound每一步的分支几乎无法预测，并且大数组上每一层都是
+ * 一次缓存未命中。SortedIndex提供两种布局:
+ * Sorted:有序数组上的无分支二分查找，每步预取下一步可能访问的两个位置;
+ * Eytzinger:按完全二叉树的层序(BFS)存放元素，第k个结点的孩子为2k与2k+1，
+ * 靠近根的结点集中在少数缓存行中，每步预取若干层之后的全部后代所在的缓存行。
+ * 默认能放进一级缓存的小数组使用Sorted，更大的数组使用Eytzinger
+ */
+
+#ifndef SORTED_INDEX_HPP
+#define SORTED_INDEX_HPP
+
+#include <bit>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <userconcept/myconcept.hpp>
+
+namespace user {
+
+/**
+ * @enum SearchLayout
+ * @brief SortedIndex的存储布局
+ */
+enum class SearchLayout {
+    Auto,      // 根据数据大小选择
+    Sorted,    // 有序数组，无分支二分查找
+    Eytzinger  // 层序存放的完全二叉树
+};
+
+/**
+ * @class SortedIndex
+ * @brief 对有序数据进行lower_bound/upper_bound查找的只读索引
+ * @details 查找结果为元素在原有序数组中的下标，与std::lower_bound一致
+ * @tparam Tp 元素类型
+ * @tparam Compare 比较函数类型，原数组必须按此比较函数有序
+ * @tparam Alloc 分配器类型
+ */
+template <
+    typename Tp, typename Compare = std::less<>,
+    IsAllocator Alloc = std::allocator<Tp>>
+class SortedIndex {
+public:
+    using value_type = Tp;            // 元素类型
+    using size_type = std::size_t;    // 下标类型
+    using key_compare = Compare;      // 比较函数类型
+    using allocator_type = Alloc;     // 分配器类型
+
+    // 数据超过此字节数时Auto选择Eytzinger布局。benchmark/sorted-index-bench
+    // 中数据在一级缓存内时两种布局相当，超出一级缓存后Eytzinger更快
+    static constexpr size_type eytzinger_threshold = size_type{1} << 15;
+
+    /**
+     * @brief 由有序的Vector建立索引
+     * @param sorted 按comp有序的数据
+     * @param layout 存储布局
+     * @param comp 比较函数
+     * @throw std::invalid_argument 数据不是有序的
+     */
+    explicit SortedIndex(
+        const Vector<Tp, Alloc>& sorted, SearchLayout layout = SearchLayout::Auto,
+        Compare comp = Compare()
+    )
+        : comp(comp),
+          n(sorted.size()),
+          layout(S_choose(layout, sorted.size())),
+          keys(sorted.get_allocator()) {
+        if (!std::is_sorted(sorted.begin(), sorted.end(), this->comp)) {
+            throw std::invalid_argument("SortedIndex: data is not sorted");
+        }
+        if (this->layout == SearchLayout::Sorted || n == 0) {
+            keys = sorted;
+            return;
+        }
+        // 下标0不使用，使结点k的孩子为2k和2k+1
+        keys = Vector<Tp, Alloc>(n + 1, sorted.front(), sorted.get_allocator());
+        size_type i = 0;
+        M_build(sorted.begin(), i, 1);
+    }
+
+    /**
+     * @brief 获取索引中的元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept { return n; }
+
+    /**
+     * @brief 获取实际使用的布局
+     */
+    [[nodiscard]] SearchLayout get_layout() const noexcept { return layout; }
+
+    /**
+     * @brief 查找第一个不小于key的元素
+     * @param key 查找的键
+     * @return 该元素在原有序数组中的下标，不存在时返回size()
+     */
+    [[nodiscard]] size_type lower_bound(const Tp& key) const {
+        return M_search(
+            [this, &key](const Tp& x) { return comp(x, key); }
+        );
+    }
+
+    /**
+     * @brief 查找第一个大于key的元素
+     * @param key 查找的键
+     * @return 该元素在原有序数组中的下标，不存在时返回size()
+     */
+    [[nodiscard]] size_type upper_bound(const Tp& key) const {
+        return M_search(
+            [this, &key](const Tp& x) { return !comp(key, x); }
+        );
+    }
+
+    /**
+     * @brief 查找与key等价的元素
+     * @param key 查找的键
+     * @return 第一个与key等价的元素的下标，不存在时返回size()
+     */
+    [[nodiscard]] size_type find(const Tp& key) const {
+        const auto less = [this, &key](const Tp& x) { return comp(x, key); };
+        if (layout == SearchLayout::Sorted) {
+            const size_type i = M_sorted_search(less);
+            return i != n && !comp(key, keys.begin()[i]) ? i : n;
+        }
+        const size_type k = M_eytzinger_search(less);
+        return k != 0 && !comp(key, keys.begin()[k]) ? M_rank(k) : n;
+    }
+
+    /**
+     * @brief 判断是否存在与key等价的元素
+     */
+    [[nodiscard]] bool contains(const Tp& key) const {
+        return find(key) != n;
+    }
+
+private:
+    /**
+     * @brief 选择实际使用的布局
+     */
+    static SearchLayout S_choose(SearchLayout layout, size_type n) noexcept {
+        if (layout != SearchLayout::Auto) {
+            return layout;
+        }
+        return n * sizeof(Tp) > eytzinger_threshold ? SearchLayout::Eytzinger
+                                                    : SearchLayout::Sorted;
+    }
+
+    /**
+     * @brief 中序遍历完全二叉树，依次填入有序的元素
+     * @param sorted 有序数据
+     * @param i 下一个要填入的元素的下标
+     * @param k 当前结点
+     */
+    void M_build(const Tp* sorted, size_type& i, size_type k) {
+        if (k > n) {
+            return;
+        }
+        M_build(sorted, i, 2 * k);
+        keys.begin()[k] = sorted[i++];
+        M_build(sorted, i, 2 * k + 1);
+    }
+
+    /**
+     * @brief 查找第一个使less(x)为false的元素
+     * @param less 对前一部分元素为true、后一部分为false的谓词
+     * @return 该元素在原有序数组中的下标
+     */
+    template <typename Less>
+    size_type M_search(const Less& less) const {
+        if (layout == SearchLayout::Sorted) {
+            return M_sorted_search(less);
+        }
+        const size_type k = M_eytzinger_search(less);
+        return k == 0 ? n : M_rank(k);
+    }
+
+    /**
+     * @brief 计算Eytzinger布局中结点k在原有序数组中的下标
+     * @details 把树补成满二叉树，结点k的中序下标可以由k的二进制直接算出;
+     * 最后一层缺少的结点都在右侧，减去排在k之前的缺失结点即可
+     * @param k 结点，1 <= k <= n
+     */
+    size_type M_rank(size_type k) const noexcept {
+        const int h = static_cast<int>(std::bit_width(n)) - 1;  // 最后一层
+        const int d = static_cast<int>(std::bit_width(k)) - 1;  // k所在层
+        const size_type first = size_type{1} << h;  // 最后一层的第一个结点
+        // 满二叉树中的中序下标
+        const size_type full = ((2 * k + 1) << (h - d)) - 2 * first - 1;
+        // 满二叉树中排在k之前的最后一层结点个数，以及实际存在的个数
+        const size_type leaves = (full + 1) / 2;
+        const size_type present = n - first + 1;
+        return leaves > present ? full - (leaves - present) : full;
+    }
+
+    /**
+     * @brief 在有序数组上无分支地二分查找
+     * @param less 对前一部分元素为true、后一部分为false的谓词
+     * @return 第一个使less(x)为false的元素的下标
+     */
+    template <typename Less>
+    size_type M_sorted_search(const Less& less) const {
+        if (n == 0) {
+            return 0;
+        }
+        const Tp* const data = keys.begin();
+        const Tp* base = data;
+        size_type len = n;
+        while (len > 1) {
+            const size_type half = len / 2;
+            // 下一步只可能访问这两个位置之一
+            __builtin_prefetch(base + half / 2);
+            __builtin_prefetch(base + half + half / 2);
+            base += less(base[half - 1]) * half;
+            len -= half;
+        }
+        return static_cast<size_type>(base - data) + less(*base);
+    }
+
+    /**
+     * @brief 在Eytzinger布局上查找
+     * @param less 对前一部分元素为true、后一部分为false的谓词
+     * @return 第一个使less(x)为false的元素所在的结点，不存在时返回0
+     */
+    template <typename Less>
+    size_type M_eytzinger_search(const Less& less) const {
+        const Tp* const data = keys.begin();
+        // 一个缓存行中的元素个数，结点k在log2(line)层之后的line个后代
+        // 从k * line开始连续存放
+        constexpr size_type line = sizeof(Tp) < 64 ? 64 / sizeof(Tp) : 1;
+        size_type k = 1;
+        while (k <= n) {
+            __builtin_prefetch(data + std::min(k * line, n));
+            k = 2 * k + less(data[k]);
+        }
+        // 末尾的1是最后一次向左之后的向右，去掉它们和那次向左即为答案所在的结点
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    [[no_unique_address]] Compare comp;  // 比较函数
+    size_type n;                         // 元素个数
+    SearchLayout layout;                 // 实际使用的布局
+    Vector<Tp, Alloc> keys;              // 按布局存放的元素
+};
+
+}  // namespace user
+
+#endif  // SORTED_INDEX_HPP
@@ -0,0 +1,640 @@
+/* UTF-8 */
+/**
+ * @file stable-vector.hpp
+ * @brief 实现分段存储的StableVector类
+ * @details 元素存放在容量按2的幂增长的段中，第k段的容量为B * 2^k
+ * (B为第一段的容量，也是2的幂)。下标i加上B之后最高位的位置给出段号，
+ * 去掉最高位就是段内偏移，随机访问只需要几条位运算指令。
+ * 扩容只分配新的段，已有元素从不移动，元素地址在其被删除前一直有效。
+ * 段目录本身也分配在堆上，交换或移动容器时只交换目录指针，
+ * 迭代器随元素一起转移到另一个容器
+ */
+
+#ifndef STABLE_VECTOR_HPP
+#define STABLE_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @struct StableVectorBase
+ * @brief StableVector的基类，负责段目录以及各段内存的分配和释放
+ * (不执行构造和析构)
+ * @tparam Tp 对象类型
+ * @tparam Alloc 分配器类型
+ */
+template <typename Tp, IsAllocator Alloc>
+struct StableVectorBase {
+    // 将内存分配器重绑定类型，保证分配器分配的数值类型与Tp相同
+    using Tp_alloc_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Tp>;
+    // 获取分配器特性类型
+    using Tr = std::allocator_traits<Tp_alloc_type>;
+    // 获取类型对应的指针类型
+    using pointer = typename Tr::pointer;
+    // 段目录的分配器类型
+    using Dir_alloc_type = typename Tr::template rebind_alloc<pointer>;
+    // 段目录的分配器特性类型
+    using Dir_traits = std::allocator_traits<Dir_alloc_type>;
+
+    // 第一段容量的以2为底的对数，使第一段约占256字节
+    static constexpr std::size_t S_first_shift = std::bit_width(
+        std::max<std::size_t>(256 / sizeof(Tp), 1)
+    ) - 1;
+    // 第一段的容量
+    static constexpr std::size_t S_first_size = std::size_t{1}
+                                                << S_first_shift;
+    // 段目录的大小，足以覆盖size_t能表示的所有下标
+    static constexpr std::size_t S_max_segments =
+        sizeof(std::size_t) * 8 - S_first_shift;
+
+    // 无状态分配器不占用空间
+    [[no_unique_address]] Tp_alloc_type alloc;
+
+    pointer* M_segments = nullptr;    // 段目录，分配第一段时创建
+    std::size_t M_segment_count = 0;  // 已分配的段数
+    std::size_t M_size = 0;           // 元素个数
+
+    StableVectorBase() = default;
+
+    /**
+     * @brief 使用指定的分配器构造
+     * @param a 分配器
+     */
+    explicit StableVectorBase(const Tp_alloc_type& a) noexcept : alloc(a) {}
+
+    StableVectorBase(const StableVectorBase&) = delete;
+    StableVectorBase& operator=(const StableVectorBase&) = delete;
+
+    /**
+     * @brief 析构函数，释放所有段和段目录的内存
+     */
+    ~StableVectorBase() noexcept {
+        M_deallocate_segments(0);
+        if (M_segments != nullptr) {
+            Dir_alloc_type dir_alloc(alloc);
+            Dir_traits::deallocate(dir_alloc, M_segments, S_max_segments);
+        }
+    }
+
+    /**
+     * @brief 获取第k段的容量
+     */
+    static constexpr std::size_t S_segment_size(std::size_t k) noexcept {
+        return S_first_size << k;
+    }
+
+    /**
+     * @brief 获取前k段的总容量
+     */
+    static constexpr std::size_t S_capacity(std::size_t k) noexcept {
+        return S_first_size * ((std::size_t{1} << k) - 1);
+    }
+
+    /**
+     * @brief 读取段目录中的一项
+     * @note 并发容器的段目录由原子指针组成，已发布元素所在的段不会再改变，
+     * relaxed读取即可
+     */
+    static constexpr pointer S_load(const pointer& segment) noexcept {
+        return segment;
+    }
+    static pointer S_load(const std::atomic<pointer>& segment) noexcept {
+        return segment.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 根据下标计算元素的地址
+     * @tparam Segment 段目录项的类型，为pointer或std::atomic<pointer>
+     * @param segments 段目录
+     * @param i 下标
+     * @return 元素的指针
+     */
+    template <typename Segment>
+    static constexpr pointer S_locate(
+        const Segment* segments, std::size_t i
+    ) noexcept {
+        const std::size_t j = i + S_first_size;
+        const std::size_t h = std::bit_width(j) - 1;
+        return S_load(segments[h - S_first_shift]) +
+               (j ^ (std::size_t{1} << h));
+    }
+
+    /**
+     * @brief 分配下一段内存
+     */
+    void M_allocate_segment() {
+        if (M_segment_count == S_max_segments) {
+            throw std::length_error("StableVector: too many segments");
+        }
+        if (M_segments == nullptr) {
+            // 段目录的大小固定，之后不再重新分配，迭代器可以保存其地址
+            Dir_alloc_type dir_alloc(alloc);
+            M_segments = Dir_traits::allocate(dir_alloc, S_max_segments);
+            std::uninitialized_fill_n(M_segments, S_max_segments, pointer{});
+        }
+        M_segments[M_segment_count] =
+            Tr::allocate(alloc, S_segment_size(M_segment_count));
+        ++M_segment_count;
+    }
+
+    /**
+     * @brief 释放从第first段开始的所有段
+     * @param first 第一个需要释放的段
+     */
+    void M_deallocate_segments(std::size_t first) noexcept {
+        for (std::size_t k = first; k < M_segment_count; ++k) {
+            Tr::deallocate(alloc, M_segments[k], S_segment_size(k));
+            M_segments[k] = pointer{};
+        }
+        M_segment_count = std::min(M_segment_count, first);
+    }
+
+    /**
+     * @brief 交换两个对象的段目录和元素个数
+     * @param other 另一对象
+     */
+    void M_swap_data(StableVectorBase& other) noexcept {
+        std::swap(M_segments, other.M_segments);
+        std::swap(M_segment_count, other.M_segment_count);
+        std::swap(M_size, other.M_size);
+    }
+};
+
+/**
+ * @class StableVectorIterator
+ * @brief StableVector的随机访问迭代器，保存段目录的地址和下标
+ * @tparam Base StableVectorBase类型
+ * @tparam Const 是否为常量迭代器
+ * @tparam Segment 段目录项的类型
+ */
+template <typename Base, bool Const, typename Segment = typename Base::pointer>
+class StableVectorIterator {
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = typename Base::Tr::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<Const, const value_type&, value_type&>;
+
+    StableVectorIterator() = default;
+
+    /**
+     * @brief 由段目录和下标构造
+     */
+    StableVectorIterator(const Segment* segments, std::size_t index)
+        : segments(segments), index(index) {}
+
+    /**
+     * @brief 由非常量迭代器构造常量迭代器
+     */
+    StableVectorIterator(
+        const StableVectorIterator<Base, !Const, Segment>& other
+    )
+        requires Const
+        : segments(other.segments), index(other.index) {}
+
+    reference operator*() const { return *Base::S_locate(segments, index); }
+    pointer operator->() const { return Base::S_locate(segments, index); }
+    reference operator[](difference_type n) const {
+        return *Base::S_locate(segments, index + n);
+    }
+
+    StableVectorIterator& operator++() {
+        ++index;
+        return *this;
+    }
+    StableVectorIterator operator++(int) {
+        StableVectorIterator tmp = *this;
+        ++index;
+        return tmp;
+    }
+    StableVectorIterator& operator--() {
+        --index;
+        return *this;
+    }
+    StableVectorIterator operator--(int) {
+        StableVectorIterator tmp = *this;
+        --index;
+        return tmp;
+    }
+    StableVectorIterator& operator+=(difference_type n) {
+        index += n;
+        return *this;
+    }
+    StableVectorIterator& operator-=(difference_type n) {
+        index -= n;
+        return *this;
+    }
+    friend StableVectorIterator operator+(
+        StableVectorIterator it, difference_type n
+    ) {
+        return it += n;
+    }
+    friend StableVectorIterator operator+(
+        difference_type n, StableVectorIterator it
+    ) {
+        return it += n;
+    }
+    friend StableVectorIterator operator-(
+        StableVectorIterator it, difference_type n
+    ) {
+        return it -= n;
+    }
+    friend difference_type operator-(
+        const StableVectorIterator& a, const StableVectorIterator& b
+    ) {
+        return static_cast<difference_type>(a.index - b.index);
+    }
+    friend bool operator==(
+        const StableVectorIterator& a, const StableVectorIterator& b
+    ) {
+        return a.index == b.index;
+    }
+    friend std::strong_ordering operator<=>(
+        const StableVectorIterator& a, const StableVectorIterator& b
+    ) {
+        return a.index <=> b.index;
+    }
+
+private:
+    template <typename, bool, typename>
+    friend class StableVectorIterator;
+
+    const Segment* segments = nullptr;  // 段目录
+    std::size_t index = 0;              // 下标
+};
+
+/**
+ * @class StableVector
+ * @brief 元素地址稳定的分段可变数组
+ * @details 尾部插入不会移动已有元素，指向元素的指针、引用和迭代器在该元素
+ * 被删除之前一直有效，交换或移动容器后指向另一容器中的同一元素;
+ * 随机访问为O(1)，但元素不是连续存放的。
+ * 空容器还没有段目录，此时得到的begin()和end()在第一次插入后失效
+ * @tparam Tp 要存储的数据类型，不可为const或volatile修饰类型
+ * @tparam Alloc 分配器类型，分配的类型需要与Tp相同
+ */
+template <NotConstVolatile Tp, IsAllocator Alloc = Allocator<Tp>>
+    requires SameTypeAlloc<Tp, Alloc>
+class StableVector : protected StableVectorBase<Tp, Alloc> {
+    using Base = StableVectorBase<Tp, Alloc>;       // 基类
+    using Tp_alloc_type = typename Base::Tp_alloc_type;
+    using Alloc_traits = typename Base::Tr;          // 分配器特性
+
+public:
+    using value_type = Tp;                                 // 数值类型
+    using pointer = typename Base::pointer;                // 指针类型
+    using const_pointer = typename Alloc_traits::const_pointer;
+    using reference = Tp&;                                 // 引用类型
+    using const_reference = const Tp&;                     // 常量引用类型
+    using iterator = StableVectorIterator<Base, false>;    // 迭代器
+    using const_iterator = StableVectorIterator<Base, true>;  // 常量迭代器
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using size_type = std::size_t;           // 元素个数类型
+    using difference_type = std::ptrdiff_t;  // 迭代器差值类型
+    using allocator_type = Alloc;            // 分配器类型
+
+    StableVector() = default;
+
+    /**
+     * @brief 使用指定的分配器构造空容器
+     * @param a 分配器
+     */
+    explicit StableVector(const allocator_type& a) noexcept : Base(a) {}
+
+    /**
+     * @brief 构造n个value
+     * @param n 元素个数
+     * @param value 元素的值
+     * @param a 分配器
+     */
+    StableVector(
+        size_type n, const value_type& value,
+        const allocator_type& a = allocator_type()
+    )
+        : Base(a) {
+        reserve(n);
+        try {
+            for (size_type i = 0; i < n; ++i) {
+                emplace_back(value);
+            }
+        } catch (...) {
+            // 析构已构造的元素，段的内存由基类析构函数释放
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 根据初始化列表构造
+     * @param l 初始化列表
+     */
+    StableVector(std::initializer_list<value_type> l) {
+        M_range_init(l.begin(), l.end(), l.size());
+    }
+
+    /**
+     * @brief 复制构造函数
+     * @param other 需要复制的StableVector
+     */
+    StableVector(const StableVector& other)
+        : Base(Alloc_traits::select_on_container_copy_construction(
+              other.alloc
+          )) {
+        M_range_init(other.begin(), other.end(), other.size());
+    }
+
+    /**
+     * @brief 移动构造函数，直接接管段目录
+     * @param other 右值StableVector
+     */
+    StableVector(StableVector&& other) noexcept : Base(other.alloc) {
+        this->M_swap_data(other);
+    }
+
+    /**
+     * @brief 析构函数，析构所有元素
+     */
+    ~StableVector() noexcept { clear(); }
+
+    /**
+     * @brief 复制赋值运算符
+     * @param other 另一StableVector
+     * @return 当前对象的引用
+     */
+    StableVector& operator=(const StableVector& other) {
+        if (this != std::addressof(other)) {
+            StableVector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 移动赋值运算符，交换两个容器的内容
+     * @param other 另一右值StableVector
+     * @return 当前对象的引用
+     */
+    StableVector& operator=(StableVector&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    /**
+     * @brief 交换两个容器的内容
+     * @param other 另一StableVector
+     */
+    void swap(StableVector& other) noexcept {
+        this->M_swap_data(other);
+        if constexpr (Alloc_traits::propagate_on_container_swap::value ||
+                      Alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            std::swap(this->alloc, other.alloc);
+        }
+    }
+
+    /**
+     * @brief 获取容器的分配器
+     */
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(this->alloc);
+    }
+
+    /**
+     * @brief 按下标访问元素
+     * @param i 下标，必须小于size()
+     */
+    [[nodiscard]] reference operator[](size_type i) noexcept {
+        return *Base::S_locate(this->M_segments, i);
+    }
+    [[nodiscard]] const_reference operator[](size_type i) const noexcept {
+        return *Base::S_locate(this->M_segments, i);
+    }
+
+    /**
+     * @brief 按下标访问元素并检查范围
+     * @param i 下标
+     * @throw std::out_of_range 下标不小于size()
+     */
+    [[nodiscard]] reference at(size_type i) {
+        M_check_index(i);
+        return (*this)[i];
+    }
+    [[nodiscard]] const_reference at(size_type i) const {
+        M_check_index(i);
+        return (*this)[i];
+    }
+
+    [[nodiscard]] reference front() noexcept { return (*this)[0]; }
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+    [[nodiscard]] reference back() noexcept { return (*this)[size() - 1]; }
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        return iterator(this->M_segments, 0);
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this->M_segments, 0);
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator(this->M_segments, this->M_size);
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this->M_segments, this->M_size);
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+    [[nodiscard]] reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 获取元素个数
+     */
+    [[nodiscard]] size_type size() const noexcept { return this->M_size; }
+
+    /**
+     * @brief 判断容器是否为空
+     */
+    [[nodiscard]] bool empty() const noexcept { return this->M_size == 0; }
+
+    /**
+     * @brief 获取已分配的段能容纳的元素个数
+     */
+    [[nodiscard]] size_type capacity() const noexcept {
+        return Base::S_capacity(this->M_segment_count);
+    }
+
+    /**
+     * @brief 预留至少n个元素的容量
+     * @param n 需要的容量
+     * @note 只分配新的段，已有元素不会移动
+     */
+    void reserve(size_type n) {
+        while (capacity() < n) {
+            this->M_allocate_segment();
+        }
+    }
+
+    /**
+     * @brief 释放没有元素的段
+     */
+    void shrink_to_fit() noexcept {
+        size_type k = 0;
+        while (Base::S_capacity(k) < this->M_size) {
+            ++k;
+        }
+        this->M_deallocate_segments(k);
+    }
+
+    /**
+     * @brief 在末尾构造新元素
+     * @param args 构造函数参数
+     * @return 新元素的引用
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (this->M_size == capacity()) {
+            this->M_allocate_segment();
+        }
+        pointer p = Base::S_locate(this->M_segments, this->M_size);
+        Alloc_traits::construct(this->alloc, p, std::forward<Args>(args)...);
+        ++this->M_size;
+        return *p;
+    }
+
+    /**
+     * @brief 在末尾插入元素
+     * @param value 元素的值
+     */
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+
+    /**
+     * @brief 删除最后一个元素
+     * @note 容器不能为空，段的内存不会释放
+     */
+    void pop_back() noexcept {
+        --this->M_size;
+        Alloc_traits::destroy(
+            this->alloc, Base::S_locate(this->M_segments, this->M_size)
+        );
+    }
+
+    /**
+     * @brief 调整元素个数，新增的元素值初始化
+     * @param n 新的元素个数
+     */
+    void resize(size_type n) {
+        while (this->M_size > n) {
+            pop_back();
+        }
+        reserve(n);
+        while (this->M_size < n) {
+            emplace_back();
+        }
+    }
+
+    /**
+     * @brief 析构所有元素，保留已分配的段
+     */
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Tp>) {
+            // 逐段析构，避免每个元素都计算地址
+            size_type remaining = this->M_size;
+            for (size_type k = 0; remaining != 0; ++k) {
+                const size_type count =
+                    std::min(remaining, Base::S_segment_size(k));
+                const pointer segment = this->M_segments[k];
+                for (size_type j = 0; j < count; ++j) {
+                    Alloc_traits::destroy(this->alloc, segment + j);
+                }
+                remaining -= count;
+            }
+        }
+        this->M_size = 0;
+    }
+
+    /**
+     * @brief 对每一段中连续存放的元素调用f
+     * @param f 以(指向第一个元素的指针, 元素个数)为参数的可调用对象
+     * @note 用于需要连续内存的批量处理(如向量化)
+     */
+    template <typename F>
+    void for_each_segment(F&& f) {
+        size_type remaining = this->M_size;
+        for (size_type k = 0; remaining != 0; ++k) {
+            const size_type count =
+                std::min(remaining, Base::S_segment_size(k));
+            f(this->M_segments[k], count);
+            remaining -= count;
+        }
+    }
+
+private:
+    /**
+     * @brief 构造时依次复制范围内的元素
+     * @details 复制中途抛出异常时析构已构造的元素，段的内存由基类
+     * 析构函数释放
+     * @param first 起始迭代器
+     * @param last 终止迭代器
+     * @param n 元素个数
+     */
+    template <typename InputIterator>
+    void M_range_init(InputIterator first, InputIterator last, size_type n) {
+        reserve(n);
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    /**
+     * @brief 检查下标是否有效
+     * @throw std::out_of_range 下标不小于size()
+     */
+    void M_check_index(size_type i) const {
+        if (i >= this->M_size) {
+            throw std::out_of_range("StableVector::at");
+        }
+    }
+};
+
+}  // namespace user
+
+#endif  // STABLE_VECTOR_HPP
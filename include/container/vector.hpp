@@ -6,11 +6,15 @@
 
 #ifndef VECTOR_HPP
 #define VECTOR_HPP
+#include <algorithm>
 #include <concepts>
 #include <container/vectorbase.hpp>
+#include <cstring>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <parallel/parallel-memory.hpp>
 #include <small-utility/smallutility.hpp>
 #include <userconcept/myconcept.hpp>
 namespace user {
@@ -31,6 +35,10 @@ class Vector : protected VectorBase<Tp, Alloc> {
     using Alloc_traits =
         std::allocator_traits<Tp_alloc_type>;  // 对应的分配器特性
 
+    // 分配器支持重新分配且元素可按字节搬移时，扩容不逐个移动元素
+    static constexpr bool S_use_reallocate =
+        IsReallocatable<Tp_alloc_type> && std::is_trivially_copyable_v<Tp>;
+
 public:
     // 一系列别名
     using value_type = Tp;                                       // 数值类型
@@ -50,11 +58,21 @@ public:
 
     Vector() = default;
 
+    /**
+     * @brief 使用指定的分配器构造空容器
+     * @param a 分配器
+     */
+    explicit constexpr Vector(const allocator_type& a) noexcept : Base(a) {}
+
     /**
      * @brief 根据元素个数初始化线性表，调用默认构造函数
      * @param n 需要分配的元素个数
+     * @param a 分配器
      */
-    explicit constexpr Vector(const size_type n) : Base(S_check_init_len(n)) {
+    explicit constexpr Vector(
+        const size_type n, const allocator_type& a = allocator_type()
+    )
+        : Base(S_check_init_len(n), a) {
         M_default_initialize(n);
     }
 
@@ -62,52 +80,34 @@ public:
      * @brief 根据传入的值批量初始化
      * @param n 需要的初始元素个数
      * @param value 需要赋的初值
+     * @param a 分配器
      */
-    constexpr Vector(const size_type n, const value_type& value)
-        : Base(S_check_init_len(n)) {
+    constexpr Vector(
+        const size_type n, const value_type& value,
+        const allocator_type& a = allocator_type()
+    )
+        : Base(S_check_init_len(n), a) {
         M_fill_initialize(n, value);
     }
     /**
      * @brief 复制构造函数
      * @param other 需要复制的user::Vector
      */
-    constexpr Vector(const Vector& other) : Base(other.size()) {
+    constexpr Vector(const Vector& other)
+        : Base(
+              other.size(), Alloc_traits::select_on_container_copy_construction(
+                                other.M_get_Tp_allocator()
+                            )
+          ) {
         this->M_finish =
-            std::uninitialized_copy(other.begin(), other.end(), this->begin());
-    }
-
-private:
-    /**
-     * @brief 当分配器总相同时直接转移指针
-     * @param rv 右值user::Vector
-     */
-    constexpr Vector(Vector&& rv, std::true_type) noexcept
-        : Base(std::move(rv)) {}
-    /**
-     * @brief 当分配器不是总相同的时候移动其值
-     * @param rv 右值user::Vector
-     */
-    constexpr Vector(Vector&& rv, std::false_type) {
-        if (!rv.empty()) {
-            this->M_create_storage(rv.size());
-            this->M_finish =
-                std::uninitialized_move(rv.begin(), rv.end(), this->begin());
-            // 将原来的对象清空
-            rv.clear();
-        }
+            S_uninitialized_copy(other.begin(), other.end(), this->begin());
     }
 
-public:
     /**
-     * @brief 移动构造函数
+     * @brief 移动构造函数，分配器随内存一起移动，因此总是直接转移指针
      * @param rv 右值user::Vector
      */
-    constexpr Vector(Vector&& rv) noexcept(noexcept(Vector(
-        std::declval<Vector&&>(),
-        std::declval<typename Alloc_traits::is_always_equal>(
-        )  // 判断分配器是否总是相同
-    )))
-        : Vector(std::move(rv), typename Alloc_traits::is_always_equal{}) {}
+    constexpr Vector(Vector&& rv) noexcept : Base(std::move(rv)) {}
 
     /**
      * @brief 根据初始化列表初始化user::Vector
@@ -190,16 +190,15 @@ public:
             // 如果 另一个元素的元素个数 <= 当前容器的元素个数
             // 将另一个容器复制到当前容器，并将多余的元素析构
             std::destroy(
-                std::copy(other.begin(), other.end(), this->begin()),
-                this->end()
+                S_copy(other.begin(), other.end(), this->begin()), this->end()
             );
         } else {
             // 如果 当前容器的元素个数 < 另一个容器的元素个数 < 当前容器的容量
             // 将容器有的元素赋值为另一个容器的相应元素，剩下的元素进行初始化复制
-            std::copy(
-                this->M_start, this->M_start + this->size(), this->M_start
+            S_copy(
+                other.M_start, other.M_start + this->size(), this->M_start
             );
-            std::uninitialized_copy(
+            S_uninitialized_copy(
                 other.M_start + this->size(), other.M_finish, this->M_finish
             );
         }
@@ -213,11 +212,53 @@ public:
      * @param other 另一右值Vector
      * @return 当前Vector的引用
      */
-    constexpr Vector& operator=(Vector&& other) noexcept {
-        this->M_swap_data(other);
+    constexpr Vector& operator=(Vector&& other) noexcept(
+        Alloc_traits::propagate_on_container_move_assignment::value ||
+        Alloc_traits::is_always_equal::value
+    ) {
+        if constexpr (Alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            this->M_swap_data(other);
+            // 分配器需要跟随内存一起转移
+            std::swap(this->M_get_Tp_allocator(), other.M_get_Tp_allocator());
+        } else if constexpr (Alloc_traits::is_always_equal::value) {
+            this->M_swap_data(other);
+        } else {
+            if (this->M_get_Tp_allocator() == other.M_get_Tp_allocator()) {
+                this->M_swap_data(other);
+            } else {
+                // 分配器不同时无法接管另一容器的内存，只能逐个移动元素
+                clear();
+                reserve(other.size());
+                this->M_finish = std::uninitialized_move(
+                    other.begin(), other.end(), this->M_start
+                );
+                other.clear();
+            }
+        }
         return *this;
     }
 
+    /**
+     * @brief 交换两个容器的内容
+     * @param other 另一Vector
+     * @note 分配器只在propagate_on_container_swap为true时交换
+     */
+    constexpr void swap(Vector& other) noexcept {
+        this->M_swap_data(other);
+        if constexpr (Alloc_traits::propagate_on_container_swap::value) {
+            std::swap(this->M_get_Tp_allocator(), other.M_get_Tp_allocator());
+        }
+    }
+
+    /**
+     * @brief 获取容器的分配器
+     * @return 分配器的副本
+     */
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept {
+        return allocator_type(this->M_get_Tp_allocator());
+    }
+
     /**
      * @brief 将容器以n个val进行填充
      * @param n 填充的元素个数
@@ -450,6 +491,65 @@ public:
         return back();
     }
 
+    /**
+     * @brief 删除指定位置的元素，后面的元素依次前移
+     * @param position 需要删除的元素的位置
+     * @return 指向被删除元素后一元素的迭代器
+     */
+    constexpr iterator erase(const_iterator position) {
+        const iterator pos = begin() + (position - cbegin());
+        if (pos + 1 != end()) {
+            std::move(pos + 1, end(), pos);
+        }
+        M_erase_at_end(this->M_finish - 1);
+        return pos;
+    }
+
+    /**
+     * @brief 删除范围[first, last)中的元素，后面的元素依次前移
+     * @param first 指向第一个需要删除的元素的迭代器
+     * @param last 指向最后一个需要删除的元素的后一位置的迭代器
+     * @return 指向被删除范围后一元素的迭代器
+     */
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        const iterator f = begin() + (first - cbegin());
+        if (first != last) {
+            const iterator l = begin() + (last - cbegin());
+            M_erase_at_end(std::move(l, end(), f));
+        }
+        return f;
+    }
+
+    /**
+     * @brief 用最后一个元素替换指定位置的元素，O(1)删除但不保持顺序
+     * @param position 需要删除的元素的位置
+     * @return 指向原位置的迭代器，此处现在是原来的最后一个元素
+     */
+    constexpr iterator unordered_erase(const_iterator position) {
+        const iterator pos = begin() + (position - cbegin());
+        if (pos + 1 != end()) {
+            *pos = std::move(back());
+        }
+        M_erase_at_end(this->M_finish - 1);
+        return pos;
+    }
+
+    /**
+     * @brief 删除所有满足谓词的元素，保持其余元素的顺序
+     * @details 单次遍历，将保留的元素依次前移后析构末尾的元素
+     * @tparam Pred 一元谓词类型
+     * @param pred 判断元素是否需要删除的谓词
+     * @return 删除的元素个数
+     * @note 对算术类型使用向量化实现见simd-compact.hpp中的user::erase_if
+     */
+    template <typename Pred>
+    constexpr size_type erase_if(Pred pred) {
+        const pointer new_finish = std::remove_if(begin(), end(), pred);
+        const size_type removed = this->M_finish - new_finish;
+        M_erase_at_end(new_finish);
+        return removed;
+    }
+
     /**
      * @brief 获取当前容器的理论最大容量
      * @return 当前容器理论容量上限
@@ -496,6 +596,13 @@ protected:
             // 如果剩余空间足够分配新元素,则直接在末尾构造
             this->M_finish =
                 std::uninitialized_default_construct_n(this->M_finish, n);
+        } else if constexpr (S_use_reallocate) {
+            // 分配器可直接扩容，无需移动原有元素
+            this->M_reallocate_storage(
+                M_check_len(n, "Vector::M_default_append")
+            );
+            this->M_finish =
+                std::uninitialized_default_construct_n(this->M_finish, n);
         } else {
             // 保存原来的旧指针
             pointer old_start = this->M_start;
@@ -646,7 +753,7 @@ protected:
         const size_type n = std::distance(first, last);
         this->M_start = this->M_allocate(S_check_init_len(n));
         this->M_end_of_shorage = this->M_start + n;
-        this->M_finish = std::uninitialized_copy(first, last, this->M_start);
+        this->M_finish = S_uninitialized_copy(first, last, this->M_start);
     }
 
     /**
@@ -685,7 +792,7 @@ protected:
     ) {
         pointer result = this->M_allocate(n);
         try {
-            std::uninitialized_copy(first, last, result);
+            S_uninitialized_copy(first, last, result);
             return result;
         } catch (...) {
             this->M_deallocate(result, n);
@@ -705,6 +812,11 @@ protected:
         if (n <= capacity()) {  // n不大于当前容量，不进行操作
             return;
         }
+        if constexpr (S_use_reallocate) {
+            // 分配器可直接扩容(如mremap)，不需要逐个移动元素
+            this->M_reallocate_storage(n);
+            return;
+        }
         // 分配新内存区域，记录内存地址
         pointer new_start = this->M_allocate(n);
         // 移动或复制原来的数据，并记录结束位置
@@ -732,7 +844,7 @@ protected:
     constexpr void M_fill_initialize(
         const size_type n, const value_type& value
     ) {
-        this->M_finish = std::uninitialized_fill_n(this->M_start, n, value);
+        this->M_finish = S_uninitialized_fill_n(this->M_start, n, value);
     }
 
     /**
@@ -743,20 +855,19 @@ protected:
     constexpr void M_fill_assign(size_type n, const value_type& val) {
         if (n > capacity()) {
             // 1. n比容器的容量要大
-            Vector tmp(n, val);
-            tmp.M_swap_data(this);
+            Vector tmp(n, val, get_allocator());
+            tmp.M_swap_data(*this);
         } else if (n > size()) {
             // 2. 如果 当前元素个数 < n < 容量
             // 将前面已有元素重新赋值
-            std::fill(begin(), end(), val);
+            S_fill_n(this->M_start, size(), val);
             const size_type add = n - size();  // 需要构造的元素个数
             // 填充后面需要构造的部分
-            this->M_finish =
-                std::uninitialized_fill_n(this->M_finish, add, val);
+            this->M_finish = S_uninitialized_fill_n(this->M_finish, add, val);
         } else {
             // 3. n < 元素个数
             // 填充n个元素，将后面元素删除
-            M_erase_at_end(std::fill_n(this->M_start, n, val));
+            M_erase_at_end(S_fill_n(this->M_start, n, val));
         }
     }
     /**
@@ -770,6 +881,21 @@ protected:
         // 获取此时新分配内存存储的元素总个数
         const size_type len =
             M_check_len(static_cast<size_type>(1), "Vector::M_realloc_insert");
+        if constexpr (S_use_reallocate) {
+            // 参数可能引用原来内存中的元素，先构造出新元素
+            value_type tmp(std::forward<Args>(args)...);
+            const size_type elems_before = position - begin();
+            this->M_reallocate_storage(len);
+            pointer pos = this->M_start + elems_before;
+            // 将插入位置后面的元素后移一位
+            std::memmove(
+                static_cast<void*>(pos + 1), static_cast<const void*>(pos),
+                (this->M_finish - pos) * sizeof(value_type)
+            );
+            Alloc_traits::construct(this->alloc, pos, std::move(tmp));
+            ++this->M_finish;
+            return;
+        }
         pointer old_start = this->M_start;
         pointer old_finish = this->M_finish;
         // 这个位置前有多少元素
@@ -803,6 +929,82 @@ protected:
         this->M_end_of_shorage = new_start + len;
     }
 
+    /**
+     * @brief 以n个value构造未初始化的区间，数据量较大时并行构造
+     * @param first 区间起点
+     * @param n 元素个数
+     * @param value 填充的值
+     * @return 区间终点
+     */
+    static constexpr pointer S_uninitialized_fill_n(
+        pointer first, size_type n, const value_type& value
+    ) {
+        return parallel::uninitialized_fill_n(first, n, value);
+    }
+
+    /**
+     * @brief 以n个value为已有元素赋值，数据量较大时并行赋值
+     * @param first 区间起点
+     * @param n 元素个数
+     * @param value 填充的值
+     * @return 区间终点
+     */
+    static constexpr pointer S_fill_n(
+        pointer first, size_type n, const value_type& value
+    ) {
+        return parallel::fill_n(first, n, value);
+    }
+
+    /**
+     * @brief 将范围内的元素复制到未初始化的区间
+     * @details 源区间为连续内存且数据量较大时并行复制
+     * @tparam ForwardIterator 至少为前向迭代器类型
+     * @param first 指向第一个元素的迭代器
+     * @param last 指向最后一个元素的后一位置的迭代器
+     * @param result 目标区间起点
+     * @return 目标区间终点
+     */
+    template <std::forward_iterator ForwardIterator>
+    static constexpr pointer S_uninitialized_copy(
+        ForwardIterator first, ForwardIterator last, pointer result
+    ) {
+        if constexpr (std::contiguous_iterator<ForwardIterator> &&
+                      std::same_as<std::iter_value_t<ForwardIterator>,
+                                   value_type>) {
+            return parallel::uninitialized_copy_n(
+                std::to_address(first), static_cast<size_type>(last - first),
+                result
+            );
+        } else {
+            return std::uninitialized_copy(first, last, result);
+        }
+    }
+
+    /**
+     * @brief 将范围内的元素赋值给已有的元素
+     * @details 源区间为连续内存且数据量较大时并行复制
+     * @tparam ForwardIterator 至少为前向迭代器类型
+     * @param first 指向第一个元素的迭代器
+     * @param last 指向最后一个元素的后一位置的迭代器
+     * @param result 目标区间起点
+     * @return 目标区间终点
+     */
+    template <std::forward_iterator ForwardIterator>
+    static constexpr pointer S_copy(
+        ForwardIterator first, ForwardIterator last, pointer result
+    ) {
+        if constexpr (std::contiguous_iterator<ForwardIterator> &&
+                      std::same_as<std::iter_value_t<ForwardIterator>,
+                                   value_type>) {
+            return parallel::copy_n(
+                std::to_address(first), static_cast<size_type>(last - first),
+                result
+            );
+        } else {
+            return std::copy(first, last, result);
+        }
+    }
+
     /**
      * @brief 用于检测需要新分配的元素数量是否处于正常范围内
      * @param n 需要新分配的元素个数
@@ -869,6 +1071,11 @@ std::ostream& operator<<(std::ostream& os, Vector<Tp>& vec) {
     }
     return os;
 }
+
+// 无状态分配器不应增加Vector的大小，只保留三个指针
+static_assert(sizeof(Vector<int>) == 3 * sizeof(void*));
+static_assert(sizeof(Vector<int, Allocator<int>>) == 3 * sizeof(void*));
+
 }  // namespace user
 
 #endif  // VECTOR_HPP
@@ -26,7 +26,8 @@ struct VectorBase {
     // 获取分配器特性类型
     using Tr = std::allocator_traits<Tp_alloc_type>;
 
-    Tp_alloc_type alloc;
+    // 无状态分配器(如std::allocator与user::Allocator)不占用空间
+    [[no_unique_address]] Tp_alloc_type alloc;
 
     pointer M_start;           // 指向开始内存的指针
     pointer M_finish;          // 指向最后一个有效数据的后一位置的指针
@@ -52,6 +53,8 @@ struct VectorBase {
         tmp.M_copy_data(*this);
         M_copy_data(vb);
         vb.M_copy_data(tmp);
+        // tmp不再拥有内存，防止析构时将其释放
+        tmp.M_start = tmp.M_finish = tmp.M_end_of_shorage = pointer{};
     }
 
     /*
@@ -59,11 +62,18 @@ struct VectorBase {
      */
     constexpr VectorBase() noexcept
         : M_start(), M_finish(), M_end_of_shorage() {};
+    /**
+     * @brief 使用指定的分配器构造，将指针初始化
+     * @param a 分配器
+     */
+    constexpr explicit VectorBase(const Tp_alloc_type& a) noexcept
+        : alloc(a), M_start(), M_finish(), M_end_of_shorage() {};
     /*
-     * @brief 移动构造函数
+     * @brief 移动构造函数，分配器跟随移动
      */
     constexpr VectorBase(VectorBase&& other) noexcept
-        : M_start(other.M_start),
+        : alloc(std::move(other.alloc)),
+          M_start(other.M_start),
           M_finish(other.M_finish),
           M_end_of_shorage(other.M_end_of_shorage) {
         other.M_start = other.M_finish = other.M_end_of_shorage = pointer{};
@@ -74,6 +84,15 @@ struct VectorBase {
      */
     constexpr explicit VectorBase(const size_t n) { M_create_storage(n); }
 
+    /**
+     * @brief 使用指定的分配器根据元素个数分配内存
+     * @param n 需要分配内存的元素个数
+     * @param a 分配器
+     */
+    constexpr VectorBase(const size_t n, const Tp_alloc_type& a) : alloc(a) {
+        M_create_storage(n);
+    }
+
     /**
      * @brief 析构函数，释放所有分配的内存
      */
@@ -130,6 +149,20 @@ struct VectorBase {
         // 指向分配的内存的末地址
         this->M_end_of_shorage = this->M_start + n;
     }
+
+    /**
+     * @brief 通过分配器的reallocate重新分配内存，保留原有元素的字节内容
+     * @param n 新的容量
+     * @note 仅在分配器支持重新分配时可用，元素按字节搬移
+     */
+    constexpr void M_reallocate_storage(size_t n)
+        requires IsReallocatable<Tp_alloc_type>
+    {
+        const size_t size = M_finish - M_start;
+        M_start = alloc.reallocate(M_start, M_end_of_shorage - M_start, n);
+        M_finish = M_start + size;
+        M_end_of_shorage = M_start + n;
+    }
 };
 
 }  // namespace user
@@ -0,0 +1,255 @@
+/* UTF-8 */
+/**
+ * @file mmap-allocator.hpp
+ * @brief user::MmapAllocator类
+ * @details 大块内存使用匿名mmap分配，并使用mremap实现无复制的扩容，
+ * 可选地建议内核使用透明大页
+ */
+
+#ifndef MMAP_ALLOCATOR_HPP
+#define MMAP_ALLOCATOR_HPP 2
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <my-memory/my-allocator.hpp>
+#include <new>
+#include <type_traits>
+
+namespace user {
+
+/**
+ * @class MmapAllocator
+ * @brief 大块内存分配器
+ * @details 分配的字节数不小于Threshold时使用匿名mmap分配内存，
+ * 否则交给user::Allocator分配。提供reallocate()方法，对于mmap分配的
+ * 内存使用mremap(MREMAP_MAYMOVE)扩容，由内核重新映射页表而不复制数据
+ * @tparam T 数值类型
+ * @tparam Threshold 使用mmap分配的最小字节数，默认为1MB
+ * @tparam HugePages 是否对mmap分配的内存使用透明大页(MADV_HUGEPAGE)，
+ * 映射的首地址按2MB对齐，大小上取到2MB的整数倍，使每个2MB区域都可以
+ * 由一个大页映射。随机访问大块内存时可以减少TLB未命中
+ * @warning reallocate()按字节搬移内存，只可用于可平凡复制的类型
+ */
+template <
+    typename T, std::size_t Threshold = (std::size_t{1} << 20),
+    bool HugePages = false>
+class MmapAllocator {
+public:
+    // C++20 标准规定的类型成员
+    // 数值类型
+    using value_type = T;
+    // 内存分配的内存块尺寸信息类型
+    using size_type = std::size_t;
+    // 两指针之间距离类型
+    using difference_type = std::ptrdiff_t;
+    // 容器移动赋值时分配器跟随移动
+    using propagate_on_container_move_assignment = std::true_type;
+    // 两个内存分配器总是相同的
+    using is_always_equal = std::true_type;
+
+    /**
+     * @struct rebind
+     * @brief 重绑定为其他数值类型的分配器，保留阈值和大页参数
+     */
+    template <typename U>
+    struct rebind {
+        using other = MmapAllocator<U, Threshold, HugePages>;
+    };
+
+    MmapAllocator() = default;
+
+    /**
+     * @brief 从其他类型的分配器构造(用于分配器重绑定)
+     */
+    template <typename U>
+    constexpr MmapAllocator(
+        const MmapAllocator<U, Threshold, HugePages>&
+    ) noexcept {}
+
+    /**
+     * @brief 分配给对象分配内存
+     * @note 仅分配内存，不进行初始化操作
+     * @param n 需要分配内存的对象数目
+     * @return T* 指向对应内存区域的指针
+     * @throw std::bad_alloc 如果mmap分配失败
+     */
+    T* allocate(size_type n) {
+        if (!S_is_mapped(n)) {
+            return Allocator<T>{}.allocate(n);
+        }
+        void* p = S_map(S_map_size(n));
+        S_advise(p, n);
+        return static_cast<T*>(p);
+    }
+
+    /**
+     * @brief 释放对象内存
+     * @param p 指向需要释放的内存区域的指针
+     * @param n 分配时的对象数目，用于判断内存的来源
+     */
+    void deallocate(T* p, size_type n) {
+        if (!S_is_mapped(n)) {
+            Allocator<T>{}.deallocate(p, n);
+            return;
+        }
+        ::munmap(p, S_map_size(n));
+    }
+
+    /**
+     * @brief 重新分配内存，并保留前min(old_n, new_n)个对象的字节内容
+     * @param p 原来的内存区域，可为nullptr
+     * @param old_n 原来分配的对象数目
+     * @param new_n 新的对象数目
+     * @return 指向新内存区域的指针，原来的指针此后不可再使用
+     * @throw std::bad_alloc 如果分配失败，此时原来的内存区域不变
+     */
+    T* reallocate(T* p, size_type old_n, size_type new_n) {
+        if (p == nullptr) {
+            return allocate(new_n);
+        }
+        // 新旧内存均由mmap分配时直接重新映射
+        if (S_is_mapped(old_n) && S_is_mapped(new_n)) {
+            void* res = S_remap(p, S_map_size(old_n), S_map_size(new_n));
+            S_advise(res, new_n);
+            return static_cast<T*>(res);
+        }
+        // 其他情况分配新内存并复制内容
+        T* res = allocate(new_n);
+        std::memcpy(
+            static_cast<void*>(res), static_cast<const void*>(p),
+            std::min(old_n, new_n) * sizeof(T)
+        );
+        deallocate(p, old_n);
+        return res;
+    }
+
+private:
+    /**
+     * @brief 判断分配n个对象时是否使用mmap
+     * @param n 对象数目
+     * @return 字节数不小于阈值时返回true
+     */
+    static constexpr bool S_is_mapped(size_type n) noexcept {
+        return n * sizeof(T) >= Threshold;
+    }
+
+    /**
+     * @brief 计算n个对象映射时实际占用的字节数(上取到页大小的整数倍)
+     * @param n 对象数目
+     * @return 映射的字节数
+     */
+    static size_type S_map_size(size_type n) noexcept {
+        static const auto page = HugePages ? S_huge_page_size
+                                           : static_cast<size_type>(
+                                                 ::sysconf(_SC_PAGESIZE)
+                                             );
+        return (n * sizeof(T) + page - 1) & ~(page - 1);
+    }
+
+    /**
+     * @brief 映射一块匿名内存
+     * @param size 映射的字节数，为S_map_size()的结果
+     * @return 映射的首地址，使用大页时按2MB对齐
+     * @throw std::bad_alloc 如果mmap失败
+     * @details mmap只保证按普通页对齐，使用大页时多映射2MB，
+     * 再解除首尾多余的部分，剩下的映射恰好为size字节
+     */
+    static void* S_map(size_type size) {
+        const size_type extra = HugePages ? S_huge_page_size : 0;
+        void* p = ::mmap(
+            nullptr, size + extra, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+        );
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if constexpr (HugePages) {
+            auto* first = static_cast<char*>(p);
+            auto* aligned = reinterpret_cast<char*>(
+                (reinterpret_cast<std::uintptr_t>(first) + extra - 1) &
+                ~(extra - 1)
+            );
+            const auto head = static_cast<size_type>(aligned - first);
+            if (head != 0) {
+                ::munmap(first, head);
+            }
+            if (head != extra) {
+                ::munmap(aligned + size, extra - head);
+            }
+            p = aligned;
+        }
+        return p;
+    }
+
+    /**
+     * @brief 改变映射的大小，不复制数据
+     * @param p 原来映射的首地址
+     * @param old_size 原来映射的字节数
+     * @param new_size 新映射的字节数
+     * @return 新映射的首地址，使用大页时仍按2MB对齐
+     * @throw std::bad_alloc 如果重新映射失败，此时原来的映射不变
+     * @details 不使用大页时直接mremap(MREMAP_MAYMOVE)。使用大页时先尝试
+     * 原地调整；不能原地扩大时先用S_map()占据一块对齐的区域，
+     * 再用MREMAP_FIXED把原来的页表移动过去，避免内核选择未对齐的地址
+     */
+    static void* S_remap(void* p, size_type old_size, size_type new_size) {
+        if constexpr (HugePages) {
+            void* res = ::mremap(p, old_size, new_size, 0);
+            if (res != MAP_FAILED) {
+                return res;
+            }
+            void* target = S_map(new_size);
+            res = ::mremap(
+                p, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, target
+            );
+            if (res == MAP_FAILED) {
+                ::munmap(target, new_size);
+                throw std::bad_alloc();
+            }
+            return res;
+        } else {
+            void* res = ::mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+            if (res == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return res;
+        }
+    }
+
+    /**
+     * @brief 建议内核对映射的内存使用透明大页
+     * @param p 映射的首地址
+     * @param n 对象数目
+     * @note 内核不支持或关闭了透明大页时忽略失败，仍然使用普通页
+     */
+    static void S_advise(void* p, size_type n) noexcept {
+        if constexpr (HugePages) {
+            ::madvise(p, S_map_size(n), MADV_HUGEPAGE);
+        }
+    }
+
+    // 透明大页的大小
+    static constexpr size_type S_huge_page_size = size_type{1} << 21;
+};
+
+/**
+ * @brief 分配器==函数
+ * @note 因为分配器总是一样的，所以只返回true
+ * @return true
+ */
+template <typename T1, typename T2, std::size_t Threshold, bool HugePages>
+inline constexpr bool operator==(
+    const MmapAllocator<T1, Threshold, HugePages>&,
+    const MmapAllocator<T2, Threshold, HugePages>&
+) noexcept {
+    return true;
+}
+
+}  // namespace user
+
+#endif  // MMAP_ALLOCATOR_HPP
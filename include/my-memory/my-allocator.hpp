@@ -8,6 +8,7 @@
 #define MY_ALLOCATOR_HPP 2
 
 #include <cstddef>
+#include <new>
 #include <type_traits>
 
 namespace user {
@@ -33,7 +34,14 @@ public:
     using is_always_equal = std::true_type;
 
     Allocator() = default;
-    virtual ~Allocator() = default;
+    // 不使用虚析构函数，保证分配器为无状态的空类
+    ~Allocator() = default;
+
+    /**
+     * @brief 从其他类型的分配器构造(用于分配器重绑定)
+     */
+    template <typename U>
+    constexpr Allocator(const Allocator<U>&) noexcept {}
 
     /**
      * @brief 分配给对象分配内存
@@ -42,14 +50,27 @@ public:
      * @return T* 指向对应内存区域的指针
      */
     constexpr T* allocate(size_type n) {
-        return static_cast<T*>(::operator new(n * sizeof(T)));
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            // 超对齐类型(如按缓存行对齐的类型)需要使用对齐版本的operator new
+            return static_cast<T*>(::operator new(
+                n * sizeof(T), std::align_val_t{alignof(T)}
+            ));
+        } else {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
     }
 
     /**
      * @brief 释放对象内存
      * @param p 指向需要释放的内存区域的指针
      */
-    constexpr void deallocate(T* p, size_type) { ::operator delete(p); }
+    constexpr void deallocate(T* p, size_type) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        } else {
+            ::operator delete(p);
+        }
+    }
 };
 
 /**
@@ -0,0 +1,293 @@
+/* UTF-8 */
+/**
+ * @file numa-allocator.hpp
+ * @brief user::NumaAllocator类以及NUMA相关的系统调用封装
+ * @details 直接使用Linux的mbind/set_mempolicy系统调用以及glibc的getcpu，
+ * 不依赖libnuma
+ */
+
+#ifndef NUMA_ALLOCATOR_HPP
+#define NUMA_ALLOCATOR_HPP 2
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <fstream>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace user {
+
+/**
+ * @enum NumaPolicy
+ * @brief NUMA内存放置策略
+ */
+enum class NumaPolicy {
+    Local,      // 放置在首次访问内存的线程所在节点
+    Bind,       // 只在指定的节点上分配
+    Interleave  // 按页在指定的节点间交错分配
+};
+
+namespace numa {
+
+// 内核mempolicy模式的取值(与<linux/mempolicy.h>一致)
+inline constexpr int mpol_default = 0;
+inline constexpr int mpol_bind = 2;
+inline constexpr int mpol_interleave = 3;
+inline constexpr int mpol_local = 4;
+
+// 节点掩码类型，每一位表示一个节点
+using node_mask_type = unsigned long;
+// 节点掩码最多可表示的节点个数
+inline constexpr int max_nodes = sizeof(node_mask_type) * 8;
+
+/**
+ * @brief 获取系统中可能存在的NUMA节点个数
+ * @return 节点个数，无法获取时返回1
+ */
+inline int node_count() {
+    static const int count = [] {
+        // 文件内容形如"0"或"0-1"
+        std::ifstream file("/sys/devices/system/node/possible");
+        std::string range;
+        if (!(file >> range)) {
+            return 1;
+        }
+        const auto dash = range.find('-');
+        if (dash == std::string::npos) {
+            return 1;
+        }
+        const int last = std::stoi(range.substr(dash + 1)) + 1;
+        return last < max_nodes ? last : max_nodes;
+    }();
+    return count;
+}
+
+/**
+ * @brief 获取当前线程所在CPU对应的NUMA节点
+ * @return 节点编号，获取失败时返回0
+ * @note glibc的getcpu通过vDSO实现，不会陷入内核，可以在每次分配时调用
+ */
+inline int current_node() noexcept {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::getcpu(&cpu, &node) != 0) {
+        return 0;
+    }
+    return static_cast<int>(node);
+}
+
+/**
+ * @brief 获取只包含单个节点的掩码
+ * @param node 节点编号
+ * @return 节点掩码
+ */
+constexpr node_mask_type node_mask(int node) noexcept {
+    return node_mask_type{1} << node;
+}
+
+/**
+ * @brief 获取包含所有节点的掩码
+ * @return 节点掩码
+ */
+inline node_mask_type all_nodes_mask() {
+    const int n = node_count();
+    return n >= max_nodes ? ~node_mask_type{0} : node_mask(n) - 1;
+}
+
+/**
+ * @brief 将放置策略转换为内核的mempolicy模式
+ * @param policy 放置策略
+ * @return 内核mempolicy模式
+ */
+constexpr int policy_mode(NumaPolicy policy) noexcept {
+    switch (policy) {
+        case NumaPolicy::Bind:
+            return mpol_bind;
+        case NumaPolicy::Interleave:
+            return mpol_interleave;
+        default:
+            return mpol_local;
+    }
+}
+
+/**
+ * @brief 为一段内存区域设置放置策略(mbind)
+ * @param p 内存区域首地址，需要按页对齐
+ * @param bytes 内存区域的字节数
+ * @param policy 放置策略
+ * @param mask 节点掩码，Local策略时忽略
+ * @return 设置成功返回true
+ * @note 策略在页面首次被访问时生效
+ */
+inline bool bind_memory(
+    void* p, std::size_t bytes, NumaPolicy policy, node_mask_type mask
+) noexcept {
+    const bool local = policy == NumaPolicy::Local;
+    return ::syscall(
+               SYS_mbind, p, bytes, policy_mode(policy),
+               local ? nullptr : &mask, local ? 0 : max_nodes + 1, 0
+           ) == 0;
+}
+
+/**
+ * @brief 设置当前线程之后分配内存的默认放置策略(set_mempolicy)
+ * @param policy 放置策略
+ * @param mask 节点掩码，Local策略时忽略
+ * @return 设置成功返回true
+ */
+inline bool set_thread_policy(NumaPolicy policy, node_mask_type mask) noexcept {
+    const bool local = policy == NumaPolicy::Local;
+    return ::syscall(
+               SYS_set_mempolicy, policy_mode(policy),
+               local ? nullptr : &mask, local ? 0 : max_nodes + 1
+           ) == 0;
+}
+
+/**
+ * @brief 将当前线程恢复为系统默认的放置策略
+ * @return 设置成功返回true
+ */
+inline bool reset_thread_policy() noexcept {
+    return ::syscall(SYS_set_mempolicy, mpol_default, nullptr, 0) == 0;
+}
+
+}  // namespace numa
+
+/**
+ * @class NumaAllocator
+ * @brief 按NUMA放置策略分配内存的分配器
+ * @details 使用匿名mmap分配按页对齐的内存，并通过mbind为其设置放置策略，
+ * 适合为大块的Vector缓冲区指定节点。内核不支持NUMA时策略设置会失败，
+ * 此时内存仍然可以正常使用
+ * @tparam T 数值类型
+ * @note 每次分配至少占用一个内存页，不适合大量的小块内存
+ */
+template <typename T>
+class NumaAllocator {
+public:
+    // C++20 标准规定的类型成员
+    // 数值类型
+    using value_type = T;
+    // 内存分配的内存块尺寸信息类型
+    using size_type = std::size_t;
+    // 两指针之间距离类型
+    using difference_type = std::ptrdiff_t;
+    // 容器复制赋值时分配器跟随复制
+    using propagate_on_container_copy_assignment = std::true_type;
+    // 容器移动赋值时分配器跟随移动
+    using propagate_on_container_move_assignment = std::true_type;
+    // 容器交换时分配器跟随交换
+    using propagate_on_container_swap = std::true_type;
+    // 不同策略的分配器不同
+    using is_always_equal = std::false_type;
+
+    /**
+     * @brief 默认构造函数，使用Local策略
+     */
+    constexpr NumaAllocator() noexcept : policy(NumaPolicy::Local), mask(0) {}
+
+    /**
+     * @brief 根据放置策略构造分配器
+     * @param policy 放置策略
+     * @param mask 节点掩码，Bind和Interleave策略时使用
+     */
+    constexpr explicit NumaAllocator(
+        NumaPolicy policy, numa::node_mask_type mask = 0
+    ) noexcept
+        : policy(policy), mask(mask) {}
+
+    /**
+     * @brief 从其他类型的分配器构造(用于分配器重绑定)
+     */
+    template <typename U>
+    constexpr NumaAllocator(const NumaAllocator<U>& other) noexcept
+        : policy(other.get_policy()), mask(other.get_node_mask()) {}
+
+    /**
+     * @brief 分配给对象分配内存，并设置放置策略
+     * @note 仅分配内存，不进行初始化操作
+     * @param n 需要分配内存的对象数目
+     * @return T* 指向对应内存区域的指针，n为0时返回nullptr
+     * @throw std::bad_alloc 如果mmap分配失败
+     */
+    T* allocate(size_type n) {
+        if (n == 0) {
+            // mmap不能映射0字节，空容器不需要内存
+            return nullptr;
+        }
+        const size_type bytes = S_map_size(n);
+        void* p = ::mmap(
+            nullptr, bytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+        );
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        numa::bind_memory(p, bytes, policy, mask);
+        return static_cast<T*>(p);
+    }
+
+    /**
+     * @brief 释放对象内存
+     * @param p 指向需要释放的内存区域的指针
+     * @param n 分配时的对象数目
+     */
+    void deallocate(T* p, size_type n) {
+        if (p != nullptr && n != 0) {
+            ::munmap(p, S_map_size(n));
+        }
+    }
+
+    /**
+     * @brief 获取放置策略
+     * @return 放置策略
+     */
+    [[nodiscard]] constexpr NumaPolicy get_policy() const noexcept {
+        return policy;
+    }
+
+    /**
+     * @brief 获取节点掩码
+     * @return 节点掩码
+     */
+    [[nodiscard]] constexpr numa::node_mask_type get_node_mask(
+    ) const noexcept {
+        return mask;
+    }
+
+private:
+    /**
+     * @brief 计算n个对象映射时实际占用的字节数(上取到页大小的整数倍)
+     * @param n 对象数目
+     * @return 映射的字节数
+     */
+    static size_type S_map_size(size_type n) noexcept {
+        static const auto page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        return (n * sizeof(T) + page - 1) & ~(page - 1);
+    }
+
+    NumaPolicy policy;          // 放置策略
+    numa::node_mask_type mask;  // 节点掩码
+};
+
+/**
+ * @brief 分配器==函数
+ * @note 策略和节点掩码都相同的分配器相同
+ * @return 两个分配器是否相同
+ */
+template <typename T1, typename T2>
+inline constexpr bool operator==(
+    const NumaAllocator<T1>& lhs, const NumaAllocator<T2>& rhs
+) noexcept {
+    return lhs.get_policy() == rhs.get_policy() &&
+           lhs.get_node_mask() == rhs.get_node_mask();
+}
+
+}  // namespace user
+
+#endif  // NUMA_ALLOCATOR_HPP
@@ -0,0 +1,189 @@
+/**
+ * @file numa-poolmemory.hpp
+ * @brief 实现按NUMA节点划分内存页的内存池类
+ */
+
+#ifndef NUMA_POOLMEMORY_HPP
+#define NUMA_POOLMEMORY_HPP
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <my-memory/numa-allocator.hpp>
+#include <my-memory/poolmemory.hpp>
+#include <new>
+#include <stdexcept>
+
+namespace user {
+
+/**
+ * @struct NumaPageSource
+ * @brief 将内存页绑定在指定NUMA节点上的内存页来源
+ */
+struct NumaPageSource {
+    int node = 0;  // 内存页所在的节点
+
+    /**
+     * @brief 分配一个绑定在node节点上的内存页
+     * @param bytes 内存页的字节数
+     * @return 内存页的首地址
+     * @throw std::bad_alloc 如果mmap分配失败
+     */
+    void *allocate(std::size_t bytes) const {
+        void *p = ::mmap(
+            nullptr, bytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+        );
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        numa::bind_memory(p, bytes, NumaPolicy::Bind, numa::node_mask(node));
+        return p;
+    }
+    /**
+     * @brief 释放一个内存页
+     * @param p 内存页的首地址
+     * @param bytes 内存页的字节数
+     */
+    void deallocate(void *p, std::size_t bytes) const { ::munmap(p, bytes); }
+};
+
+/**
+ * @class NumaPoolMemory
+ * @brief 每个NUMA节点拥有独立内存页链表的内存池
+ * @details 分配时从调用线程所在节点的内存池中取出内存块，
+ * 释放时归还给内存块所在节点的内存池。每个元素前记录所属的节点，
+ * 释放时直接找到对应的内存池，不需要遍历各节点的内存页
+ * @warning 与PoolMemory相同，不可用于分配连续内存
+ */
+template <typename T>
+class NumaPoolMemory {
+    /**
+     * @struct Slot
+     * @brief 内存池中的一个元素，在元素之前记录所属的节点
+     */
+    struct Slot {
+        std::int32_t node;                      // 所属的节点
+        alignas(T) std::byte value[sizeof(T)];  // 元素的内存
+    };
+    using Pool = PoolMemory<Slot, NumaPageSource>;  // 单个节点的内存池
+
+public:
+    // C++20 标准规定的类型成员
+    // 数值类型
+    using value_type = T;
+    // 内存分配的内存块尺寸信息类型
+    using size_type = std::size_t;
+    // 两指针之间距离类型
+    using difference_type = std::ptrdiff_t;
+    // 容器移动赋值时分配器跟随移动
+    using propagate_on_container_move_assignment = std::true_type;
+    // 两个内存池总是不同的
+    using is_always_equal = std::false_type;
+
+    // 内存池不允许复制
+    NumaPoolMemory(const NumaPoolMemory &) = delete;
+    NumaPoolMemory &operator=(const NumaPoolMemory &) = delete;
+
+    /**
+     * @brief 为系统中的每个节点构造一个内存池
+     */
+    NumaPoolMemory() : NumaPoolMemory(numa::node_count()) {}
+
+    /**
+     * @brief 为指定数目的节点构造内存池
+     * @param num_nodes 节点个数
+     */
+    explicit NumaPoolMemory(int num_nodes)
+        : pools(static_cast<Pool *>(::operator new(sizeof(Pool) * num_nodes))),
+          num_nodes(num_nodes) {
+        for (int node = 0; node < num_nodes; node++) {
+            ::new (pools + node) Pool(NumaPageSource{node});
+        }
+    }
+
+    ~NumaPoolMemory() {
+        // 析构每个节点的内存池
+        for (int node = 0; node < num_nodes; node++) {
+            pools[node].~Pool();
+        }
+        ::operator delete(pools);
+    }
+
+    /**
+     * @brief 在调用线程所在的节点上分配一个空闲的内存地址
+     * @param n 分配的连续元素个数，不可大于1
+     * @return 空闲的内存地址
+     * @warning 分配的元素个数不可超过1
+     */
+    void *allocate(size_type n) {
+        if (n > 1) {
+            throw std::out_of_range(
+                "NumaPoolMemory::allocate: n cannot be greater than one"
+            );
+        }
+        return allocate();
+    }
+    /**
+     * @brief 在调用线程所在的节点上为一个元素分配内存地址
+     * @return 空闲的内存地址
+     */
+    void *allocate() { return allocate_on(numa::current_node()); }
+
+    /**
+     * @brief 在指定节点上为一个元素分配内存地址
+     * @param node 节点编号，超出范围时使用最后一个节点
+     * @return 空闲的内存地址
+     */
+    void *allocate_on(int node) {
+        if (node >= num_nodes) {
+            node = num_nodes - 1;
+        }
+        auto slot = static_cast<Slot *>(pools[node].allocate());
+        slot->node = node;
+        return slot->value;
+    }
+
+    /**
+     * @brief 释放指定地址的内存
+     * @param p 需要释放的内存地址
+     * @param n 需要释放的元素个数，不可超过1
+     */
+    void deallocate(void *p, size_type n) {
+        if (n > 1) {
+            throw std::out_of_range(
+                "NumaPoolMemory::deallocate: n cannot be greater than one"
+            );
+        }
+        deallocate(p);
+    }
+    /**
+     * @brief 释放指定地址的内存，归还给其所在节点的内存池
+     * @param p 需要释放的内存地址
+     */
+    void deallocate(void *p) {
+        auto slot = reinterpret_cast<Slot *>(
+            static_cast<std::byte *>(p) - offsetof(Slot, value)
+        );
+        if (slot->node < 0 || slot->node >= num_nodes) {
+            throw std::invalid_argument(
+                "NumaPoolMemory::deallocate: invalid pointer"
+            );
+        }
+        pools[slot->node].deallocate(slot);
+    }
+
+    /**
+     * @brief 获取内存池管理的节点个数
+     * @return 节点个数
+     */
+    [[nodiscard]] int nodes() const noexcept { return num_nodes; }
+
+private:
+    Pool *pools;    // 每个节点的内存池
+    int num_nodes;  // 节点个数
+};
+
+}  // namespace user
+
+#endif  // NUMA_POOLMEMORY_HPP
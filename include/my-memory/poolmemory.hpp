@@ -6,17 +6,38 @@
 #ifndef POOLMEMORY_HPP
 #define POOLMEMORY_HPP
 #include <cstddef>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 
 namespace user {
 
+/**
+ * @struct NewPageSource
+ * @brief 内存池默认的内存页来源，使用::operator new分配内存页
+ */
+struct NewPageSource {
+    /**
+     * @brief 分配一个内存页
+     * @param bytes 内存页的字节数
+     * @return 内存页的首地址
+     */
+    void *allocate(std::size_t bytes) { return ::operator new(bytes); }
+    /**
+     * @brief 释放一个内存页
+     * @param p 内存页的首地址
+     */
+    void deallocate(void *p, std::size_t) { ::operator delete(p); }
+};
+
 /**
  * @class PoolMemory
  * @brief 实现简单的内存池功能，每个内存池存放1024个元素
+ * @tparam T 元素类型
+ * @tparam PageSource 内存页来源，需要提供allocate(bytes)和deallocate(p, bytes)
  * @warning 不可用于分配连续内存，内存池中各元素都是分开的
  */
-template <typename T>
+template <typename T, typename PageSource = NewPageSource>
 class PoolMemory {
     /**
      * @struct Block
@@ -56,12 +77,18 @@ public:
     PoolMemory &operator=(const PoolMemory &) = delete;
 
     PoolMemory() : first_page(nullptr) {}
+    /**
+     * @brief 使用指定的内存页来源构造内存池
+     * @param source 内存页来源
+     */
+    explicit PoolMemory(const PageSource &source)
+        : first_page(nullptr), source(source) {}
     ~PoolMemory() {
         // 释放每个内存池
         for (Page *page = first_page; page != nullptr;) {
             Page *temp = page;
             page = page->next_page;
-            ::operator delete(temp);
+            source.deallocate(temp, page_size);
         }
     }
 
@@ -261,7 +288,7 @@ private:
     Page *AllocNewPage() {
         // 为新内存页分配对应内存
         alignas(align_bytes) Page *new_page =
-            static_cast<Page *>(::operator new(page_size));
+            static_cast<Page *>(source.allocate(page_size));
 
         // 确定第一个内存块的内存地址
         new_page->first_free_block = reinterpret_cast<Block *>(
@@ -348,6 +375,55 @@ private:
     constexpr static size_type num_ele = 1024;
 
     Page *first_page;  // 第一个内存页
+
+    [[no_unique_address]] PageSource source;  // 内存页来源
+};
+
+/**
+ * @class PooledPageSource
+ * @brief 从PoolMemory中分配固定大小内存页的内存页来源
+ * @details 内存页释放后回到内存池中，之后的分配直接复用而不再调用malloc。
+ * 只保存内存池的指针，多个容器可以共享同一个内存池
+ * @tparam Bytes 内存页的最大字节数
+ * @tparam PageSource 内存池自身的内存页来源
+ * @warning 与PoolMemory相同，不是线程安全的
+ */
+template <std::size_t Bytes = 4096, typename PageSource = NewPageSource>
+class PooledPageSource {
+public:
+    // 内存池中存放的内存页
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Page {
+        std::byte bytes[Bytes];
+    };
+    // 内存池类型
+    using pool_type = PoolMemory<Page, PageSource>;
+
+    /**
+     * @brief 使用指定的内存池构造
+     * @param pool 内存池，生命周期必须长于所有从此分配的内存页
+     */
+    explicit PooledPageSource(pool_type &pool) noexcept : pool(&pool) {}
+
+    /**
+     * @brief 分配一个内存页
+     * @param bytes 内存页的字节数
+     * @return 内存页的首地址
+     * @throw std::bad_alloc bytes超过Bytes
+     */
+    void *allocate(std::size_t bytes) {
+        if (bytes > Bytes) {
+            throw std::bad_alloc();
+        }
+        return pool->allocate();
+    }
+    /**
+     * @brief 将内存页归还给内存池
+     * @param p 内存页的首地址
+     */
+    void deallocate(void *p, std::size_t) { pool->deallocate(p); }
+
+private:
+    pool_type *pool;  // 内存池
 };
 
 }  // namespace user
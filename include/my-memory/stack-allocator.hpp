@@ -0,0 +1,269 @@
+/* UTF-8 */
+/**
+ * @file stack-allocator.hpp
+ * @brief user::InplaceBuffer类与user::StackAllocator类
+ * @details 优先从调用者提供的缓冲区(通常位于栈上)分配内存，
+ * 缓冲区不足时再交给user::Allocator分配
+ */
+
+#ifndef STACK_ALLOCATOR_HPP
+#define STACK_ALLOCATOR_HPP 2
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <my-memory/my-allocator.hpp>
+#include <type_traits>
+
+namespace user {
+
+/**
+ * @class InplaceBuffer
+ * @brief 固定大小的内存缓冲区，按栈的方式分配内存
+ * @details 内存从低地址向高地址依次分配，只有最后分配的内存块释放时
+ * 才会真正回收，其余内存块在缓冲区重置或析构前不会被重复使用
+ * @tparam Bytes 缓冲区的字节数
+ */
+template <std::size_t Bytes>
+class InplaceBuffer {
+public:
+    InplaceBuffer() noexcept : top(storage) {}
+
+    // 分配器中保存的是缓冲区的地址，所以缓冲区不允许复制
+    InplaceBuffer(const InplaceBuffer&) = delete;
+    InplaceBuffer& operator=(const InplaceBuffer&) = delete;
+
+    /**
+     * @brief 从缓冲区中分配内存
+     * @param bytes 需要分配的字节数
+     * @param align 对齐要求
+     * @return 指向分配内存的指针，缓冲区剩余空间不足时返回nullptr
+     */
+    void* allocate(std::size_t bytes, std::size_t align) noexcept {
+        // 将栈顶地址上取到对齐要求的整数倍
+        const auto addr = reinterpret_cast<std::uintptr_t>(top);
+        std::byte* p = top + ((align - addr % align) % align);
+        if (p > storage + Bytes ||
+            static_cast<std::size_t>(storage + Bytes - p) < bytes) {
+            return nullptr;
+        }
+        top = p + bytes;
+        return p;
+    }
+
+    /**
+     * @brief 释放缓冲区中的内存
+     * @param p 需要释放的内存地址
+     * @param bytes 分配时的字节数
+     * @return 如果内存属于此缓冲区则返回true
+     * @note 只有最后分配的内存块会被回收
+     */
+    bool deallocate(void* p, std::size_t bytes) noexcept {
+        if (!contains(p)) {
+            return false;
+        }
+        // 释放的是栈顶的内存块则将栈顶回退
+        if (static_cast<std::byte*>(p) + bytes == top) {
+            top = static_cast<std::byte*>(p);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 尝试原地调整最后分配的内存块的大小
+     * @param p 内存块的地址
+     * @param old_bytes 内存块原来的字节数
+     * @param new_bytes 内存块新的字节数
+     * @return 调整成功返回true
+     */
+    bool resize(void* p, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+        auto* block = static_cast<std::byte*>(p);
+        if (!contains(p) || block + old_bytes != top ||
+            static_cast<std::size_t>(storage + Bytes - block) < new_bytes) {
+            return false;
+        }
+        top = block + new_bytes;
+        return true;
+    }
+
+    /**
+     * @brief 判断地址是否属于此缓冲区
+     * @details 缓冲区用尽时直接调用allocate(0, align)会得到尾后地址，
+     * 因此尾后地址同样属于此缓冲区(StackAllocator::allocate(0)返回nullptr，
+     * 不会经过缓冲区)
+     * @param p 需要判断的内存地址
+     * @return 如果地址位于[storage, storage + Bytes]中则返回true
+     */
+    [[nodiscard]] bool contains(const void* p) const noexcept {
+        const auto* addr = static_cast<const std::byte*>(p);
+        return std::less_equal<>{}(storage, addr) &&
+               std::less_equal<>{}(addr, storage + Bytes);
+    }
+
+    /**
+     * @brief 获取已使用的字节数
+     * @return 已使用的字节数
+     */
+    [[nodiscard]] std::size_t used() const noexcept {
+        return static_cast<std::size_t>(top - storage);
+    }
+
+    /**
+     * @brief 释放缓冲区中的所有内存
+     * @warning 缓冲区中分配的对象此后都不可再使用
+     */
+    void reset() noexcept { top = storage; }
+
+private:
+    alignas(std::max_align_t) std::byte storage[Bytes];  // 缓冲区内存
+    std::byte* top;                                     // 栈顶地址
+};
+
+/**
+ * @class StackAllocator
+ * @brief 优先从InplaceBuffer中分配内存的分配器
+ * @details 缓冲区空间不足时使用user::Allocator分配。默认构造的分配器
+ * 没有缓冲区，所有内存都由user::Allocator分配
+ * @tparam T 数值类型
+ * @tparam Bytes 缓冲区的字节数
+ * @warning 使用此分配器的容器不能比缓冲区存在的时间更长
+ */
+template <typename T, std::size_t Bytes>
+class StackAllocator {
+public:
+    // C++20 标准规定的类型成员
+    // 数值类型
+    using value_type = T;
+    // 内存分配的内存块尺寸信息类型
+    using size_type = std::size_t;
+    // 两指针之间距离类型
+    using difference_type = std::ptrdiff_t;
+    // 容器移动赋值时分配器跟随移动
+    using propagate_on_container_move_assignment = std::true_type;
+    // 容器交换时分配器跟随交换
+    using propagate_on_container_swap = std::true_type;
+    // 使用不同缓冲区的分配器不同
+    using is_always_equal = std::false_type;
+    // 缓冲区类型
+    using buffer_type = InplaceBuffer<Bytes>;
+
+    /**
+     * @struct rebind
+     * @brief 重绑定为其他数值类型的分配器，保留缓冲区大小参数
+     */
+    template <typename U>
+    struct rebind {
+        using other = StackAllocator<U, Bytes>;
+    };
+
+    /**
+     * @brief 默认构造函数，不使用缓冲区
+     */
+    constexpr StackAllocator() noexcept : buffer(nullptr) {}
+
+    /**
+     * @brief 使用指定的缓冲区构造分配器
+     * @param buffer 缓冲区
+     */
+    constexpr explicit StackAllocator(buffer_type& buffer) noexcept
+        : buffer(&buffer) {}
+
+    /**
+     * @brief 从其他类型的分配器构造(用于分配器重绑定)
+     */
+    template <typename U>
+    constexpr StackAllocator(const StackAllocator<U, Bytes>& other) noexcept
+        : buffer(other.get_buffer()) {}
+
+    /**
+     * @brief 分配给对象分配内存
+     * @note 仅分配内存，不进行初始化操作
+     * @param n 需要分配内存的对象数目
+     * @return T* 指向对应内存区域的指针，n为0时返回nullptr
+     */
+    T* allocate(size_type n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        if (buffer != nullptr) {
+            if (void* p = buffer->allocate(n * sizeof(T), alignof(T))) {
+                return static_cast<T*>(p);
+            }
+        }
+        return Allocator<T>{}.allocate(n);
+    }
+
+    /**
+     * @brief 释放对象内存
+     * @param p 指向需要释放的内存区域的指针
+     * @param n 分配时的对象数目
+     */
+    void deallocate(T* p, size_type n) {
+        if (p == nullptr || n == 0) {
+            return;
+        }
+        if (buffer != nullptr && buffer->deallocate(p, n * sizeof(T))) {
+            return;
+        }
+        Allocator<T>{}.deallocate(p, n);
+    }
+
+    /**
+     * @brief 重新分配内存，并保留前min(old_n, new_n)个对象的字节内容
+     * @details 最后分配的内存块在缓冲区空间足够时原地扩展
+     * @param p 原来的内存区域，可为nullptr
+     * @param old_n 原来分配的对象数目
+     * @param new_n 新的对象数目
+     * @return 指向新内存区域的指针
+     * @warning 按字节搬移内存，只可用于可平凡复制的类型
+     */
+    T* reallocate(T* p, size_type old_n, size_type new_n) {
+        if (p == nullptr) {
+            return allocate(new_n);
+        }
+        if (new_n == 0) {
+            deallocate(p, old_n);
+            return nullptr;
+        }
+        if (buffer != nullptr &&
+            buffer->resize(p, old_n * sizeof(T), new_n * sizeof(T))) {
+            return p;
+        }
+        T* res = allocate(new_n);
+        std::memcpy(
+            static_cast<void*>(res), static_cast<const void*>(p),
+            std::min(old_n, new_n) * sizeof(T)
+        );
+        deallocate(p, old_n);
+        return res;
+    }
+
+    /**
+     * @brief 获取分配器使用的缓冲区
+     * @return 指向缓冲区的指针，没有缓冲区时为nullptr
+     */
+    [[nodiscard]] constexpr buffer_type* get_buffer() const noexcept {
+        return buffer;
+    }
+
+private:
+    buffer_type* buffer;  // 缓冲区
+};
+
+/**
+ * @brief 分配器==函数
+ * @note 使用同一缓冲区的分配器相同
+ * @return 两个分配器是否相同
+ */
+template <typename T1, typename T2, std::size_t Bytes>
+inline constexpr bool operator==(
+    const StackAllocator<T1, Bytes>& lhs, const StackAllocator<T2, Bytes>& rhs
+) noexcept {
+    return lhs.get_buffer() == rhs.get_buffer();
+}
+
+}  // namespace user
+
+#endif  // STACK_ALLOCATOR_HPP
@@ -0,0 +1,213 @@
+/* UTF-8 */
+/**
+ * @file threadcache-allocator.hpp
+ * @brief user::ThreadCacheAllocator类
+ * @details 为小块内存提供线程局部的空闲链表缓存，减少全局分配器的锁竞争
+ */
+
+#ifndef THREADCACHE_ALLOCATOR_HPP
+#define THREADCACHE_ALLOCATOR_HPP 2
+
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace user {
+
+/**
+ * @class ThreadCache
+ * @brief 线程局部的小块内存缓存
+ * @details 按2的幂划分尺寸类别(16字节到4096字节)，每个线程为每个类别
+ * 保存一条有上限的空闲链表。内存块都通过::operator new分配，
+ * 所以任意线程都可以释放其他线程分配的内存块
+ */
+class ThreadCache {
+public:
+    // 最小尺寸类别的位数(16字节)
+    static constexpr std::size_t min_class_shift = 4;
+    // 最大尺寸类别的位数(4096字节)
+    static constexpr std::size_t max_class_shift = 12;
+    // 尺寸类别的个数
+    static constexpr std::size_t num_classes =
+        max_class_shift - min_class_shift + 1;
+    // 每个尺寸类别最多缓存的内存块个数
+    static constexpr std::size_t max_cached = 64;
+
+    /**
+     * @brief 分配指定字节数的内存
+     * @param bytes 需要分配的字节数
+     * @return 指向分配内存的指针
+     */
+    static void* allocate(std::size_t bytes) {
+        if (bytes > (std::size_t{1} << max_class_shift) || S_exited) {
+            return ::operator new(bytes);
+        }
+        const std::size_t index = S_class_index(bytes);
+        Cache& cache = S_local();
+        // 优先从空闲链表中取出内存块
+        if (FreeBlock* block = cache.heads[index]; block != nullptr) {
+            cache.heads[index] = block->next;
+            --cache.counts[index];
+            return block;
+        }
+        return ::operator new(std::size_t{1} << (index + min_class_shift));
+    }
+
+    /**
+     * @brief 释放指定字节数的内存
+     * @param p 需要释放的内存地址
+     * @param bytes 分配时的字节数
+     */
+    static void deallocate(void* p, std::size_t bytes) noexcept {
+        if (bytes > (std::size_t{1} << max_class_shift) || S_exited) {
+            ::operator delete(p);
+            return;
+        }
+        const std::size_t index = S_class_index(bytes);
+        Cache& cache = S_local();
+        // 缓存已满时直接归还给全局分配器
+        if (cache.counts[index] == max_cached) {
+            ::operator delete(p);
+            return;
+        }
+        auto* block = static_cast<FreeBlock*>(p);
+        block->next = cache.heads[index];
+        cache.heads[index] = block;
+        ++cache.counts[index];
+    }
+
+private:
+    /**
+     * @struct FreeBlock
+     * @brief 空闲内存块，在内存块的开头保存下一空闲内存块的地址
+     */
+    struct FreeBlock {
+        FreeBlock* next;  // 下一空闲内存块
+    };
+
+    /**
+     * @struct Cache
+     * @brief 一个线程拥有的所有空闲链表
+     */
+    struct Cache {
+        FreeBlock* heads[num_classes]{};    // 每个尺寸类别的空闲链表
+        std::size_t counts[num_classes]{};  // 每个空闲链表的长度
+
+        /**
+         * @brief 线程退出时释放所有缓存的内存块
+         */
+        ~Cache() {
+            for (FreeBlock* head : heads) {
+                while (head != nullptr) {
+                    FreeBlock* temp = head;
+                    head = head->next;
+                    ::operator delete(temp);
+                }
+            }
+            // 之后的分配和释放不再经过缓存
+            S_exited = true;
+        }
+    };
+
+    /**
+     * @brief 获取当前线程的缓存
+     * @return 当前线程的缓存
+     */
+    static Cache& S_local() noexcept {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 计算字节数对应的尺寸类别
+     * @param bytes 字节数，不大于最大尺寸类别
+     * @return 尺寸类别的索引
+     */
+    static constexpr std::size_t S_class_index(std::size_t bytes) noexcept {
+        if (bytes <= (std::size_t{1} << min_class_shift)) {
+            return 0;
+        }
+        return std::bit_width(bytes - 1) - min_class_shift;
+    }
+
+    // 当前线程的缓存是否已经析构
+    static inline thread_local bool S_exited = false;
+};
+
+/**
+ * @class ThreadCacheAllocator
+ * @brief 带线程局部缓存的容器分配器
+ * @details 小块内存经过ThreadCache的空闲链表分配和释放，
+ * 大块内存和超对齐类型直接使用::operator new。分配器没有状态，总是相同的，
+ * 因此容器可以在线程之间自由移动
+ */
+template <typename T>
+class ThreadCacheAllocator {
+public:
+    // C++20 标准规定的类型成员
+    // 数值类型
+    using value_type = T;
+    // 内存分配的内存块尺寸信息类型
+    using size_type = std::size_t;
+    // 两指针之间距离类型
+    using difference_type = std::ptrdiff_t;
+    // 容器移动赋值时分配器跟随移动
+    using propagate_on_container_move_assignment = std::true_type;
+    // 两个内存分配器总是相同的
+    using is_always_equal = std::true_type;
+
+    ThreadCacheAllocator() = default;
+
+    /**
+     * @brief 从其他类型的分配器构造(用于分配器重绑定)
+     */
+    template <typename U>
+    constexpr ThreadCacheAllocator(const ThreadCacheAllocator<U>&) noexcept {}
+
+    /**
+     * @brief 分配给对象分配内存
+     * @note 仅分配内存，不进行初始化操作
+     * @param n 需要分配内存的对象数目
+     * @return T* 指向对应内存区域的指针
+     */
+    T* allocate(size_type n) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            // 缓存中的内存块只按默认对齐，超对齐类型绕过缓存
+            return static_cast<T*>(::operator new(
+                n * sizeof(T), std::align_val_t{alignof(T)}
+            ));
+        } else {
+            return static_cast<T*>(ThreadCache::allocate(n * sizeof(T)));
+        }
+    }
+
+    /**
+     * @brief 释放对象内存
+     * @param p 指向需要释放的内存区域的指针
+     * @param n 分配时的对象数目
+     */
+    void deallocate(T* p, size_type n) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        } else {
+            ThreadCache::deallocate(p, n * sizeof(T));
+        }
+    }
+};
+
+/**
+ * @brief 分配器==函数
+ * @note 因为分配器总是一样的，所以只返回true
+ * @return true
+ */
+template <typename T1, typename T2>
+inline constexpr bool operator==(
+    const ThreadCacheAllocator<T1>&, const ThreadCacheAllocator<T2>&
+) noexcept {
+    return true;
+}
+
+}  // namespace user
+
+#endif  // THREADCACHE_ALLOCATOR_HPP
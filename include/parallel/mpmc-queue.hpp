@@ -0,0 +1,449 @@
+/* UTF-8 */
+/**
+ * @file mpmc-queue.hpp
+ * @brief user::MpmcQueue类
+ * @details 有界的多生产者多消费者无锁队列，参考Dmitry Vyukov的实现:
+ * 每个槽位带有一个序号，生产者和消费者各自用一次CAS占有下标，再通过槽位
+ * 序号交接元素，生产者之间、消费者之间只在下标上竞争。
+ * 槽位按缓存行对齐，相邻槽位不会在不同线程之间伪共享;
+ * 阻塞的push()/pop()只有在确实有线程睡眠时才会调用notify
+ */
+
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <container/vectorbase.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @class MpmcQueue
+ * @brief 有界的多生产者多消费者无锁队列
+ * @tparam T 元素类型，移动构造、移动赋值和析构不可抛出异常
+ * @tparam Alloc 分配器类型，用于分配槽位
+ * @note 所有成员函数都可以被任意线程并发调用(构造和析构除外)
+ */
+template <NotConstVolatile T, IsAllocator Alloc = Allocator<T>>
+class MpmcQueue {
+    static_assert(
+        std::is_nothrow_move_constructible_v<T> &&
+            std::is_nothrow_move_assignable_v<T> &&
+            std::is_nothrow_destructible_v<T>,
+        "MpmcQueue requires nothrow move and destruction"
+    );
+
+    /**
+     * @struct Slot
+     * @brief 槽位，占据完整的缓存行
+     * @details 序号等于下标pos时槽位空闲，等待第pos次入队;
+     * 等于pos + 1时存放着第pos次入队的元素
+     */
+    struct alignas(64) Slot {
+        std::atomic<std::size_t> sequence;     // 槽位序号
+        alignas(T) std::byte storage[sizeof(T)];  // 元素的存储空间
+
+        explicit Slot(std::size_t sequence) noexcept : sequence(sequence) {}
+
+        T* get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    /**
+     * @struct Waiters
+     * @brief 阻塞等待的线程，epoch在有线程睡眠时才递增
+     */
+    struct alignas(64) Waiters {
+        std::atomic<std::uint32_t> epoch{0};     // 唤醒计数
+        std::atomic<std::uint32_t> sleepers{0};  // 正在睡眠的线程数
+    };
+
+    // 槽位的分配器类型
+    using Slot_alloc_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    // 槽位的存储
+    using Storage = VectorBase<Slot, Slot_alloc_type>;
+
+public:
+    using value_type = T;                  // 元素类型
+    using size_type = std::size_t;         // 元素个数类型
+    using allocator_type = Alloc;          // 分配器类型
+
+    /**
+     * @brief 构造队列
+     * @param capacity 容量，会被上取到2的幂(至少为2)
+     * @param a 分配器
+     */
+    explicit MpmcQueue(
+        size_type capacity, const allocator_type& a = allocator_type()
+    )
+        : storage(S_round_capacity(capacity), Slot_alloc_type(a)),
+          mask(S_round_capacity(capacity) - 1) {
+        for (size_type i = 0; i <= mask; ++i) {
+            Storage::Tr::construct(storage.alloc, storage.M_start + i, i);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief 析构函数，析构队列中剩余的元素
+     */
+    ~MpmcQueue() noexcept {
+        const size_type last = enqueue_pos.load(std::memory_order_relaxed);
+        for (size_type pos = dequeue_pos.load(std::memory_order_relaxed);
+             pos != last; ++pos) {
+            std::destroy_at(M_slot(pos).get());
+        }
+        std::destroy_n(storage.M_start, mask + 1);
+    }
+
+    /**
+     * @brief 尝试在队尾构造元素
+     * @param args 构造函数参数
+     * @return 队列未满并入队成功时返回true
+     */
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        if constexpr (!std::is_nothrow_constructible_v<T, Args...>) {
+            // 占有槽位之后不能失败，先在槽位之外构造
+            return try_emplace(T(std::forward<Args>(args)...));
+        } else {
+            size_type pos = enqueue_pos.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &M_slot(pos);
+                const auto diff = static_cast<std::intptr_t>(
+                    slot->sequence.load(std::memory_order_acquire) - pos
+                );
+                if (diff == 0) {
+                    if (enqueue_pos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed
+                        )) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // 槽位中还有上一轮的元素，队列已满
+                    return false;
+                } else {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            std::construct_at(slot->get(), std::forward<Args>(args)...);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            S_notify(not_empty);
+            return true;
+        }
+    }
+
+    /**
+     * @brief 尝试在队尾插入元素
+     * @param value 元素的值
+     * @return 队列未满并入队成功时返回true
+     */
+    bool try_push(const value_type& value) { return try_emplace(value); }
+    bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+    /**
+     * @brief 尝试从队首取出元素
+     * @param out 保存取出的元素
+     * @return 队列非空并出队成功时返回true
+     */
+    bool try_pop(value_type& out) noexcept {
+        size_type pos = dequeue_pos.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &M_slot(pos);
+            const auto diff = static_cast<std::intptr_t>(
+                slot->sequence.load(std::memory_order_acquire) - (pos + 1)
+            );
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed
+                    )) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // 槽位还没有写入，队列为空
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        M_take(*slot, pos, out);
+        S_notify(not_full);
+        return true;
+    }
+
+    /**
+     * @brief 尝试批量入队，一次CAS占有连续的多个槽位
+     * @param first 元素的起始迭代器
+     * @param n 最多入队的元素个数
+     * @return 实际入队的元素个数，即从first开始使用的元素个数
+     * @note 从*first构造元素不可抛出异常，需要复制可能抛出异常的类型时
+     * 可以先构造好元素再通过std::move_iterator传入
+     */
+    template <std::input_iterator InputIt>
+        requires std::is_nothrow_constructible_v<
+            T, std::iter_reference_t<InputIt>>
+    size_type try_push_bulk(InputIt first, size_type n) {
+        if (n == 0) {
+            return 0;
+        }
+        size_type pos = enqueue_pos.load(std::memory_order_relaxed);
+        size_type count;
+        while (true) {
+            // 统计从pos开始连续空闲的槽位
+            count = 0;
+            while (count < n && count <= mask &&
+                   M_slot(pos + count).sequence.load(
+                       std::memory_order_acquire
+                   ) == pos + count) {
+                ++count;
+            }
+            if (count == 0) {
+                const auto diff = static_cast<std::intptr_t>(
+                    M_slot(pos).sequence.load(std::memory_order_acquire) - pos
+                );
+                if (diff < 0) {
+                    return 0;
+                }
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            } else if (enqueue_pos.compare_exchange_weak(
+                           pos, pos + count, std::memory_order_relaxed
+                       )) {
+                break;
+            }
+        }
+        for (size_type k = 0; k < count; ++k, ++first) {
+            Slot& slot = M_slot(pos + k);
+            std::construct_at(slot.get(), *first);
+            slot.sequence.store(pos + k + 1, std::memory_order_release);
+        }
+        S_notify(not_empty);
+        return count;
+    }
+
+    /**
+     * @brief 尝试批量出队，一次CAS占有连续的多个槽位
+     * @param out 输出迭代器
+     * @param n 最多出队的元素个数
+     * @return 实际出队的元素个数
+     * @note 向out写入时抛出异常会丢弃本批次中剩余的元素
+     */
+    template <typename OutputIt>
+    size_type try_pop_bulk(OutputIt out, size_type n) {
+        if (n == 0) {
+            return 0;
+        }
+        size_type pos = dequeue_pos.load(std::memory_order_relaxed);
+        size_type count;
+        while (true) {
+            // 统计从pos开始连续写入完成的槽位
+            count = 0;
+            while (count < n && count <= mask &&
+                   M_slot(pos + count).sequence.load(
+                       std::memory_order_acquire
+                   ) == pos + count + 1) {
+                ++count;
+            }
+            if (count == 0) {
+                const auto diff = static_cast<std::intptr_t>(
+                    M_slot(pos).sequence.load(std::memory_order_acquire) -
+                    (pos + 1)
+                );
+                if (diff < 0) {
+                    return 0;
+                }
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            } else if (dequeue_pos.compare_exchange_weak(
+                           pos, pos + count, std::memory_order_relaxed
+                       )) {
+                break;
+            }
+        }
+        size_type k = 0;
+        try {
+            for (; k < count; ++k) {
+                Slot& slot = M_slot(pos + k);
+                *out = std::move(*slot.get());
+                ++out;
+                M_release(slot, pos + k);
+            }
+        } catch (...) {
+            // 已占有的槽位必须归还，否则生产者会永远等待
+            for (; k < count; ++k) {
+                M_release(M_slot(pos + k), pos + k);
+            }
+            S_notify(not_full);
+            throw;
+        }
+        S_notify(not_full);
+        return count;
+    }
+
+    /**
+     * @brief 在队尾插入元素，队列已满时阻塞
+     * @param value 元素的值
+     */
+    void push(const value_type& value) {
+        if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+            S_block(not_full, [&] { return try_push(value); });
+        } else {
+            // 只复制一次，而不是每次尝试都构造临时对象
+            push(value_type(value));
+        }
+    }
+    void push(value_type&& value) {
+        S_block(not_full, [&] { return try_push(std::move(value)); });
+    }
+
+    /**
+     * @brief 从队首取出元素，队列为空时阻塞
+     * @param out 保存取出的元素
+     */
+    void pop(value_type& out) {
+        S_block(not_empty, [&] { return try_pop(out); });
+    }
+
+    /**
+     * @brief 批量出队，队列为空时阻塞直到至少取出一个元素
+     * @param out 输出迭代器
+     * @param n 最多出队的元素个数，不能为0
+     * @return 实际出队的元素个数
+     */
+    template <typename OutputIt>
+    size_type pop_bulk(OutputIt out, size_type n) {
+        size_type count = 0;
+        S_block(not_empty, [&] {
+            count = try_pop_bulk(out, n);
+            return count != 0;
+        });
+        return count;
+    }
+
+    /**
+     * @brief 获取队列的容量
+     */
+    [[nodiscard]] size_type capacity() const noexcept { return mask + 1; }
+
+    /**
+     * @brief 获取队列中元素个数的近似值
+     * @return 元素个数，其他线程并发修改时只是一个估计
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        const size_type last = enqueue_pos.load(std::memory_order_relaxed);
+        const size_type first = dequeue_pos.load(std::memory_order_relaxed);
+        return last > first ? last - first : 0;
+    }
+
+    /**
+     * @brief 判断队列是否为空(近似值)
+     */
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+private:
+    /**
+     * @brief 获取下标pos对应的槽位
+     */
+    Slot& M_slot(size_type pos) const noexcept {
+        return storage.M_start[pos & mask];
+    }
+
+    /**
+     * @brief 取出槽位中的元素并归还槽位
+     * @param slot 槽位
+     * @param pos 元素的下标
+     * @param out 保存取出的元素
+     */
+    void M_take(Slot& slot, size_type pos, value_type& out) noexcept {
+        out = std::move(*slot.get());
+        M_release(slot, pos);
+    }
+
+    /**
+     * @brief 析构槽位中的元素，槽位留给下一轮的第pos + capacity次入队
+     */
+    void M_release(Slot& slot, size_type pos) noexcept {
+        std::destroy_at(slot.get());
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 有线程在等待时将其唤醒
+     * @param w 等待的线程
+     * @note 栅栏与S_block()中sleepers递增后的栅栏配对:要么此处看到睡眠者，
+     * 要么睡眠者递增后的重试看到刚完成的操作
+     */
+    static void S_notify(Waiters& w) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (w.sleepers.load(std::memory_order_relaxed) != 0) {
+            w.epoch.fetch_add(1);
+            w.epoch.notify_all();
+        }
+    }
+
+    /**
+     * @brief 重复尝试直到成功，长时间失败时睡眠
+     * @param w 等待的线程
+     * @param attempt 返回是否成功的可调用对象
+     */
+    template <typename F>
+    static void S_block(Waiters& w, F&& attempt) {
+        while (!attempt()) {
+            // 先让出时间片等待一会，减少频繁睡眠唤醒的开销
+            bool done = false;
+            for (int spin = 0; spin < 64 && !done; ++spin) {
+                std::this_thread::yield();
+                done = attempt();
+            }
+            if (done) {
+                return;
+            }
+            const std::uint32_t e = w.epoch.load();
+            w.sleepers.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (attempt()) {
+                w.sleepers.fetch_sub(1);
+                return;
+            }
+            w.epoch.wait(e);
+            w.sleepers.fetch_sub(1);
+        }
+    }
+
+    /**
+     * @brief 将容量上取到2的幂
+     */
+    static constexpr size_type S_round_capacity(size_type n) noexcept {
+        size_type capacity = 2;
+        while (capacity < n) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // 只读的槽位数组与各个下标位于不同的缓存行，避免伪共享
+    alignas(64) Storage storage;  // 槽位
+    size_type mask;               // 容量 - 1
+    alignas(64) std::atomic<size_type> enqueue_pos{0};  // 下一次入队的下标
+    alignas(64) std::atomic<size_type> dequeue_pos{0};  // 下一次出队的下标
+    Waiters not_empty;  // 等待队列非空的消费者
+    Waiters not_full;   // 等待队列不满的生产者
+};
+
+}  // namespace user
+
+#endif  // MPMC_QUEUE_HPP
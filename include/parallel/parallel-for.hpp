@@ -0,0 +1,139 @@
+/* UTF-8 */
+/**
+ * @file parallel-for.hpp
+ * @brief 基于工作窃取线程池的parallel_for
+ */
+
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP 2
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <parallel/thread-pool.hpp>
+
+namespace user {
+
+namespace parallel {
+
+/**
+ * @brief 递归地将区间对半拆分，一半作为任务提交，另一半在当前线程继续拆分
+ * @param group 任务组
+ * @param first 区间起点
+ * @param last 区间终点
+ * @param grain 不再拆分的区间长度
+ * @param f 以(first, last)为参数的可调用对象
+ */
+template <std::integral Index, typename F>
+void split_range(
+    TaskGroup& group, Index first, Index last, Index grain, const F& f
+) {
+    while (last - first > grain) {
+        const Index mid = first + (last - first) / 2;
+        group.run([&group, mid, last, grain, &f] {
+            split_range(group, mid, last, grain, f);
+        });
+        last = mid;
+    }
+    f(first, last);
+}
+
+}  // namespace parallel
+
+/**
+ * @brief 将区间[first, last)拆分为长度不超过grain的子区间并行处理
+ * @details 拆分方式只由区间和grain决定，与线程数无关
+ * @param first 区间起点
+ * @param last 区间终点
+ * @param grain 每个子区间的最大长度，小于1时按1处理
+ * @param f 以子区间(begin, end)为参数的可调用对象
+ * @param pool 执行任务的线程池
+ * @throw f抛出的第一个异常
+ */
+template <std::integral Index, typename F>
+void parallel_for(
+    Index first, Index last, Index grain, F&& f,
+    ThreadPool& pool = ThreadPool::instance()
+) {
+    if (last <= first) {
+        return;
+    }
+    grain = std::max<Index>(grain, 1);
+    if (last - first <= grain) {
+        f(first, last);
+        return;
+    }
+    TaskGroup group(pool);
+    try {
+        parallel::split_range(group, first, last, grain, f);
+    } catch (...) {
+        // 当前线程中的异常也要等其他任务结束后再抛出
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+/**
+ * @brief 将区间[first, last)自动拆分并行处理
+ * @details 子区间长度约为区间长度除以线程数的8倍，以便负载均衡
+ * @param first 区间起点
+ * @param last 区间终点
+ * @param f 以子区间(begin, end)为参数的可调用对象
+ * @param pool 执行任务的线程池
+ */
+template <std::integral Index, typename F>
+void parallel_for(
+    Index first, Index last, F&& f, ThreadPool& pool = ThreadPool::instance()
+) {
+    if (last <= first) {
+        return;
+    }
+    const auto chunks = static_cast<Index>(pool.size() * 8);
+    const Index grain = std::max<Index>((last - first) / chunks, 1);
+    user::parallel_for(first, last, grain, std::forward<F>(f), pool);
+}
+
+/**
+ * @brief 静态地将chunks个块分给线程池中的线程
+ * @details 块被分成min(chunks, pool.size())段连续的块，第t段只由第t个任务
+ * 按顺序处理，当前线程处理第0段。块到任务的映射只由块数和线程数决定，
+ * 不受窃取顺序影响，便于复现结果
+ * @param chunks 块数
+ * @param f 以块编号为参数的可调用对象
+ * @param pool 执行任务的线程池
+ * @throw f抛出的第一个异常
+ */
+template <typename F>
+void parallel_for_static(
+    std::size_t chunks, F&& f, ThreadPool& pool = ThreadPool::instance()
+) {
+    const std::size_t lanes = std::min(chunks, pool.size());
+    if (lanes <= 1) {
+        for (std::size_t c = 0; c < chunks; ++c) {
+            f(c);
+        }
+        return;
+    }
+    auto run_lane = [chunks, lanes, &f](std::size_t t) {
+        const std::size_t last = (t + 1) * chunks / lanes;
+        for (std::size_t c = t * chunks / lanes; c < last; ++c) {
+            f(c);
+        }
+    };
+    TaskGroup group(pool);
+    for (std::size_t t = 1; t < lanes; ++t) {
+        group.run([&run_lane, t] { run_lane(t); });
+    }
+    try {
+        run_lane(0);
+    } catch (...) {
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+}  // namespace user
+
+#endif  // PARALLEL_FOR_HPP
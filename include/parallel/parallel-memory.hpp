@@ -0,0 +1,236 @@
+/* UTF-8 */
+/**
+ * @file parallel-memory.hpp
+ * @brief 大块内存的并行填充与复制
+ * @details 元素可平凡复制且总字节数不小于阈值时，将区间按连续的块分给
+ * 线程池中的线程填充或复制。新分配的内存页在第一次写入时才真正分配，
+ * 并放置在写入线程所在的NUMA节点上(first-touch)，因此并行初始化
+ * 同时使各部分内存分散在处理它们的线程附近。
+ * 定义宏USER_NO_PARALLEL_INIT可以在编译期关闭并行路径，
+ * 也可以在运行期通过set_parallel_init_threshold关闭。
+ * 总字节数超过stream_threshold()时，每块使用非临时写入(见simd-stream.hpp)
+ */
+
+#ifndef PARALLEL_MEMORY_HPP
+#define PARALLEL_MEMORY_HPP
+
+#include <algorithm/simd-stream.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <parallel/parallel-for.hpp>
+#include <parallel/thread-pool.hpp>
+#include <type_traits>
+
+namespace user {
+
+namespace parallel {
+
+// 默认的并行阈值(字节)
+inline constexpr std::size_t default_init_threshold = std::size_t{1} << 25;
+// 每个子任务处理的最小字节数，与透明大页的大小相同
+inline constexpr std::size_t init_grain_bytes = std::size_t{1} << 21;
+
+/**
+ * @brief 获取保存并行阈值的变量
+ * @return 阈值的引用
+ */
+inline std::atomic<std::size_t>& S_init_threshold() noexcept {
+    static std::atomic<std::size_t> threshold{default_init_threshold};
+    return threshold;
+}
+
+/**
+ * @brief 判断n个Tp的填充或复制是否使用并行路径
+ * @param n 元素个数
+ * @return 应当并行时返回true
+ */
+template <typename Tp>
+bool use_parallel_init(std::size_t n) {
+#if defined(USER_NO_PARALLEL_INIT)
+    (void)n;
+    return false;
+#else
+    if constexpr (!std::is_trivially_copyable_v<Tp>) {
+        return false;
+    } else {
+        const std::size_t threshold =
+            S_init_threshold().load(std::memory_order_relaxed);
+        // 先比较阈值，避免小容器创建全局线程池
+        return n >= threshold / sizeof(Tp) && n != 0 &&
+               ThreadPool::instance().size() > 1;
+    }
+#endif
+}
+
+/**
+ * @brief 对区间的每个连续块并行调用f
+ * @param n 元素个数
+ * @param f 以块(begin, end)为参数的可调用对象
+ */
+template <typename Tp, typename F>
+void for_each_block(std::size_t n, const F& f) {
+    ThreadPool& pool = ThreadPool::instance();
+    // 每个线程分到少量连续的块，使内存页集中在少数节点上
+    const std::size_t grain = std::max(
+        n / (pool.size() * 4),
+        std::max<std::size_t>(init_grain_bytes / sizeof(Tp), 1)
+    );
+    user::parallel_for<std::size_t>(0, n, grain, f, pool);
+}
+
+/**
+ * @brief 以n个value填充一块内存
+ * @param first 区间起点
+ * @param n 元素个数
+ * @param value 填充的值
+ * @param stream 是否使用非临时写入
+ * @param initialized 区间中的元素是否已经构造
+ * @return 区间终点
+ */
+template <typename Tp>
+Tp* fill_block(
+    Tp* first, std::size_t n, const Tp& value, bool stream, bool initialized
+) {
+    if constexpr (std::is_trivially_copyable_v<Tp>) {
+        if (stream) {
+            return simd::stream_fill_n(first, n, value);
+        }
+    }
+    return initialized ? std::fill_n(first, n, value)
+                       : std::uninitialized_fill_n(first, n, value);
+}
+
+/**
+ * @brief 复制一块内存
+ * @param src 源区间起点
+ * @param n 元素个数
+ * @param dst 目标区间起点
+ * @param stream 是否使用非临时写入
+ * @param initialized 目标区间中的元素是否已经构造
+ * @return 目标区间终点
+ */
+template <typename Tp>
+Tp* copy_block(
+    const Tp* src, std::size_t n, Tp* dst, bool stream, bool initialized
+) {
+    if constexpr (std::is_trivially_copyable_v<Tp>) {
+        if (stream) {
+            return simd::stream_copy_n(src, n, dst);
+        }
+    }
+    return initialized ? std::copy_n(src, n, dst)
+                       : std::uninitialized_copy_n(src, n, dst);
+}
+
+/**
+ * @brief 以n个value填充区间，数据量较大时并行填充
+ * @param first 区间起点
+ * @param n 元素个数
+ * @param value 填充的值
+ * @param initialized 区间中的元素是否已经构造
+ * @return 区间终点
+ */
+template <typename Tp>
+Tp* fill_range(Tp* first, std::size_t n, const Tp& value, bool initialized) {
+    const bool stream = simd::use_stream<Tp>(n);
+    if (!use_parallel_init<Tp>(n)) {
+        return fill_block(first, n, value, stream, initialized);
+    }
+    for_each_block<Tp>(n, [=, &value](std::size_t b, std::size_t e) {
+        fill_block(first + b, e - b, value, stream, initialized);
+    });
+    return first + n;
+}
+
+/**
+ * @brief 复制n个元素，数据量较大时并行复制
+ * @param src 源区间起点
+ * @param n 元素个数
+ * @param dst 目标区间起点，不能与源区间重叠
+ * @param initialized 目标区间中的元素是否已经构造
+ * @return 目标区间终点
+ */
+template <typename Tp>
+Tp* copy_range(const Tp* src, std::size_t n, Tp* dst, bool initialized) {
+    const bool stream = simd::use_stream<Tp>(n);
+    if (!use_parallel_init<Tp>(n)) {
+        return copy_block(src, n, dst, stream, initialized);
+    }
+    for_each_block<Tp>(n, [=](std::size_t b, std::size_t e) {
+        copy_block(src + b, e - b, dst + b, stream, initialized);
+    });
+    return dst + n;
+}
+
+/**
+ * @brief 以n个value构造未初始化的区间
+ * @param first 区间起点
+ * @param n 元素个数
+ * @param value 填充的值
+ * @return 区间终点
+ */
+template <typename Tp>
+Tp* uninitialized_fill_n(Tp* first, std::size_t n, const Tp& value) {
+    return fill_range(first, n, value, false);
+}
+
+/**
+ * @brief 以n个value为已经构造的区间赋值
+ * @param first 区间起点
+ * @param n 元素个数
+ * @param value 填充的值
+ * @return 区间终点
+ */
+template <typename Tp>
+Tp* fill_n(Tp* first, std::size_t n, const Tp& value) {
+    return fill_range(first, n, value, true);
+}
+
+/**
+ * @brief 将n个元素复制到未初始化的区间
+ * @param src 源区间起点
+ * @param n 元素个数
+ * @param dst 目标区间起点，不能与源区间重叠
+ * @return 目标区间终点
+ */
+template <typename Tp>
+Tp* uninitialized_copy_n(const Tp* src, std::size_t n, Tp* dst) {
+    return copy_range(src, n, dst, false);
+}
+
+/**
+ * @brief 将n个元素复制到已经构造的区间
+ * @param src 源区间起点
+ * @param n 元素个数
+ * @param dst 目标区间起点，不能与源区间重叠
+ * @return 目标区间终点
+ */
+template <typename Tp>
+Tp* copy_n(const Tp* src, std::size_t n, Tp* dst) {
+    return copy_range(src, n, dst, true);
+}
+
+}  // namespace parallel
+
+/**
+ * @brief 设置Vector并行填充与复制的阈值
+ * @param bytes 总字节数不小于此值时并行处理，
+ * 为std::numeric_limits<std::size_t>::max()时关闭并行路径
+ */
+inline void set_parallel_init_threshold(std::size_t bytes) noexcept {
+    parallel::S_init_threshold().store(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 获取Vector并行填充与复制的阈值
+ * @return 阈值(字节)
+ */
+inline std::size_t parallel_init_threshold() noexcept {
+    return parallel::S_init_threshold().load(std::memory_order_relaxed);
+}
+
+}  // namespace user
+
+#endif  // PARALLEL_MEMORY_HPP
@@ -0,0 +1,420 @@
+/* UTF-8 */
+/**
+ * @file spsc-ring.hpp
+ * @brief user::SpscRing类
+ * @details 单生产者单消费者环形缓冲区。容量为2的幂，读写下标只增不减，
+ * 用掩码取得槽位。双方各自缓存对方的下标，只有缓存的值显示已满(或为空)
+ * 时才重新读取对方的缓存行，所有操作都是wait-free的。
+ * reserve()/commit()与peek()/consume()直接暴露槽位中连续的一段，
+ * 生产者可以在槽位中就地写入，消费者可以就地读取，不需要中间复制。
+ * Blocking为true时可以使用阻塞的push()/pop()，等待时使用futex睡眠
+ */
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <my-memory/my-allocator.hpp>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <userconcept/myconcept.hpp>
+#include <utility>
+
+namespace user {
+
+/**
+ * @class SpscRing
+ * @brief 单生产者单消费者的wait-free环形缓冲区
+ * @tparam T 元素类型
+ * @tparam Alloc 分配器类型，使用MmapAllocator<T, Threshold, true>时大容量
+ * 的缓冲区可以使用透明大页
+ * @tparam Blocking 是否支持阻塞的push()/pop()，支持时每次提交多一次
+ * 内存栅栏
+ * @note 生产者的成员函数(try_push、reserve、commit等)只能由一个线程调用，
+ * 消费者的成员函数(try_pop、peek、consume等)只能由另一个线程调用
+ */
+template <
+    NotConstVolatile T, IsAllocator Alloc = Allocator<T>,
+    bool Blocking = false>
+    requires SameTypeAlloc<T, Alloc>
+class SpscRing {
+    using Alloc_traits = std::allocator_traits<Alloc>;  // 分配器特性
+    using pointer = typename Alloc_traits::pointer;     // 槽位指针类型
+
+public:
+    using value_type = T;                 // 元素类型
+    using size_type = std::size_t;        // 元素个数类型
+    using allocator_type = Alloc;         // 分配器类型
+
+    /**
+     * @brief 构造缓冲区
+     * @param capacity 容量，会被上取到2的幂
+     * @param a 分配器
+     */
+    explicit SpscRing(
+        size_type capacity, const allocator_type& a = allocator_type()
+    )
+        : alloc(a),
+          mask(std::bit_ceil(std::max<size_type>(capacity, 1)) - 1),
+          buffer(Alloc_traits::allocate(alloc, mask + 1)) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief 析构函数，析构剩余的元素并释放缓冲区
+     */
+    ~SpscRing() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const size_type last = tail.load(std::memory_order_relaxed);
+            for (size_type i = head.load(std::memory_order_relaxed);
+                 i != last; ++i) {
+                Alloc_traits::destroy(alloc, buffer + (i & mask));
+            }
+        }
+        Alloc_traits::deallocate(alloc, buffer, mask + 1);
+    }
+
+    /* 生产者 */
+
+    /**
+     * @brief 尝试在队尾构造元素
+     * @param args 构造函数参数
+     * @return 缓冲区未满并写入成功时返回true
+     */
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head > mask && !M_refresh_head(t, 1)) {
+            return false;
+        }
+        Alloc_traits::construct(
+            alloc, buffer + (t & mask), std::forward<Args>(args)...
+        );
+        M_publish_tail(t + 1);
+        return true;
+    }
+
+    /**
+     * @brief 尝试在队尾插入元素
+     * @param value 元素的值
+     * @return 缓冲区未满并写入成功时返回true
+     */
+    bool try_push(const value_type& value) { return try_emplace(value); }
+    bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+    /**
+     * @brief 获取队尾连续的空闲槽位，供生产者就地写入
+     * @param n 希望获取的槽位个数
+     * @return 最多n个连续的空闲槽位，缓冲区已满时为空。到达缓冲区末尾时
+     * 只返回末尾之前的部分，提交后再次调用可获取开头的部分
+     * @note 槽位中没有对象，非隐式生存期类型需要用std::construct_at构造，
+     * 然后调用commit()提交
+     */
+    [[nodiscard]] std::span<T> reserve(size_type n) noexcept {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        size_type free = mask + 1 - (t - cached_head);
+        if (free < n) {
+            M_refresh_head(t, n);
+            free = mask + 1 - (t - cached_head);
+        }
+        const size_type offset = t & mask;
+        return {buffer + offset, std::min({n, free, mask + 1 - offset})};
+    }
+
+    /**
+     * @brief 提交reserve()获取的槽位中已构造的前k个元素
+     * @param k 元素个数，不能超过reserve()返回的槽位个数
+     */
+    void commit(size_type k) noexcept {
+        M_publish_tail(tail.load(std::memory_order_relaxed) + k);
+    }
+
+    /**
+     * @brief 尝试批量写入，最多复制两段连续的槽位
+     * @param first 元素的起始迭代器
+     * @param n 最多写入的元素个数
+     * @return 实际写入的元素个数，即从first开始使用的元素个数
+     */
+    template <std::input_iterator InputIt>
+    size_type try_push_bulk(InputIt first, size_type n) {
+        size_type count = 0;
+        // 第二次获取的是缓冲区开头的部分
+        for (int part = 0; part < 2 && count < n; ++part) {
+            const std::span<T> span = reserve(n - count);
+            if (span.empty()) {
+                break;
+            }
+            T* p = span.data();
+            if constexpr (std::contiguous_iterator<InputIt> &&
+                          std::is_trivially_copyable_v<T> &&
+                          std::is_same_v<std::iter_value_t<InputIt>, T>) {
+                std::copy_n(std::to_address(first), span.size(), p);
+                first += span.size();
+            } else {
+                size_type k = 0;
+                try {
+                    for (; k < span.size(); ++k, ++first) {
+                        Alloc_traits::construct(alloc, p + k, *first);
+                    }
+                } catch (...) {
+                    // 已构造的元素照常提交
+                    commit(k);
+                    throw;
+                }
+            }
+            commit(span.size());
+            count += span.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief 在队尾插入元素，缓冲区已满时阻塞
+     * @param value 元素的值
+     */
+    void push(const value_type& value)
+        requires Blocking
+    {
+        S_wait(producer_wait, [&] { return try_emplace(value); });
+    }
+    void push(value_type&& value)
+        requires Blocking
+    {
+        S_wait(producer_wait, [&] { return try_emplace(std::move(value)); });
+    }
+
+    /* 消费者 */
+
+    /**
+     * @brief 获取队首元素
+     * @return 指向队首元素的指针，缓冲区为空时返回nullptr
+     */
+    [[nodiscard]] T* front() noexcept {
+        const size_type h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail && !M_refresh_tail(h, 1)) {
+            return nullptr;
+        }
+        return buffer + (h & mask);
+    }
+
+    /**
+     * @brief 尝试取出队首元素
+     * @param out 保存取出的元素
+     * @return 缓冲区非空并取出成功时返回true
+     */
+    bool try_pop(value_type& out) {
+        T* p = front();
+        if (p == nullptr) {
+            return false;
+        }
+        out = std::move(*p);
+        consume(1);
+        return true;
+    }
+
+    /**
+     * @brief 获取队首连续的可读元素，供消费者就地读取
+     * @param n 希望获取的元素个数
+     * @return 最多n个连续的元素，缓冲区为空时为空。到达缓冲区末尾时只返回
+     * 末尾之前的部分
+     */
+    [[nodiscard]] std::span<T> peek(size_type n) noexcept {
+        const size_type h = head.load(std::memory_order_relaxed);
+        size_type ready = cached_tail - h;
+        if (ready < n) {
+            M_refresh_tail(h, n);
+            ready = cached_tail - h;
+        }
+        const size_type offset = h & mask;
+        return {buffer + offset, std::min({n, ready, mask + 1 - offset})};
+    }
+
+    /**
+     * @brief 析构队首的k个元素并归还槽位
+     * @param k 元素个数，不能超过peek()返回的元素个数
+     */
+    void consume(size_type k) noexcept {
+        const size_type h = head.load(std::memory_order_relaxed);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < k; ++i) {
+                Alloc_traits::destroy(alloc, buffer + ((h + i) & mask));
+            }
+        }
+        head.store(h + k, std::memory_order_release);
+        if constexpr (Blocking) {
+            S_wake(producer_wait);
+        }
+    }
+
+    /**
+     * @brief 尝试批量取出，最多复制两段连续的槽位
+     * @param out 输出迭代器
+     * @param n 最多取出的元素个数
+     * @return 实际取出的元素个数
+     */
+    template <typename OutputIt>
+    size_type try_pop_bulk(OutputIt out, size_type n) {
+        size_type count = 0;
+        for (int part = 0; part < 2 && count < n; ++part) {
+            const std::span<T> span = peek(n - count);
+            if (span.empty()) {
+                break;
+            }
+            out = std::move(span.begin(), span.end(), out);
+            consume(span.size());
+            count += span.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief 取出队首元素，缓冲区为空时阻塞
+     * @param out 保存取出的元素
+     */
+    void pop(value_type& out)
+        requires Blocking
+    {
+        S_wait(consumer_wait, [&] { return try_pop(out); });
+    }
+
+    /* 双方均可调用 */
+
+    /**
+     * @brief 获取缓冲区的容量
+     */
+    [[nodiscard]] size_type capacity() const noexcept { return mask + 1; }
+
+    /**
+     * @brief 获取元素个数的近似值
+     * @return 元素个数，另一方并发修改时只是一个估计
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        const size_type h = head.load(std::memory_order_acquire);
+        const size_type t = tail.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+    /**
+     * @brief 判断缓冲区是否为空(近似值)
+     */
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+private:
+    /**
+     * @brief 重新读取消费者的下标
+     * @param t 生产者的下标
+     * @param n 需要的空闲槽位个数
+     * @return 空闲槽位不少于n时返回true
+     */
+    bool M_refresh_head(size_type t, size_type n) noexcept {
+        cached_head = head.load(std::memory_order_acquire);
+        return mask + 1 - (t - cached_head) >= n;
+    }
+
+    /**
+     * @brief 重新读取生产者的下标
+     * @param h 消费者的下标
+     * @param n 需要的元素个数
+     * @return 可读元素不少于n时返回true
+     */
+    bool M_refresh_tail(size_type h, size_type n) noexcept {
+        cached_tail = tail.load(std::memory_order_acquire);
+        return cached_tail - h >= n;
+    }
+
+    /**
+     * @brief 发布生产者的下标
+     * @param t 新的下标
+     */
+    void M_publish_tail(size_type t) noexcept {
+        tail.store(t, std::memory_order_release);
+        if constexpr (Blocking) {
+            S_wake(consumer_wait);
+        }
+    }
+
+    /**
+     * @brief 对方正在睡眠时将其唤醒
+     * @param state 对方的futex字，1表示正在睡眠
+     * @note 栅栏与S_wait()中设置状态后的栅栏配对:要么此处看到对方在睡眠，
+     * 要么对方设置状态后的重试看到刚发布的下标
+     */
+    static void S_wake(std::atomic<std::uint32_t>& state) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (state.load(std::memory_order_relaxed) != 0) {
+            state.store(0, std::memory_order_relaxed);
+            ::syscall(
+                SYS_futex, reinterpret_cast<std::uint32_t*>(&state),
+                FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0
+            );
+        }
+    }
+
+    /**
+     * @brief 重复尝试直到成功，短暂自旋之后使用futex睡眠
+     * @param state 自己的futex字
+     * @param attempt 返回是否成功的可调用对象
+     */
+    template <typename F>
+    static void S_wait(std::atomic<std::uint32_t>& state, F&& attempt) {
+        while (!attempt()) {
+            bool done = false;
+            for (int spin = 0; spin < 64 && !done; ++spin) {
+                std::this_thread::yield();
+                done = attempt();
+            }
+            if (done) {
+                return;
+            }
+            state.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (attempt()) {
+                state.store(0, std::memory_order_relaxed);
+                return;
+            }
+            // 对方在此之前已经将状态清零时立即返回
+            ::syscall(
+                SYS_futex, reinterpret_cast<std::uint32_t*>(&state),
+                FUTEX_WAIT_PRIVATE, 1, nullptr, nullptr, 0
+            );
+        }
+    }
+
+    static_assert(
+        sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+        "futex word must be a plain 32-bit integer"
+    );
+
+    // 双方只读的数据
+    [[no_unique_address]] Alloc alloc;  // 分配器
+    size_type mask;                     // 容量 - 1
+    pointer buffer;                     // 槽位
+
+    // 生产者写入的数据，cached_head只有生产者访问
+    alignas(64) std::atomic<size_type> tail{0};  // 下一次写入的下标
+    size_type cached_head = 0;                   // 缓存的消费者下标
+
+    // 消费者写入的数据，cached_tail只有消费者访问
+    alignas(64) std::atomic<size_type> head{0};  // 下一次读取的下标
+    size_type cached_tail = 0;                   // 缓存的生产者下标
+
+    // 阻塞时使用的futex字，只在一方睡眠时才会被写入
+    alignas(64) std::atomic<std::uint32_t> producer_wait{0};  // 生产者
+    std::atomic<std::uint32_t> consumer_wait{0};              // 消费者
+};
+
+}  // namespace user
+
+#endif  // SPSC_RING_HPP
@@ -0,0 +1,379 @@
+/* UTF-8 */
+/**
+ * @file thread-pool.hpp
+ * @brief user::ThreadPool类与user::TaskGroup类
+ * @details 工作窃取线程池:每个工作线程拥有一个Chase-Lev双端队列，
+ * 工作线程提交的任务压入自己的队列，外部线程提交的任务进入共享的注入队列;
+ * 空闲的工作线程依次检查自己的队列、注入队列，再随机从其他线程窃取任务。
+ * 等待任务组的线程也会执行任务，因此任务中可以嵌套创建和等待任务组
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP 2
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <parallel/work-stealing-deque.hpp>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace user {
+
+/**
+ * @struct Task
+ * @brief 线程池中的任务，invoke执行任务并释放任务对象
+ */
+struct Task {
+    void (*invoke)(Task*);  // 执行并销毁任务
+};
+
+/**
+ * @class ThreadPool
+ * @brief 工作窃取线程池
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 创建线程池
+     * @param threads 工作线程数，默认为硬件线程数
+     */
+    explicit ThreadPool(std::size_t threads = S_default_threads())
+        : worker_count(std::max<std::size_t>(threads, 1)),
+          workers(new Worker[worker_count]) {
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            workers[i].thread = std::thread([this, i] { M_worker_loop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 停止并回收所有工作线程
+     * @warning 析构前应等待所有任务组完成，未执行的任务会被丢弃
+     */
+    ~ThreadPool() {
+        stop.store(true);
+        epoch.fetch_add(1);
+        epoch.notify_all();
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            workers[i].thread.join();
+        }
+    }
+
+    /**
+     * @brief 获取全局线程池
+     * @return 进程内共享的线程池，第一次调用时创建
+     */
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief 获取工作线程数
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return worker_count; }
+
+    /**
+     * @brief 获取当前线程在此线程池中的编号
+     * @return 工作线程的编号，不是此线程池的工作线程时返回size()
+     */
+    [[nodiscard]] std::size_t current_index() const noexcept {
+        return S_tls_pool == this ? S_tls_index : worker_count;
+    }
+
+    /**
+     * @brief 提交任务
+     * @param task 任务，执行后由任务自己释放
+     */
+    void submit(Task* task) {
+        if (S_tls_pool == this) {
+            workers[S_tls_index].deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(inject_mutex);
+            injected.push_back(task);
+            inject_size.fetch_add(1, std::memory_order_relaxed);
+        }
+        M_wake();
+    }
+
+    /**
+     * @brief 提交不需要等待的任务
+     * @param f 可调用对象
+     * @note f抛出的异常会导致std::terminate
+     */
+    template <typename F>
+    void execute(F&& f) {
+        submit(new FunctionTask<std::decay_t<F>>{
+            {&FunctionTask<std::decay_t<F>>::S_invoke}, std::forward<F>(f)
+        });
+    }
+
+    /**
+     * @brief 取出并执行一个任务
+     * @return 执行了任务时返回true，没有可执行的任务时返回false
+     */
+    bool run_one() {
+        Task* task = M_find_task();
+        if (task == nullptr) {
+            return false;
+        }
+        task->invoke(task);
+        return true;
+    }
+
+private:
+    /**
+     * @struct Worker
+     * @brief 工作线程及其任务队列
+     */
+    struct alignas(64) Worker {
+        WorkStealingDeque<Task*> deque;  // 任务队列
+        std::thread thread;              // 线程
+    };
+
+    /**
+     * @struct FunctionTask
+     * @brief 保存可调用对象的任务
+     */
+    template <typename F>
+    struct FunctionTask : Task {
+        F f;  // 可调用对象
+
+        static void S_invoke(Task* task) {
+            auto* self = static_cast<FunctionTask*>(task);
+            self->f();
+            delete self;
+        }
+    };
+
+    /**
+     * @brief 工作线程的主循环
+     * @param index 工作线程编号
+     */
+    void M_worker_loop(std::size_t index) {
+        S_tls_pool = this;
+        S_tls_index = index;
+        while (true) {
+            if (run_one()) {
+                continue;
+            }
+            // 没有任务时先让出时间片等待一会，减少频繁睡眠唤醒的开销
+            bool found = false;
+            for (int spin = 0; spin < 64 && !found; ++spin) {
+                std::this_thread::yield();
+                found = run_one();
+            }
+            if (found) {
+                continue;
+            }
+            // 先读取epoch再检查任务，提交者在压入任务之后增加epoch，
+            // 所以此后提交的任务一定会使wait()返回
+            const std::uint32_t e = epoch.load();
+            if (stop.load()) {
+                break;
+            }
+            if (run_one()) {
+                continue;
+            }
+            sleepers.fetch_add(1);
+            epoch.wait(e);
+            sleepers.fetch_sub(1);
+        }
+        S_tls_pool = nullptr;
+    }
+
+    /**
+     * @brief 查找一个可执行的任务
+     * @return 任务，没有时返回nullptr
+     */
+    Task* M_find_task() {
+        Task* task = nullptr;
+        const bool is_worker = S_tls_pool == this;
+        if (is_worker && workers[S_tls_index].deque.pop(task)) {
+            return task;
+        }
+        // 先不加锁检查注入队列是否为空，避免空闲线程争抢互斥锁
+        if (inject_size.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(inject_mutex);
+            if (!injected.empty()) {
+                task = injected.front();
+                injected.pop_front();
+                inject_size.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        // 从随机位置开始依次尝试窃取
+        const std::size_t start = S_random() % worker_count;
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            const std::size_t victim = (start + i) % worker_count;
+            if (is_worker && victim == S_tls_index) {
+                continue;
+            }
+            if (workers[victim].deque.steal(task)) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief 提交任务后唤醒睡眠的工作线程
+     */
+    void M_wake() {
+        epoch.fetch_add(1);
+        if (sleepers.load() != 0) {
+            epoch.notify_one();
+        }
+    }
+
+    /**
+     * @brief 线程局部的xorshift随机数
+     */
+    static std::uint32_t S_random() noexcept {
+        thread_local std::uint32_t state = static_cast<std::uint32_t>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1
+        );
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /**
+     * @brief 默认的工作线程数
+     */
+    static std::size_t S_default_threads() noexcept {
+        const unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // 当前线程所属的线程池和编号
+    static inline thread_local ThreadPool* S_tls_pool = nullptr;
+    static inline thread_local std::size_t S_tls_index = 0;
+
+    std::size_t worker_count;                 // 工作线程数
+    std::unique_ptr<Worker[]> workers;        // 工作线程
+    std::mutex inject_mutex;                  // 保护注入队列
+    std::deque<Task*> injected;               // 外部线程提交的任务
+    std::atomic<std::size_t> inject_size{0};  // 注入队列中的任务数
+    std::atomic<std::uint32_t> epoch{0};      // 每次提交任务时递增
+    std::atomic<std::uint32_t> sleepers{0};   // 睡眠中的工作线程数
+    std::atomic<bool> stop{false};            // 线程池是否正在析构
+};
+
+/**
+ * @class TaskGroup
+ * @brief 一组可以共同等待的任务
+ * @details wait()在等待期间执行线程池中的任务，任务中抛出的第一个异常
+ * 会在wait()中重新抛出
+ */
+class TaskGroup {
+public:
+    /**
+     * @brief 创建任务组
+     * @param pool 执行任务的线程池
+     */
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::instance()) noexcept
+        : pool(&pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief 析构前等待所有任务完成，忽略任务中的异常
+     */
+    ~TaskGroup() { M_wait_pending(); }
+
+    /**
+     * @brief 在线程池中运行任务
+     * @param f 可调用对象
+     */
+    template <typename F>
+    void run(F&& f) {
+        using task_type = GroupTask<std::decay_t<F>>;
+        auto* task =
+            new task_type{{&task_type::S_invoke}, std::forward<F>(f), this};
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool->submit(task);
+    }
+
+    /**
+     * @brief 等待所有任务完成
+     * @throw 任务中抛出的第一个异常
+     */
+    void wait() {
+        M_wait_pending();
+        if (error) {
+            std::exception_ptr e = std::exchange(error, nullptr);
+            has_error.store(false, std::memory_order_relaxed);
+            std::rethrow_exception(e);
+        }
+    }
+
+    /**
+     * @brief 获取执行任务的线程池
+     */
+    [[nodiscard]] ThreadPool& get_pool() const noexcept { return *pool; }
+
+private:
+    /**
+     * @struct GroupTask
+     * @brief 属于任务组的任务
+     */
+    template <typename F>
+    struct GroupTask : Task {
+        F f;               // 可调用对象
+        TaskGroup* group;  // 所属的任务组
+
+        static void S_invoke(Task* task) {
+            auto* self = static_cast<GroupTask*>(task);
+            TaskGroup* group = self->group;
+            try {
+                self->f();
+            } catch (...) {
+                group->M_set_error(std::current_exception());
+            }
+            delete self;
+            // 必须最后修改计数，之后任务组可能已经被销毁
+            group->pending.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief 等待计数归零，期间帮助执行任务
+     */
+    void M_wait_pending() {
+        while (pending.load(std::memory_order_acquire) != 0) {
+            if (!pool->run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief 保存第一个异常
+     */
+    void M_set_error(std::exception_ptr e) noexcept {
+        if (!has_error.exchange(true, std::memory_order_acq_rel)) {
+            error = std::move(e);
+        }
+    }
+
+    ThreadPool* pool;                     // 执行任务的线程池
+    std::atomic<std::size_t> pending{0};  // 未完成的任务数
+    std::atomic<bool> has_error{false};   // 是否已经保存了异常
+    std::exception_ptr error;             // 第一个异常
+};
+
+}  // namespace user
+
+#endif  // THREAD_POOL_HPP
@@ -0,0 +1,204 @@
+/* UTF-8 */
+/**
+ * @file work-stealing-deque.hpp
+ * @brief user::WorkStealingDeque类
+ * @details Chase-Lev工作窃取双端队列，所有者线程在底部压入和弹出，
+ * 其他线程从顶部窃取。内存序参考Lê等人在
+ * "Correct and Efficient Work-Stealing for Weak Memory Models"中的实现
+ */
+
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP 2
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace user {
+
+/**
+ * @class WorkStealingDeque
+ * @brief 单所有者、多窃取者的无锁双端队列
+ * @tparam T 元素类型，必须可以平凡复制并且能够放入std::atomic(通常为指针)
+ * @note push()和pop()只能由所有者线程调用，steal()可以由任意线程调用
+ */
+template <typename T>
+class WorkStealingDeque {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "WorkStealingDeque requires trivially copyable elements"
+    );
+
+public:
+    /**
+     * @brief 构造队列
+     * @param capacity 初始容量，会被上取到2的幂
+     */
+    explicit WorkStealingDeque(std::size_t capacity = 256)
+        : array(new Array(S_round_capacity(capacity), nullptr)) {}
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    ~WorkStealingDeque() {
+        // 扩容时被替换的数组可能仍在被窃取者读取，所以直到析构才释放
+        Array* a = array.load(std::memory_order_relaxed);
+        while (a != nullptr) {
+            Array* prev = a->prev;
+            delete a;
+            a = prev;
+        }
+    }
+
+    /**
+     * @brief 在底部压入元素(仅所有者线程)
+     * @param x 需要压入的元素
+     */
+    void push(T x) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<std::int64_t>(a->capacity) - 1) {
+            a = M_grow(a, b, t);
+        }
+        a->put(b, x);
+        // 使用release存储代替release栅栏加relaxed存储，
+        // 与steal()中bottom的acquire读取配对，ThreadSanitizer也能识别
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 从底部弹出元素(仅所有者线程)
+     * @param out 保存弹出的元素
+     * @return 队列非空并弹出成功时返回true
+     */
+    bool pop(T& out) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            // 队列为空
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = a->get(b);
+        if (t == b) {
+            // 只剩最后一个元素，与窃取者竞争
+            const bool won = top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+            );
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 从顶部窃取元素(任意线程)
+     * @param out 保存窃取的元素
+     * @return 窃取成功时返回true，队列为空或与其他线程竞争失败时返回false
+     */
+    bool steal(T& out) {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        Array* a = array.load(std::memory_order_acquire);
+        const T x = a->get(t);
+        if (!top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+            )) {
+            return false;
+        }
+        out = x;
+        return true;
+    }
+
+    /**
+     * @brief 获取队列中元素个数的近似值
+     * @return 元素个数，其他线程并发修改时只是一个估计
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    /**
+     * @brief 判断队列是否为空(近似值)
+     */
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+private:
+    /**
+     * @struct Array
+     * @brief 环形数组，容量为2的幂
+     */
+    struct Array {
+        std::size_t capacity;    // 容量
+        std::size_t mask;        // capacity - 1
+        std::atomic<T>* buffer;  // 元素
+        Array* prev;             // 扩容前的数组
+
+        Array(std::size_t capacity, Array* prev)
+            : capacity(capacity),
+              mask(capacity - 1),
+              buffer(new std::atomic<T>[capacity]),
+              prev(prev) {}
+
+        ~Array() { delete[] buffer; }
+
+        T get(std::int64_t i) const noexcept {
+            return buffer[static_cast<std::size_t>(i) & mask].load(
+                std::memory_order_relaxed
+            );
+        }
+
+        void put(std::int64_t i, T x) noexcept {
+            buffer[static_cast<std::size_t>(i) & mask].store(
+                x, std::memory_order_relaxed
+            );
+        }
+    };
+
+    /**
+     * @brief 将数组扩容为原来的两倍
+     * @param a 当前数组
+     * @param b 底部下标
+     * @param t 顶部下标
+     * @return 新数组
+     */
+    Array* M_grow(Array* a, std::int64_t b, std::int64_t t) {
+        auto* grown = new Array(a->capacity * 2, a);
+        for (std::int64_t i = t; i != b; ++i) {
+            grown->put(i, a->get(i));
+        }
+        array.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    /**
+     * @brief 将容量上取到2的幂
+     */
+    static constexpr std::size_t S_round_capacity(std::size_t n) noexcept {
+        std::size_t capacity = 2;
+        while (capacity < n) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // 顶部与底部位于不同的缓存行，避免所有者和窃取者之间的伪共享
+    alignas(64) std::atomic<std::int64_t> top{0};     // 窃取者使用的一端
+    alignas(64) std::atomic<std::int64_t> bottom{0};  // 所有者使用的一端
+    alignas(64) std::atomic<Array*> array;            // 当前的环形数组
+};
+
+}  // namespace user
+
+#endif  // WORK_STEALING_DEQUE_HPP
@@ -6,6 +6,8 @@
 #ifndef MYCONCEPT_HPP
 #define MYCONCEPT_HPP
 #include <concepts>
+#include <cstdint>
+#include <ostream>
 #include <type_traits>
 
 namespace user {
@@ -24,6 +26,18 @@ concept IsAllocator = requires(Tp alloc) {
     } -> std::same_as<void>;
 };
 
+/**
+ * @brief 判断分配器是否支持原地重新分配(保留原有内存内容)
+ */
+template <typename Alloc>
+concept IsReallocatable =
+    requires(Alloc alloc, typename Alloc::value_type* p) {
+        // 要求具有reallocate方法，返回新内存区域的指针
+        {
+            alloc.reallocate(p, 1, 2)
+        } -> std::same_as<typename Alloc::value_type*>;
+    };
+
 /**
  * @brief 判断数值类型是否与分配器匹配
  */
@@ -44,6 +58,14 @@ concept IsInsertable = requires(std::ostream& os, Tp& insert) {
     { os << insert } -> std::same_as<std::ostream&>;
 };
 
+/**
+ * @brief 判断类型是否为SIMD算法支持的数值类型
+ */
+template <typename Tp>
+concept IsSimdArithmetic =
+    std::is_same_v<Tp, std::int32_t> || std::is_same_v<Tp, std::int64_t> ||
+    std::is_same_v<Tp, float> || std::is_same_v<Tp, double>;
+
 /**
  * @brief 用于判断类型是否可移动
  */
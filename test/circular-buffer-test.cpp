@@ -0,0 +1,84 @@
+/* UTF-8 */
+/**
+ * @file circular-buffer-test.cpp
+ * @brief CircularBuffer的回归测试
+ */
+
+#include <cassert>
+#include <container/circular-buffer.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/**
+ * @brief 交换后迭代器仍然指向原来的元素
+ */
+void test_iterator_after_swap() {
+    const int values[] = {1, 2, 3, 4, 5};
+    // 容量为4，元素从内存中间开始并绕回起点
+    user::CircularBuffer<int> a(4, values, values + 5);
+    user::CircularBuffer<int> b(2);
+    b.push_back(9);
+    auto it = a.begin();
+    const auto last = a.cend();
+    a.swap(b);
+    assert(*it == 2 && it[3] == 5);
+    assert(last - it == 4);
+    int sum = 0;
+    for (; it != last; ++it) {
+        sum += *it;
+    }
+    assert(sum == 14);
+}
+
+/**
+ * @brief 移动后迭代器仍然指向原来的元素
+ */
+void test_iterator_after_move() {
+    user::CircularBuffer<std::string> a(3);
+    a.push_back("x");
+    a.push_back("y");
+    auto it = a.begin() + 1;
+    user::CircularBuffer<std::string> b(std::move(a));
+    assert(*it == "y" && it->size() == 1);
+}
+
+/**
+ * @struct Throwing
+ * @brief 第limit次复制时抛出异常的类型
+ */
+struct Throwing {
+    static inline int copies = 0;
+    static inline int limit = 0;
+    std::string payload = std::string(64, 'p');
+
+    Throwing() = default;
+    Throwing(const Throwing& other) : payload(other.payload) {
+        if (++copies == limit) {
+            throw std::runtime_error("copy");
+        }
+    }
+};
+
+/**
+ * @brief 范围构造中途抛出异常时析构已构造的元素(由ASan检查泄漏)
+ */
+void test_range_constructor_rollback() {
+    const Throwing values[4];
+    Throwing::copies = 0;
+    Throwing::limit = 3;
+    bool thrown = false;
+    try {
+        user::CircularBuffer<Throwing> buffer(4, values, values + 4);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    test_iterator_after_swap();
+    test_iterator_after_move();
+    test_range_constructor_rollback();
+    return 0;
+}
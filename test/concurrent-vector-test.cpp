@@ -0,0 +1,116 @@
+/* UTF-8 */
+/**
+ * @file concurrent-vector-test.cpp
+ * @brief ConcurrentVector的并发追加测试
+ */
+
+#include <atomic>
+#include <cassert>
+#include <container/concurrent-vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int writers = 4;
+constexpr std::uint64_t per_writer = 40000;
+constexpr std::uint64_t batch = 10;  // 每次grow_by追加的元素个数
+
+/**
+ * @brief 元素的值，高32位为线程编号，低32位为该线程内的序号
+ */
+constexpr std::uint64_t encode(std::uint64_t thread, std::uint64_t seq) {
+    return thread << 32 | seq;
+}
+
+/**
+ * @brief 检查一组元素: 每个值都合法，并且同一线程的序号递增
+ * @param values 按下标排列的元素
+ * @param n 元素个数
+ */
+template <typename Values>
+void check_order(const Values& values, std::size_t n) {
+    std::uint64_t next[writers] = {};
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t thread = values[i] >> 32;
+        const std::uint64_t seq = values[i] & 0xFFFFFFFFu;
+        assert(thread < writers && seq < per_writer);
+        assert(seq >= next[thread]);
+        next[thread] = seq + 1;
+    }
+}
+
+/**
+ * @brief 交替使用push_back和grow_by追加本线程的元素
+ */
+void append(user::ConcurrentVector<std::uint64_t>& v, std::uint64_t thread) {
+    std::uint64_t seq = 0;
+    while (seq < per_writer) {
+        if (seq % (2 * batch) == 0) {
+            const std::size_t i = v.push_back(encode(thread, seq));
+            assert(v[i] == encode(thread, seq));
+            ++seq;
+        } else {
+            std::uint64_t values[batch];
+            const std::uint64_t n =
+                per_writer - seq < batch ? per_writer - seq : batch;
+            for (std::uint64_t k = 0; k < n; ++k) {
+                values[k] = encode(thread, seq + k);
+            }
+            const std::size_t first = v.grow_by(values, values + n);
+            for (std::uint64_t k = 0; k < n; ++k) {
+                assert(v[first + k] == values[k]);
+            }
+            seq += n;
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief 多个线程并发追加，同时另一线程反复获取快照
+ */
+void test_concurrent_append_and_snapshot() {
+    user::ConcurrentVector<std::uint64_t> v;
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        std::size_t last_size = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const auto snapshot = v.snapshot();
+            // 快照中的元素都已发布，大小不会减少
+            assert(snapshot.size() >= last_size);
+            last_size = snapshot.size();
+            check_order(snapshot.begin(), snapshot.size());
+            std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 0; t < writers; ++t) {
+        threads.emplace_back(append, std::ref(v), t);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    assert(v.size() == writers * per_writer);
+    const auto snapshot = v.snapshot();
+    check_order(snapshot.begin(), snapshot.size());
+    // 每个线程的每个序号恰好出现一次
+    std::vector<int> seen(writers * per_writer, 0);
+    for (const std::uint64_t value : snapshot) {
+        ++seen[(value >> 32) * per_writer + (value & 0xFFFFFFFFu)];
+    }
+    for (const int count : seen) {
+        assert(count == 1);
+    }
+}
+
+int main() {
+    test_concurrent_append_and_snapshot();
+    return 0;
+}
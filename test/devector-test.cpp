@@ -0,0 +1,74 @@
+/* UTF-8 */
+/**
+ * @file devector-test.cpp
+ * @brief Devector的回归测试
+ */
+
+#include <cassert>
+#include <container/devector.hpp>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief 前端空位很多时resize扩容，新增元素不能写出新内存
+ */
+void test_resize_after_pop_front() {
+    user::Devector<int> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back(i);
+    }
+    for (int i = 0; i < 999; ++i) {
+        v.pop_front();
+    }
+    v.resize(2000);
+    assert(v.size() == 2000);
+    assert(v.front() == 999);
+    for (std::size_t i = 1; i < v.size(); ++i) {
+        assert(v[i] == 0);
+    }
+    assert(v.front_free_capacity() + v.size() <= v.capacity());
+}
+
+/**
+ * @struct Word
+ * @brief 读入第limit个单词时构造抛出异常的类型
+ */
+struct Word {
+    static inline int built = 0;
+    static inline int limit = 0;
+    std::string text;
+
+    Word(const std::string& text) : text(text) {
+        if (++built == limit) {
+            throw std::runtime_error("word");
+        }
+    }
+};
+
+/**
+ * @brief 输入迭代器构造中途抛出异常时析构已构造的元素(由ASan检查泄漏)
+ */
+void test_input_iterator_constructor_rollback() {
+    std::istringstream in(
+        "a-word-long-enough-to-be-heap-allocated "
+        "another-word-long-enough-to-be-heap-allocated third"
+    );
+    const std::istream_iterator<std::string> first(in), last;
+    Word::limit = 3;
+    bool thrown = false;
+    try {
+        user::Devector<Word> v(first, last);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    test_resize_after_pop_front();
+    test_input_iterator_constructor_rollback();
+    return 0;
+}
@@ -0,0 +1,111 @@
+/* UTF-8 */
+/**
+ * @file flat-hash-map-test.cpp
+ * @brief FlatHashMap的回归测试
+ */
+
+#include <cassert>
+#include <container/flat-hash-map.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/**
+ * @struct Key
+ * @brief 复制次数达到limit时抛出异常的键
+ * @tparam NothrowMove 移动构造是否为noexcept
+ */
+template <bool NothrowMove>
+struct Key {
+    static inline int copies = 0;
+    static inline int limit = -1;  // 为负数时不抛出异常
+
+    int id = 0;
+    std::string payload = std::string(32, 'k');
+
+    explicit Key(int id) : id(id) {}
+    Key(const Key& other) : id(other.id), payload(other.payload) {
+        if (limit >= 0 && ++copies > limit) {
+            throw std::runtime_error("key copy");
+        }
+    }
+    Key(Key&& other) noexcept(NothrowMove)
+        : id(other.id), payload(std::move(other.payload)) {}
+
+    friend bool operator==(const Key& a, const Key& b) noexcept {
+        return a.id == b.id;
+    }
+};
+
+/**
+ * @struct KeyHash
+ * @brief Key的哈希函数
+ */
+struct KeyHash {
+    std::size_t operator()(const Key<true>& k) const noexcept {
+        return static_cast<std::size_t>(k.id);
+    }
+    std::size_t operator()(const Key<false>& k) const noexcept {
+        return static_cast<std::size_t>(k.id);
+    }
+};
+
+/**
+ * @brief 扩容和删除搬移元素时移动键而不是复制键
+ */
+void test_transfer_moves_keys() {
+    using Map = user::FlatHashMap<Key<true>, int, KeyHash>;
+    Map map;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(Key<true>(i), i);
+    }
+    Key<true>::copies = 0;
+    Key<true>::limit = 0;  // 之后任何复制都会抛出异常
+    map.rehash(4 * map.capacity());
+    for (int i = 0; i < 100; i += 2) {
+        assert(map.erase(Key<true>(i)) == 1);
+    }
+    Key<true>::limit = -1;
+    assert(map.size() == 50);
+    for (int i = 0; i < 100; ++i) {
+        assert(map.contains(Key<true>(i)) == (i % 2 == 1));
+    }
+}
+
+/**
+ * @brief 键的复制和移动都可能抛出异常时，扩容中途失败后表保持不变
+ */
+void test_rehash_rollback() {
+    using Map = user::FlatHashMap<Key<false>, std::string, KeyHash>;
+    Map map;
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(Key<false>(i), std::to_string(i));
+    }
+    const std::size_t capacity = map.capacity();
+    Key<false>::copies = 0;
+    Key<false>::limit = 50;
+    bool thrown = false;
+    try {
+        map.rehash(4 * capacity);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    Key<false>::limit = -1;
+    assert(thrown);
+    assert(map.size() == 100 && map.capacity() == capacity);
+    for (int i = 0; i < 100; ++i) {
+        const auto it = map.find(Key<false>(i));
+        assert(it != map.end() && it->second == std::to_string(i));
+    }
+    // 之后的扩容正常进行
+    map.rehash(4 * capacity);
+    assert(map.size() == 100 && map.capacity() == 4 * capacity);
+    assert(map.contains(Key<false>(99)));
+}
+
+int main() {
+    test_transfer_moves_keys();
+    test_rehash_rollback();
+    return 0;
+}
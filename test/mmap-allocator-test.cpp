@@ -0,0 +1,96 @@
+/* UTF-8 */
+/**
+ * @file mmap-allocator-test.cpp
+ * @brief MmapAllocator的大页对齐和reallocate测试
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <my-memory/mmap-allocator.hpp>
+
+namespace {
+
+constexpr std::size_t huge_page = std::size_t{1} << 21;
+
+using HugeAlloc = user::MmapAllocator<int, (std::size_t{1} << 20), true>;
+
+/**
+ * @brief 判断指针是否按大页对齐
+ */
+bool is_aligned(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % huge_page == 0;
+}
+
+}  // namespace
+
+/**
+ * @brief 使用大页时mmap分配的内存按2MB对齐，且可以读写整个区域
+ */
+void test_huge_alignment() {
+    HugeAlloc alloc;
+    // 多次分配，使得部分映射不会恰好落在对齐的地址上
+    int* blocks[8];
+    const std::size_t n = (3 << 20) / sizeof(int) + 5;
+    for (auto& p : blocks) {
+        p = alloc.allocate(n);
+        assert(is_aligned(p));
+        p[0] = 1;
+        p[n - 1] = 2;
+    }
+    for (auto& p : blocks) {
+        assert(p[0] == 1 && p[n - 1] == 2);
+        alloc.deallocate(p, n);
+    }
+}
+
+/**
+ * @brief 使用大页时reallocate扩大和缩小后仍按2MB对齐，并保留内容
+ */
+void test_huge_reallocate() {
+    HugeAlloc alloc;
+    std::size_t n = (1 << 20) / sizeof(int);
+    int* p = alloc.allocate(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        p[i] = static_cast<int>(i);
+    }
+    // 在后面占据一块映射，阻止原地扩大
+    int* blocker = alloc.allocate(n);
+    for (std::size_t new_n : {n * 3, n * 7, n * 2}) {
+        p = alloc.reallocate(p, n, new_n);
+        assert(is_aligned(p));
+        for (std::size_t i = 0; i < (n < new_n ? n : new_n); ++i) {
+            assert(p[i] == static_cast<int>(i));
+        }
+        for (std::size_t i = n; i < new_n; ++i) {
+            p[i] = static_cast<int>(i);
+        }
+        n = new_n;
+    }
+    alloc.deallocate(blocker, (1 << 20) / sizeof(int));
+    alloc.deallocate(p, n);
+}
+
+/**
+ * @brief 不使用大页以及低于阈值时的分配和reallocate
+ */
+void test_regular() {
+    user::MmapAllocator<int> alloc;
+    int* small = alloc.allocate(16);
+    small[15] = 15;
+    // 从user::Allocator分配的内存扩大到mmap分配的内存
+    const std::size_t big = (2 << 20) / sizeof(int);
+    int* p = alloc.reallocate(small, 16, big);
+    assert(p[15] == 15);
+    p[big - 1] = 1;
+    p = alloc.reallocate(p, big, big * 2);
+    assert(p[15] == 15 && p[big - 1] == 1);
+    alloc.deallocate(p, big * 2);
+}
+
+int main() {
+    test_huge_alignment();
+    test_huge_reallocate();
+    test_regular();
+    return 0;
+}
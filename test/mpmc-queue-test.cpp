@@ -0,0 +1,125 @@
+/* UTF-8 */
+/**
+ * @file mpmc-queue-test.cpp
+ * @brief MpmcQueue的多生产者多消费者测试
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <parallel/mpmc-queue.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int producers = 4;
+constexpr int consumers = 4;
+constexpr int per_producer = 50000;
+constexpr int stop = -1;  // 通知消费者结束的值
+
+/**
+ * @brief 生产者交替使用批量入队和阻塞入队，元素为p * per_producer + i
+ */
+void produce(user::MpmcQueue<int>& queue, int p) {
+    const int base = p * per_producer;
+    int i = 0;
+    while (i < per_producer) {
+        if (i % 3 == 0) {
+            queue.push(base + i);
+            ++i;
+            continue;
+        }
+        // 一次最多写入7个，队列满时重试
+        int batch[7];
+        const int n = per_producer - i < 7 ? per_producer - i : 7;
+        for (int k = 0; k < n; ++k) {
+            batch[k] = base + i + k;
+        }
+        const auto pushed = static_cast<int>(queue.try_push_bulk(batch, n));
+        if (pushed == 0) {
+            std::this_thread::yield();
+        }
+        i += pushed;
+    }
+}
+
+/**
+ * @brief 消费者交替使用批量出队和阻塞出队，直到取到结束值
+ * @param seen 收到的各元素的次数
+ */
+void consume(user::MpmcQueue<int>& queue, std::vector<int>& seen) {
+    // 同一生产者的元素必须按入队顺序出队
+    int last[producers];
+    for (int& x : last) {
+        x = -1;
+    }
+    auto take = [&](int value) {
+        const int p = value / per_producer;
+        assert(value % per_producer > last[p]);
+        last[p] = value % per_producer;
+        ++seen[value];
+    };
+    for (int round = 0;; ++round) {
+        int batch[5];
+        const std::size_t n =
+            round % 2 == 0 ? queue.pop_bulk(batch, 5) : (queue.pop(batch[0]), 1);
+        bool stopped = false;
+        for (std::size_t k = 0; k < n; ++k) {
+            if (batch[k] == stop) {
+                // 多取到的结束值留给其他消费者
+                if (stopped) {
+                    queue.push(stop);
+                }
+                stopped = true;
+            } else {
+                take(batch[k]);
+            }
+        }
+        if (stopped) {
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief 多个线程同时批量和阻塞地入队出队，每个元素恰好出队一次
+ */
+void test_many_producers_many_consumers() {
+    // 容量很小，生产者和消费者都会频繁等待
+    user::MpmcQueue<int> queue(16);
+    std::vector<std::vector<int>> seen(
+        consumers, std::vector<int>(producers * per_producer, 0)
+    );
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back(consume, std::ref(queue), std::ref(seen[c]));
+    }
+    std::vector<std::thread> writers;
+    for (int p = 0; p < producers; ++p) {
+        writers.emplace_back(produce, std::ref(queue), p);
+    }
+    for (std::thread& t : writers) {
+        t.join();
+    }
+    for (int c = 0; c < consumers; ++c) {
+        queue.push(stop);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (int v = 0; v < producers * per_producer; ++v) {
+        int total = 0;
+        for (int c = 0; c < consumers; ++c) {
+            total += seen[c][v];
+        }
+        assert(total == 1);
+    }
+    assert(queue.empty());
+}
+
+int main() {
+    test_many_producers_many_consumers();
+    return 0;
+}
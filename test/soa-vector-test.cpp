@@ -0,0 +1,47 @@
+/* UTF-8 */
+/**
+ * @file soa-vector-test.cpp
+ * @brief SoAVector的回归测试
+ */
+
+#include <cassert>
+#include <container/soa-vector.hpp>
+#include <tuple>
+#include <utility>
+
+using Rows = user::SoAVector<int, double>;
+
+/**
+ * @brief 交换后迭代器仍然指向原来的元素
+ */
+void test_iterator_after_swap() {
+    Rows a{{1, 1.5}, {2, 2.5}};
+    Rows b{{7, 7.5}};
+    Rows::iterator it = a.begin();
+    Rows::const_iterator last = a.cend();
+    a.swap(b);
+    assert(std::get<0>(*it) == 1 && std::get<1>(it[1]) == 2.5);
+    assert(last - it == 2);
+    assert(it == b.begin() && last == b.cend());
+}
+
+/**
+ * @brief 移动后迭代器仍然指向原来的元素
+ */
+void test_iterator_after_move() {
+    Rows a{{1, 1.5}, {2, 2.5}, {3, 3.5}};
+    Rows::iterator it = a.begin() + 2;
+    Rows b(std::move(a));
+    assert(std::get<0>(*it) == 3);
+    std::get<0>(*it) = 4;
+    assert(std::get<0>(b.back()) == 4);
+    Rows c;
+    c = std::move(b);
+    assert(std::get<1>(*it) == 3.5);
+}
+
+int main() {
+    test_iterator_after_swap();
+    test_iterator_after_move();
+    return 0;
+}
@@ -0,0 +1,42 @@
+/* UTF-8 */
+/**
+ * @file sorted-index-test.cpp
+ * @brief SortedIndex的回归测试
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <container/sorted-index.hpp>
+#include <cstddef>
+
+/**
+ * @brief Eytzinger布局由结点计算出的下标与std::lower_bound一致，
+ * 覆盖最后一层为满和不满的各种大小
+ */
+void test_eytzinger_rank() {
+    for (std::size_t n = 1; n <= 300; ++n) {
+        user::Vector<int> data(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            data.begin()[i] = static_cast<int>(2 * i);
+        }
+        const user::SortedIndex<int> index(
+            data, user::SearchLayout::Eytzinger
+        );
+        for (int key = -1; key <= static_cast<int>(2 * n); ++key) {
+            const auto lower = static_cast<std::size_t>(
+                std::lower_bound(data.begin(), data.end(), key) - data.begin()
+            );
+            const auto upper = static_cast<std::size_t>(
+                std::upper_bound(data.begin(), data.end(), key) - data.begin()
+            );
+            assert(index.lower_bound(key) == lower);
+            assert(index.upper_bound(key) == upper);
+            assert(index.find(key) == (lower != upper ? lower : n));
+        }
+    }
+}
+
+int main() {
+    test_eytzinger_rank();
+    return 0;
+}
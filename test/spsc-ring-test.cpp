@@ -0,0 +1,116 @@
+/* UTF-8 */
+/**
+ * @file spsc-ring-test.cpp
+ * @brief SpscRing的reserve/commit、回绕以及双线程测试
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <parallel/spsc-ring.hpp>
+#include <span>
+#include <string>
+#include <thread>
+
+/**
+ * @brief reserve()/peek()在缓冲区末尾只返回末尾之前的部分，
+ * 提交后再次调用得到开头的部分
+ */
+void test_reserve_commit_wraparound() {
+    user::SpscRing<std::string> ring(8);
+    assert(ring.capacity() == 8);
+    int next_write = 0;
+    int next_read = 0;
+    // 每轮写5个读5个，下标不断越过缓冲区末尾
+    for (int round = 0; round < 100; ++round) {
+        const std::size_t offset = static_cast<std::size_t>(next_write) % 8;
+        std::span<std::string> slots = ring.reserve(5);
+        assert(slots.size() == std::min<std::size_t>(5, 8 - offset));
+        int written = 0;
+        while (written < 5) {
+            if (slots.empty()) {
+                slots = ring.reserve(5 - written);
+                // 回绕后从缓冲区开头开始
+                assert(!slots.empty());
+            }
+            // 只提交一部分，剩余的槽位之后再次获取
+            std::construct_at(slots.data(), std::to_string(next_write++));
+            ring.commit(1);
+            ++written;
+            slots = slots.subspan(1);
+        }
+        assert(ring.size() == 5);
+        // 缓冲区已有5个元素，只剩3个空位
+        assert(ring.reserve(8).size() <= 3);
+
+        std::span<std::string> ready = ring.peek(5);
+        assert(ready.size() == std::min<std::size_t>(5, 8 - offset));
+        assert(ready.front() == std::to_string(next_read));
+        next_read += static_cast<int>(ready.size());
+        ring.consume(ready.size());
+        if (next_read != next_write) {
+            ready = ring.peek(5);
+            assert(ready.front() == std::to_string(next_read));
+            next_read += static_cast<int>(ready.size());
+            ring.consume(ready.size());
+        }
+        assert(next_read == next_write && ring.empty());
+        assert(ring.peek(1).empty());
+    }
+}
+
+/**
+ * @brief 生产者用reserve()/commit()、消费者用peek()/consume()在两个线程
+ * 中传递元素，再用阻塞的push()/pop()传递一遍
+ */
+void test_two_threads() {
+    constexpr int count = 200000;
+    user::SpscRing<int, user::Allocator<int>, true> ring(64);
+    std::thread producer([&] {
+        int next = 0;
+        while (next < count) {
+            const std::span<int> slots =
+                ring.reserve(static_cast<std::size_t>(next % 13 + 1));
+            if (slots.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::size_t k = 0;
+            for (; k < slots.size() && next < count; ++k) {
+                std::construct_at(slots.data() + k, next++);
+            }
+            ring.commit(k);
+        }
+        for (int i = 0; i < count; ++i) {
+            ring.push(i);
+        }
+    });
+    int expected = 0;
+    while (expected < count) {
+        const std::span<int> ready =
+            ring.peek(static_cast<std::size_t>(expected % 7 + 1));
+        if (ready.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (const int value : ready) {
+            assert(value == expected);
+            ++expected;
+        }
+        ring.consume(ready.size());
+    }
+    for (int i = 0; i < count; ++i) {
+        int value = -1;
+        ring.pop(value);
+        assert(value == i);
+    }
+    producer.join();
+    assert(ring.empty());
+}
+
+int main() {
+    test_reserve_commit_wraparound();
+    test_two_threads();
+    return 0;
+}
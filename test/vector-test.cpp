@@ -0,0 +1,114 @@
+/* UTF-8 */
+/**
+ * @file vector-test.cpp
+ * @brief Vector的回归测试
+ */
+
+#include <cassert>
+#include <container/vector.hpp>
+#include <cstddef>
+#include <memory>
+#include <my-memory/stack-allocator.hpp>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// 有状态分配器需要保存在Vector中，占用额外的空间
+using StatefulVector = user::Vector<int, user::StackAllocator<int, 256>>;
+static_assert(sizeof(StatefulVector) == 4 * sizeof(void*));
+
+/**
+ * @brief 有状态分配器的状态在构造和复制时保留
+ */
+void test_stateful_allocator() {
+    user::InplaceBuffer<256> buffer;
+    const user::StackAllocator<int, 256> alloc(buffer);
+    StatefulVector v(8, 1, alloc);
+    assert(buffer.used() == 8 * sizeof(int));
+    StatefulVector w(v);
+    assert(buffer.used() == 16 * sizeof(int));
+    assert(w.size() == 8 && w.back() == 1);
+}
+
+/**
+ * @class TaggedAllocator
+ * @brief 以编号区分的有状态分配器，移动赋值时不传播，记录每个编号的
+ * 未释放字节数
+ */
+template <typename T>
+class TaggedAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+    using is_always_equal = std::false_type;
+
+    static inline std::ptrdiff_t live[4] = {};
+
+    TaggedAllocator() = default;
+    explicit TaggedAllocator(int tag) noexcept : tag(tag) {}
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U>& other) noexcept
+        : tag(other.tag) {}
+
+    T* allocate(std::size_t n) {
+        TaggedAllocator<std::byte>::live[tag] += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        TaggedAllocator<std::byte>::live[tag] -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(
+        const TaggedAllocator& a, const TaggedAllocator& b
+    ) noexcept {
+        return a.tag == b.tag;
+    }
+
+    int tag = 0;
+};
+
+using TaggedVector = user::Vector<std::string, TaggedAllocator<std::string>>;
+static_assert(std::is_nothrow_move_constructible_v<TaggedVector>);
+static_assert(!std::is_nothrow_move_assignable_v<TaggedVector>);
+
+/**
+ * @brief 移动构造时分配器随内存移动，直接接管内存
+ */
+void test_move_construct_steals() {
+    TaggedVector v(3, "abc", TaggedAllocator<std::string>(1));
+    const std::string* data = v.begin();
+    TaggedVector w(std::move(v));
+    assert(w.begin() == data && w.size() == 3);
+    assert(w.get_allocator().tag == 1 && v.empty());
+}
+
+/**
+ * @brief 分配器不同且不传播时，移动赋值逐个移动元素，
+ * 内存始终由分配它的分配器释放
+ */
+void test_move_assign_unequal_allocators() {
+    auto& live = TaggedAllocator<std::byte>::live;
+    {
+        TaggedVector v(4, "left", TaggedAllocator<std::string>(1));
+        TaggedVector w(2, "right", TaggedAllocator<std::string>(2));
+        const std::string* data = w.begin();
+        w = std::move(v);
+        assert(w.get_allocator().tag == 2 && w.size() == 4);
+        assert(w.back() == "left" && v.empty());
+        assert(w.begin() != data);
+        // 分配器相同时直接交换内存
+        TaggedVector u(1, "same", TaggedAllocator<std::string>(2));
+        data = u.begin();
+        w = std::move(u);
+        assert(w.begin() == data && w.back() == "same");
+    }
+    assert(live[1] == 0 && live[2] == 0);
+}
+
+int main() {
+    test_stateful_allocator();
+    test_move_construct_steals();
+    test_move_assign_unequal_allocators();
+    return 0;
+}